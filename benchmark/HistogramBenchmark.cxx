@@ -0,0 +1,79 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Histogram.h"
+#include <benchmark/benchmark.h>
+
+namespace influxdb::benchmark
+{
+    namespace
+    {
+        Histogram sharedHistogram;
+    }
+
+    void recordValue(::benchmark::State& state)
+    {
+        Histogram histogram;
+        double value{0.125};
+
+        for (auto _ : state)
+        {
+            histogram.record(value);
+            value = value < 1e6 ? value * 1.01 : 0.125;
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void recordValueContended(::benchmark::State& state)
+    {
+        double value{0.125 * (state.thread_index() + 1)};
+
+        for (auto _ : state)
+        {
+            sharedHistogram.record(value);
+            value = value < 1e6 ? value * 1.01 : 0.125;
+        }
+        state.SetItemsProcessed(state.iterations());
+    }
+
+    void collectToPoint(::benchmark::State& state)
+    {
+        Histogram histogram;
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            for (int i = 1; i <= 1000; ++i)
+            {
+                histogram.record(static_cast<double>(i));
+            }
+            state.ResumeTiming();
+
+            auto point = histogram.collect().addFields(Point{"latency"}, {50.0, 90.0, 99.0}, {10.0, 100.0, 1000.0});
+            ::benchmark::DoNotOptimize(point);
+        }
+    }
+
+    BENCHMARK(recordValue);
+    BENCHMARK(recordValueContended)->ThreadRange(1, 8);
+    BENCHMARK(collectToPoint);
+}
@@ -0,0 +1,94 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "InfluxDBFactory.h"
+#include "MockHttpServer.h"
+#include <chrono>
+#include <string>
+#include <benchmark/benchmark.h>
+
+namespace influxdb::benchmark
+{
+    using test::MockHttpServer;
+
+    namespace
+    {
+        Point makePoint(std::int64_t i)
+        {
+            return Point{"cpu"}
+                .addTag("host", "server" + std::to_string(i % 100))
+                .addField("usage_user", 58.1317132304976)
+                .addField("processes", 61)
+                .setTimestamp(std::chrono::system_clock::time_point{std::chrono::seconds{i}});
+        }
+
+        void setCounters(::benchmark::State& state, const MockHttpServer& server)
+        {
+            const auto statistics = server.statistics();
+            state.SetBytesProcessed(static_cast<std::int64_t>(statistics.bytes));
+            state.counters["points"] = ::benchmark::Counter{static_cast<double>(statistics.lines), ::benchmark::Counter::kIsRate};
+            state.counters["requests"] = ::benchmark::Counter{static_cast<double>(statistics.writes), ::benchmark::Counter::kIsRate};
+        }
+    }
+
+    /// Writes through transports::HTTP to a local server, batch size as argument
+    void httpWrite(::benchmark::State& state)
+    {
+        MockHttpServer server;
+        server.setRecordRequests(false);
+        const auto db = InfluxDBFactory::Get(server.url() + "?db=test");
+        const auto batchSize = state.range(0);
+        db->batchOf(static_cast<std::size_t>(batchSize));
+        std::int64_t i{0};
+
+        for (auto _ : state)
+        {
+            for (std::int64_t n = 0; n < batchSize; ++n)
+            {
+                db->write(makePoint(i++));
+            }
+            db->flushBatch();
+        }
+        setCounters(state, server);
+    }
+
+    /// Writes single points to a server answering with latency in ms as argument
+    void httpWriteLatency(::benchmark::State& state)
+    {
+        MockHttpServer server;
+        server.setRecordRequests(false);
+        MockHttpServer::Faults faults;
+        faults.latency = std::chrono::milliseconds{state.range(0)};
+        server.setFaults(faults);
+        const auto db = InfluxDBFactory::Get(server.url() + "?db=test");
+        std::int64_t i{0};
+
+        for (auto _ : state)
+        {
+            db->write(makePoint(i++));
+        }
+        setCounters(state, server);
+    }
+
+    BENCHMARK(httpWrite)->RangeMultiplier(10)->Range(1, 10000)->UseRealTime();
+    BENCHMARK(httpWriteLatency)->Arg(1)->Arg(10)->UseRealTime();
+}
@@ -0,0 +1,192 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "InfluxDB.h"
+#include "ShardedInfluxDB.h"
+#include "Transport.h"
+#include "AllocationCounter.h"
+#include "PerfCounters.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <benchmark/benchmark.h>
+
+namespace influxdb::benchmark
+{
+    namespace
+    {
+        constexpr std::chrono::time_point<std::chrono::system_clock> timestamp{std::chrono::milliseconds{1572830915}};
+
+        /// Discards all messages, so only the client is measured
+        class NullTransport : public Transport
+        {
+        public:
+            explicit NullTransport(std::size_t& bytes)
+                : mBytes(bytes)
+            {
+            }
+
+            void send(std::string&& message) override
+            {
+                mBytes += message.size();
+                ::benchmark::DoNotOptimize(message.data());
+            }
+
+        private:
+            std::size_t& mBytes;
+        };
+
+        /// Takes a fixed time per message, like a round trip to a server
+        class RoundTripTransport : public Transport
+        {
+        public:
+            explicit RoundTripTransport(std::atomic<std::size_t>& bytes)
+                : mBytes(bytes)
+            {
+            }
+
+            void send(std::string&& message) override
+            {
+                mBytes += message.size();
+                std::this_thread::sleep_for(std::chrono::microseconds{500});
+            }
+
+        private:
+            std::atomic<std::size_t>& mBytes;
+        };
+
+        Point makePoint(std::int64_t i)
+        {
+            return Point{"cpu"}
+                .addTag("host", "server" + std::to_string(i % 100))
+                .addTag("region", "eu-central-1")
+                .addField("usage_user", 58.1317132304976)
+                .addField("usage_idle", 24.8045287008679)
+                .addField("processes", 61)
+                .setTimestamp(timestamp + std::chrono::seconds{i});
+        }
+
+        void setCounters(::benchmark::State& state, std::int64_t points, std::size_t bytes, std::size_t allocations)
+        {
+            const auto total = static_cast<double>(state.iterations() * points);
+            state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+            state.counters["points"] = ::benchmark::Counter{total, ::benchmark::Counter::kIsRate};
+            state.counters["allocs/point"] = static_cast<double>(allocations) / total;
+        }
+    }
+
+    void writeUnbatched(::benchmark::State& state)
+    {
+        std::size_t bytes{0};
+        InfluxDB db{std::make_unique<NullTransport>(bytes)};
+        std::int64_t i{0};
+        const test::AllocationCounter allocations;
+
+        for (auto _ : state)
+        {
+            db.write(makePoint(i++));
+        }
+
+        setCounters(state, 1, bytes, allocations.allocations());
+    }
+
+    void writeBatched(::benchmark::State& state)
+    {
+        const auto batchSize = state.range(0);
+        std::size_t bytes{0};
+        InfluxDB db{std::make_unique<NullTransport>(bytes)};
+        db.batchOf(static_cast<std::size_t>(batchSize));
+        db.setBatchCoalescing(state.range(1) != 0);
+        const test::AllocationCounter allocations;
+
+        for (auto _ : state)
+        {
+            for (std::int64_t i = 0; i < batchSize; ++i)
+            {
+                db.write(makePoint(i));
+            }
+        }
+
+        setCounters(state, batchSize, bytes, allocations.allocations());
+    }
+
+    void flushBatch(::benchmark::State& state)
+    {
+        const auto batchSize = state.range(0);
+        std::size_t bytes{0};
+        InfluxDB db{std::make_unique<NullTransport>(bytes)};
+        db.batchOf(static_cast<std::size_t>(batchSize) + 1);
+        PerfCounters counters;
+
+        for (auto _ : state)
+        {
+            state.PauseTiming();
+            for (std::int64_t i = 0; i < batchSize; ++i)
+            {
+                db.write(makePoint(i));
+            }
+            state.ResumeTiming();
+
+            counters.start();
+            db.flushBatch();
+            counters.stop();
+        }
+
+        counters.report(state, static_cast<double>(state.iterations() * batchSize), static_cast<double>(bytes));
+        state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+        state.counters["points"] = ::benchmark::Counter{static_cast<double>(state.iterations() * batchSize), ::benchmark::Counter::kIsRate};
+    }
+
+    /// Writes through shards with a round trip time each, shard count as argument
+    void writeSharded(::benchmark::State& state)
+    {
+        constexpr std::int64_t points{20000};
+        std::atomic<std::size_t> bytes{0};
+        std::vector<std::unique_ptr<Transport>> transports;
+
+        for (std::int64_t i = 0; i < state.range(0); ++i)
+        {
+            transports.push_back(std::make_unique<RoundTripTransport>(bytes));
+        }
+
+        ShardedInfluxDB db{std::move(transports), 500};
+        std::int64_t i{0};
+
+        for (auto _ : state)
+        {
+            for (std::int64_t n = 0; n < points; ++n)
+            {
+                db.write(makePoint(i++));
+            }
+            db.flushBatch();
+        }
+
+        state.SetBytesProcessed(static_cast<std::int64_t>(bytes.load()));
+        state.counters["points"] = ::benchmark::Counter{static_cast<double>(state.iterations() * points), ::benchmark::Counter::kIsRate};
+    }
+
+    BENCHMARK(writeUnbatched);
+    BENCHMARK(writeBatched)->ArgNames({"batch", "coalesce"})->Args({1, 0})->Args({100, 0})->Args({10000, 0})->Args({100000, 0})->Args({10000, 1});
+    BENCHMARK(flushBatch)->ArgName("points")->RangeMultiplier(10)->Range(1, 100000);
+    BENCHMARK(writeSharded)->ArgName("shards")->RangeMultiplier(2)->Range(1, 8)->UseRealTime();
+}
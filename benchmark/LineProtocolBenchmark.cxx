@@ -0,0 +1,83 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LineProtocol.h"
+#include "Point.h"
+#include "PerfCounters.h"
+#include <string>
+#include <benchmark/benchmark.h>
+
+namespace influxdb::benchmark
+{
+    namespace
+    {
+        constexpr std::chrono::time_point<std::chrono::system_clock> timestamp{std::chrono::milliseconds{1572830915}};
+
+        Point makePoint(std::int64_t tags, std::int64_t fields, const std::string& value)
+        {
+            Point point{"cpu"};
+            for (std::int64_t i = 0; i < tags; ++i)
+            {
+                point.addTag("tag" + std::to_string(i), value);
+            }
+            for (std::int64_t i = 0; i < fields; ++i)
+            {
+                point.addField("field" + std::to_string(i), 1.5);
+            }
+            return point.setTimestamp(timestamp);
+        }
+
+        void format(::benchmark::State& state, const std::string& tagValue)
+        {
+            const auto point = makePoint(state.range(0), state.range(1), tagValue);
+            const LineProtocol lineProtocol{"host=localhost"};
+            std::size_t bytes{0};
+            PerfCounters counters;
+            counters.start();
+
+            for (auto _ : state)
+            {
+                const auto line = lineProtocol.format(point);
+                bytes += line.size();
+                ::benchmark::DoNotOptimize(line.data());
+            }
+
+            counters.stop();
+            counters.report(state, static_cast<double>(state.iterations()), static_cast<double>(bytes));
+            state.SetBytesProcessed(static_cast<std::int64_t>(bytes));
+            state.counters["lines"] = ::benchmark::Counter{static_cast<double>(state.iterations()), ::benchmark::Counter::kIsRate};
+        }
+    }
+
+    void formatPlain(::benchmark::State& state)
+    {
+        format(state, "eu-central-1a");
+    }
+
+    void formatEscaped(::benchmark::State& state)
+    {
+        format(state, "eu central,1=a");
+    }
+
+    BENCHMARK(formatPlain)->ArgNames({"tags", "fields"})->Args({0, 1})->Args({1, 1})->Args({4, 4})->Args({8, 8})->Args({16, 16});
+    BENCHMARK(formatEscaped)->ArgNames({"tags", "fields"})->Args({4, 4});
+}
@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LineProtocolParser.h"
+#include <string>
+#include <benchmark/benchmark.h>
+
+namespace influxdb::benchmark
+{
+    namespace
+    {
+        std::string makeInput(std::int64_t lines)
+        {
+            std::string input;
+            for (std::int64_t i = 0; i < lines; ++i)
+            {
+                input += "cpu,hostname=host_" + std::to_string(i % 100) + ",region=eu-central-1,datacenter=eu-central-1a,rack=" + std::to_string(i % 10)
+                         + " usage_user=58.1317132304976,usage_system=2.6418417145963,usage_idle=24.8045287008679,usage_nice=61i,message=\"ok, running\" "
+                         + std::to_string(1451606400000000000 + i) + "\n";
+            }
+            return input;
+        }
+
+        void setCounters(::benchmark::State& state, const std::string& input, std::int64_t lines)
+        {
+            state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(input.size()));
+            state.counters["lines"] = ::benchmark::Counter{static_cast<double>(state.iterations() * lines), ::benchmark::Counter::kIsRate};
+        }
+    }
+
+    void parseLines(::benchmark::State& state)
+    {
+        const auto input = makeInput(state.range(0));
+
+        for (auto _ : state)
+        {
+            LineProtocolParser parser{input};
+            while (const auto view = parser.next())
+            {
+                ::benchmark::DoNotOptimize(view->fields().data());
+            }
+        }
+
+        setCounters(state, input, state.range(0));
+    }
+
+    void parseAndIterateFields(::benchmark::State& state)
+    {
+        const auto input = makeInput(state.range(0));
+
+        for (auto _ : state)
+        {
+            LineProtocolParser parser{input};
+            while (const auto view = parser.next())
+            {
+                view->forEachField([](std::string_view key, std::string_view value)
+                                   {
+                                       ::benchmark::DoNotOptimize(key.data());
+                                       ::benchmark::DoNotOptimize(value.data()); });
+            }
+        }
+
+        setCounters(state, input, state.range(0));
+    }
+
+    void parseToPoints(::benchmark::State& state)
+    {
+        const auto input = makeInput(state.range(0));
+
+        for (auto _ : state)
+        {
+            LineProtocolParser parser{input};
+            while (const auto view = parser.next())
+            {
+                auto point = view->toPoint();
+                ::benchmark::DoNotOptimize(point);
+            }
+        }
+
+        setCounters(state, input, state.range(0));
+    }
+
+    BENCHMARK(parseLines)->ArgName("lines")->Arg(1000);
+    BENCHMARK(parseAndIterateFields)->ArgName("lines")->Arg(1000);
+    BENCHMARK(parseToPoints)->ArgName("lines")->Arg(1000);
+}
@@ -0,0 +1,168 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "PerfCounters.h"
+#include <cstdlib>
+#include <string>
+#include <utility>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace influxdb::benchmark
+{
+    namespace
+    {
+#ifdef __linux__
+        constexpr std::array<const char*, 5> eventNames{"cycles", "instructions", "branch-misses", "L1-misses", "LLC-misses"};
+
+        constexpr std::uint64_t cacheReadMisses(std::uint64_t cache)
+        {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        }
+
+        constexpr std::array<std::pair<std::uint32_t, std::uint64_t>, 5> events{{{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                                                                                  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                                                                                  {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+                                                                                  {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_L1D)},
+                                                                                  {PERF_TYPE_HW_CACHE, cacheReadMisses(PERF_COUNT_HW_CACHE_LL)}}};
+
+        int open(std::uint32_t type, std::uint64_t config)
+        {
+            perf_event_attr attributes{};
+            attributes.size = sizeof(attributes);
+            attributes.type = type;
+            attributes.config = config;
+            attributes.disabled = 1;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            return static_cast<int>(::syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+        }
+
+        /// Count, scaled up if the event was multiplexed with others
+        double read(int descriptor)
+        {
+            std::array<std::uint64_t, 3> values{};
+
+            if (::read(descriptor, values.data(), sizeof(values)) != sizeof(values) || values[2] == 0)
+            {
+                return 0.0;
+            }
+            return static_cast<double>(values[0]) * static_cast<double>(values[1]) / static_cast<double>(values[2]);
+        }
+#endif
+    }
+
+
+    PerfCounters::PerfCounters()
+        : mDescriptors()
+    {
+        mDescriptors.fill(-1);
+
+#ifdef __linux__
+        if (std::getenv("INFLUXCXX_PERF_COUNTERS") == nullptr)
+        {
+            return;
+        }
+
+        for (std::size_t i = 0; i < eventCount; ++i)
+        {
+            mDescriptors[i] = open(events[i].first, events[i].second);
+        }
+#endif
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+#ifdef __linux__
+        for (const int descriptor : mDescriptors)
+        {
+            if (descriptor >= 0)
+            {
+                ::close(descriptor);
+            }
+        }
+#endif
+    }
+
+    void PerfCounters::start()
+    {
+#ifdef __linux__
+        for (const int descriptor : mDescriptors)
+        {
+            if (descriptor >= 0)
+            {
+                ::ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void PerfCounters::stop()
+    {
+#ifdef __linux__
+        for (const int descriptor : mDescriptors)
+        {
+            if (descriptor >= 0)
+            {
+                ::ioctl(descriptor, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+#endif
+    }
+
+    void PerfCounters::report([[maybe_unused]] ::benchmark::State& state, [[maybe_unused]] double points, [[maybe_unused]] double bytes) const
+    {
+#ifdef __linux__
+        std::array<double, eventCount> counts{};
+
+        for (std::size_t i = 0; i < eventCount; ++i)
+        {
+            if (mDescriptors[i] < 0 || (counts[i] = read(mDescriptors[i])) == 0.0)
+            {
+                continue;
+            }
+
+            const std::string name{eventNames[i]};
+
+            if (points > 0.0)
+            {
+                state.counters[name + "/point"] = counts[i] / points;
+            }
+            if (bytes > 0.0)
+            {
+                state.counters[name + "/byte"] = counts[i] / bytes;
+            }
+        }
+
+        if (counts[0] > 0.0 && counts[1] > 0.0)
+        {
+            state.counters["IPC"] = counts[1] / counts[0];
+        }
+#endif
+    }
+}
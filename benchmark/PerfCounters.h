@@ -0,0 +1,60 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <benchmark/benchmark.h>
+
+namespace influxdb::benchmark
+{
+    /// \brief Hardware performance counters of the calling thread
+    ///
+    /// Counts cycles, instructions, branch misses and L1 data / last level cache
+    /// misses with perf_event_open if the environment variable INFLUXCXX_PERF_COUNTERS
+    /// is set. Only available on Linux; counters the PMU or perf_event_paranoid don't
+    /// permit are left out.
+    class PerfCounters
+    {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        /// Starts or resumes counting, e.g. along with State::ResumeTiming()
+        void start();
+
+        /// Pauses counting
+        void stop();
+
+        /// Adds each counter per point and per byte, and instructions per cycle, to state
+        void report(::benchmark::State& state, double points, double bytes) const;
+
+    private:
+        static constexpr std::size_t eventCount{5};
+
+        std::array<int, eventCount> mDescriptors;
+    };
+}
@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Point.h"
+#include "LineProtocol.h"
+#include "AllocationCounter.h"
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+namespace influxdb::benchmark
+{
+    namespace
+    {
+        constexpr std::chrono::time_point<std::chrono::system_clock> timestamp{std::chrono::milliseconds{1572830915}};
+
+        std::vector<std::string> makeNames(const std::string& prefix, std::int64_t count)
+        {
+            std::vector<std::string> names;
+            for (std::int64_t i = 0; i < count; ++i)
+            {
+                names.push_back(prefix + std::to_string(i));
+            }
+            return names;
+        }
+
+        Point makePoint(const std::vector<std::string>& tags, const std::vector<std::string>& fields, std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        {
+            Point point{"cpu", resource};
+            for (const auto& tag : tags)
+            {
+                point.addTag(tag, "value");
+            }
+            for (const auto& field : fields)
+            {
+                point.addField(field, 1.5);
+            }
+            return point.setTimestamp(timestamp);
+        }
+
+        void setCounters(::benchmark::State& state, std::size_t allocations)
+        {
+            const auto iterations = static_cast<double>(state.iterations());
+            state.counters["sizeof(Point)"] = sizeof(Point);
+            state.counters["allocs/point"] = static_cast<double>(allocations) / iterations;
+            state.counters["points"] = ::benchmark::Counter{iterations, ::benchmark::Counter::kIsRate};
+        }
+    }
+
+    void pointConstruction(::benchmark::State& state)
+    {
+        const auto tags = makeNames("tag", state.range(0));
+        const auto fields = makeNames("field", state.range(1));
+        const test::AllocationCounter allocations;
+
+        for (auto _ : state)
+        {
+            auto point = makePoint(tags, fields);
+            ::benchmark::DoNotOptimize(point);
+        }
+
+        setCounters(state, allocations.allocations());
+    }
+
+    void pointConstructionInArena(::benchmark::State& state)
+    {
+        const auto tags = makeNames("tag", state.range(0));
+        const auto fields = makeNames("field", state.range(1));
+        std::pmr::monotonic_buffer_resource arena;
+        std::size_t pointsInArena{0};
+        const test::AllocationCounter allocations;
+
+        for (auto _ : state)
+        {
+            {
+                auto point = makePoint(tags, fields, &arena);
+                ::benchmark::DoNotOptimize(point);
+            }
+
+            if (++pointsInArena == 1000)
+            {
+                arena.release();
+                pointsInArena = 0;
+            }
+        }
+
+        setCounters(state, allocations.allocations());
+    }
+
+    void pointConstructionAndFormat(::benchmark::State& state)
+    {
+        const auto tags = makeNames("tag", state.range(0));
+        const auto fields = makeNames("field", state.range(1));
+        const LineProtocol lineProtocol;
+        const test::AllocationCounter allocations;
+
+        for (auto _ : state)
+        {
+            const auto line = lineProtocol.format(makePoint(tags, fields));
+            ::benchmark::DoNotOptimize(line.data());
+        }
+
+        setCounters(state, allocations.allocations());
+    }
+
+    BENCHMARK(pointConstruction)->ArgNames({"tags", "fields"})->Args({0, 1})->Args({1, 1})->Args({4, 4})->Args({8, 8});
+    BENCHMARK(pointConstructionInArena)->ArgNames({"tags", "fields"})->Args({1, 1})->Args({8, 8});
+    BENCHMARK(pointConstructionAndFormat)->ArgNames({"tags", "fields"})->Args({0, 1})->Args({1, 1})->Args({4, 4})->Args({8, 8});
+}
@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BoostSupport.h"
+#include "Transport.h"
+#include <string>
+#include <benchmark/benchmark.h>
+
+namespace influxdb::benchmark
+{
+    namespace
+    {
+        /// Returns a canned query response
+        class CannedTransport : public Transport
+        {
+        public:
+            explicit CannedTransport(std::string response)
+                : mResponse(std::move(response))
+            {
+            }
+
+            void send([[maybe_unused]] std::string&& message) override
+            {
+            }
+
+            std::string query([[maybe_unused]] const std::string& query) override
+            {
+                return mResponse;
+            }
+
+        private:
+            std::string mResponse;
+        };
+
+        /// Query response of at least bytes with one row per value
+        std::string makeResponse(std::int64_t bytes, std::int64_t& rows)
+        {
+            std::string response{R"({"results":[{"statement_id":0,"series":[{"name":"cpu","tags":{"host":"server01"},"columns":["time","usage_user","usage_idle"],"values":[)"};
+            rows = 0;
+
+            while (static_cast<std::int64_t>(response.size()) < bytes)
+            {
+                if (rows > 0)
+                {
+                    response += ',';
+                }
+                response += R"(["2023-01-01T00:00:)" + std::to_string(10 + rows % 50) + R"(.123456789Z",58.1317132304976,)" + std::to_string(rows) + "]";
+                ++rows;
+            }
+            return response + "]}]}]}";
+        }
+    }
+
+    void queryResponse(::benchmark::State& state)
+    {
+        std::int64_t rows{0};
+        CannedTransport transport{makeResponse(state.range(0), rows)};
+
+        for (auto _ : state)
+        {
+            auto points = internal::queryImpl(&transport, "SELECT * FROM cpu");
+            ::benchmark::DoNotOptimize(points.data());
+        }
+
+        state.SetBytesProcessed(state.iterations() * state.range(0));
+        state.counters["points"] = ::benchmark::Counter{static_cast<double>(state.iterations() * rows), ::benchmark::Counter::kIsRate};
+    }
+
+    BENCHMARK(queryResponse)->ArgName("bytes")->RangeMultiplier(32)->Range(1 << 10, 100 << 20)->Unit(::benchmark::kMillisecond);
+}
@@ -0,0 +1,149 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_AGGREGATOR_H
+#define INFLUXDATA_AGGREGATOR_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "InfluxDB.h"
+#include "Point.h"
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+
+    /// \brief Aggregates points per series over tumbling windows before writing them
+    ///
+    /// Points with the same measurement and tag set are combined into one point per
+    /// window, timestamped with the start of the window. Numeric fields are written as
+    /// <field>_count, _sum, _min, _max, _last, _mean and _stddev as selected; string and
+    /// boolean fields keep their last value. Windows are aligned to the epoch, a window is
+    /// written once a later sample of the series arrives or the window ended (checked on
+    /// write() and by flush()). Not thread-safe, like InfluxDB.
+    class INFLUXDB_EXPORT Aggregator
+    {
+    public:
+        /// Aggregates written per numeric field
+        struct Aggregates
+        {
+            bool count{true};
+            bool sum{true};
+            bool min{true};
+            bool max{true};
+            bool last{true};
+            bool mean{false};
+            bool stddev{false};
+        };
+
+        struct Statistics
+        {
+            /// Points added
+            std::uint64_t samples;
+
+            /// Aggregated points written
+            std::uint64_t points;
+
+            /// Points of windows already written, passed through unaggregated
+            std::uint64_t late;
+        };
+
+        /// Constructs an aggregator writing count, sum, min, max and last to db, which has to outlive it
+        Aggregator(InfluxDB& db, std::chrono::milliseconds window);
+
+        /// Constructs an aggregator writing the selected aggregates to db, which has to outlive it
+        Aggregator(InfluxDB& db, std::chrono::milliseconds window, Aggregates aggregates);
+
+        /// Disable copy constructor
+        Aggregator(const Aggregator&) = delete;
+
+        /// Disable copy constructor
+        Aggregator& operator=(const Aggregator&) = delete;
+
+        /// Adds point to the window of its timestamp
+        void write(const Point& point);
+
+        /// Writes all windows that ended
+        void flush();
+
+        /// Writes all windows including the current ones, e.g. before shutdown
+        void flushAll();
+
+        /// Number of series with an open window
+        std::size_t seriesCount() const;
+
+        /// Returns the counters
+        Statistics statistics() const;
+
+    private:
+        using TimePoint = std::chrono::time_point<std::chrono::system_clock>;
+
+        struct FieldAggregate
+        {
+            std::string name;
+            std::uint64_t count;
+            double sum;
+            double min;
+            double max;
+            double mean;
+            double m2;
+            Point::FieldValue last;
+        };
+
+        struct Series
+        {
+            std::string measurement;
+            std::vector<std::pair<std::string, std::string>> tags;
+            TimePoint windowStart;
+            std::vector<FieldAggregate> fields;
+        };
+
+        TimePoint windowStartOf(TimePoint timestamp) const;
+        void add(Series& series, const Point& point);
+        void emit(const Series& series);
+        void flushUntil(TimePoint now);
+
+        InfluxDB& mDb;
+        const std::chrono::system_clock::duration mWindow;
+        const Aggregates mAggregates;
+        std::unordered_map<std::string, Series> mSeries;
+        TimePoint mNextFlush;
+
+        /// Windows before were written, later samples of them are late
+        TimePoint mFlushedUntil;
+        Statistics mStatistics;
+
+        /// Reused between writes to build series keys without allocating
+        std::string mKey;
+        std::vector<std::pair<std::string_view, std::string_view>> mSortedTags;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_AGGREGATOR_H
@@ -0,0 +1,93 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_ASYNCINFLUXDB_H
+#define INFLUXDATA_ASYNCINFLUXDB_H
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AsyncTransport.h"
+#include "Point.h"
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+
+    /// \brief Coroutine counterpart of InfluxDB, for clients running on an asio executor
+    ///
+    /// Writes, flushes and queries suspend the calling coroutine instead of blocking its
+    /// thread, so many operations can be in flight at once. Writes continue into a new
+    /// batch while a full one is sent. Not thread-safe: use an instance from one thread
+    /// or strand. Batched points are discarded on destruction, flushBatchAsync() first.
+    class INFLUXDB_EXPORT AsyncInfluxDB
+    {
+    public:
+        /// Disable copy constructor
+        AsyncInfluxDB& operator=(const AsyncInfluxDB&) = delete;
+
+        /// Disable copy constructor
+        AsyncInfluxDB(const AsyncInfluxDB&) = delete;
+
+        /// Constructor required valid transport
+        explicit AsyncInfluxDB(std::unique_ptr<AsyncTransport> transport);
+
+        /// Writes a point, sending the batch once it is full
+        boost::asio::awaitable<void> writeAsync(Point point);
+
+        /// Writes a vector of points
+        boost::asio::awaitable<void> writeAsync(std::vector<Point> points);
+
+        /// Sends the points batched
+        boost::asio::awaitable<void> flushBatchAsync();
+
+        /// Queries InfluxDB database
+        boost::asio::awaitable<std::vector<Point>> queryAsync(std::string query);
+
+        /// Enables points batching
+        /// \param size
+        void batchOf(std::size_t size = 32);
+
+        /// Returns current batch size
+        std::size_t batchSize() const;
+
+        /// Adds a global tag
+        /// \param name
+        /// \param value
+        void addGlobalTag(std::string_view name, std::string_view value);
+
+    private:
+        boost::asio::awaitable<void> transmit(std::vector<Point> points);
+
+        std::unique_ptr<AsyncTransport> mTransport;
+        std::vector<Point> mBatch;
+        bool mIsBatchingActivated;
+        std::size_t mBatchSize;
+        std::string mGlobalTags;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_ASYNCINFLUXDB_H
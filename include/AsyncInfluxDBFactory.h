@@ -0,0 +1,65 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_ASYNCINFLUXDB_FACTORY_H
+#define INFLUXDATA_ASYNCINFLUXDB_FACTORY_H
+
+#include "AsyncInfluxDB.h"
+#include "AsyncTransport.h"
+#include "influxdb_export.h"
+#include <memory>
+#include <string>
+#include <boost/asio/any_io_executor.hpp>
+
+namespace influxdb
+{
+
+    /// \brief Factory of the coroutine API
+    class INFLUXDB_EXPORT AsyncInfluxDBFactory
+    {
+    public:
+        /// Disables copy constructor
+        AsyncInfluxDBFactory& operator=(const AsyncInfluxDBFactory&) = delete;
+
+        /// Disables copy constructor
+        AsyncInfluxDBFactory(const AsyncInfluxDBFactory&) = delete;
+
+        /// Async InfluxDB factory
+        /// \param executor   executor running all I/O of the instance
+        /// \param url   URL defining transport details, http only
+        /// \throw InfluxDBException     if unrecognised backend or missing protocol
+        static std::unique_ptr<AsyncInfluxDB> Get(const boost::asio::any_io_executor& executor, const std::string& url);
+
+        /// Async transport factory
+        /// \param executor   executor running all I/O of the transport
+        /// \param url   URL defining transport details, http only
+        /// \throw InfluxDBException     if unrecognised backend or missing protocol
+        static std::unique_ptr<AsyncTransport> GetTransport(const boost::asio::any_io_executor& executor, const std::string& url);
+
+    private:
+        /// Private constructor disallows to create instance of Factory
+        AsyncInfluxDBFactory() = default;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_ASYNCINFLUXDB_FACTORY_H
@@ -0,0 +1,56 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_ASYNCTRANSPORT_H
+#define INFLUXDATA_ASYNCTRANSPORT_H
+
+#include "InfluxDBException.h"
+#include "influxdb_export.h"
+#include <string>
+#include <utility>
+#include <boost/asio/awaitable.hpp>
+
+namespace influxdb
+{
+
+    /// \brief Non-blocking transport interface, awaited by coroutines on an asio executor
+    /// Parameters are taken by value, as they must outlive the suspended coroutine.
+    class INFLUXDB_EXPORT AsyncTransport
+    {
+    public:
+        AsyncTransport() = default;
+
+        virtual ~AsyncTransport() = default;
+
+        /// Sends string blob
+        virtual boost::asio::awaitable<void> sendAsync(std::string message) = 0;
+
+        /// Sends request, returns the response
+        virtual boost::asio::awaitable<std::string> queryAsync([[maybe_unused]] std::string query)
+        {
+            throw InfluxDBException{"Queries are not supported by the selected transport"};
+        }
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_ASYNCTRANSPORT_H
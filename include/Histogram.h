@@ -0,0 +1,135 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_HISTOGRAM_H
+#define INFLUXDATA_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Point.h"
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+
+    /// \brief Mergeable sketch of recorded values, see Histogram
+    class INFLUXDB_EXPORT HistogramSnapshot
+    {
+    public:
+        /// Number of values
+        std::uint64_t count() const;
+
+        /// Sum of all values
+        double sum() const;
+
+        /// Smallest and largest value, 0 if empty
+        double min() const;
+        double max() const;
+
+        /// Arithmetic mean, 0 if empty
+        double mean() const;
+
+        /// Value at quantile q (0 to 1), within the relative accuracy of the histogram
+        double quantile(double q) const;
+
+        /// Number of values less or equal to bound, within the relative accuracy of the histogram
+        std::uint64_t countAtMost(double bound) const;
+
+        /// Adds the values of other, e.g. of another thread or host
+        /// \throw InfluxDBException   if other has a different accuracy or range
+        void merge(const HistogramSnapshot& other);
+
+        /// Adds count, sum, min, max and mean fields, p<percentile> fields (p99_9 for 99.9)
+        /// and cumulative le_<bound> bucket fields to point
+        Point&& addFields(Point&& point,
+                          const std::vector<double>& percentiles = {50.0, 90.0, 95.0, 99.0, 99.9},
+                          const std::vector<double>& bounds = {}) const;
+
+    private:
+        friend class Histogram;
+
+        double valueOf(std::size_t index) const;
+
+        double mGamma{0.0};
+        double mMinValue{0.0};
+        int mMinIndex{0};
+        std::vector<std::uint64_t> mCounts{};
+        std::uint64_t mZeroCount{0};
+        double mSum{0.0};
+        double mMin{0.0};
+        double mMax{0.0};
+    };
+
+
+    /// \brief Histogram of non-negative values, e.g. latencies, with relative accuracy
+    ///
+    /// Values are counted in logarithmic buckets (DDSketch), so any quantile is
+    /// accurate within the relative accuracy. Recording is wait-free except for
+    /// sum, min and max, which use compare-and-swap, and never allocates.
+    class INFLUXDB_EXPORT Histogram
+    {
+    public:
+        static inline constexpr double defaultRelativeAccuracy{0.01};
+        static inline constexpr double defaultMinValue{1e-9};
+        static inline constexpr double defaultMaxValue{1e12};
+
+        /// Constructs a histogram for values of [minValue, maxValue], smaller values count as 0
+        /// \throw InfluxDBException   if the accuracy is not within (0, 1) or the range is empty
+        explicit Histogram(double relativeAccuracy = defaultRelativeAccuracy, double minValue = defaultMinValue, double maxValue = defaultMaxValue);
+
+        /// Disable copy constructor
+        Histogram(const Histogram&) = delete;
+
+        /// Disable copy constructor
+        Histogram& operator=(const Histogram&) = delete;
+
+        /// Records value, safe to call concurrently
+        void record(double value) noexcept;
+
+        /// Returns the values recorded so far
+        HistogramSnapshot snapshot() const;
+
+        /// Returns the values recorded since the last collect() and resets the histogram
+        HistogramSnapshot collect();
+
+    private:
+        HistogramSnapshot emptySnapshot() const;
+
+        const double mGamma;
+        const double mInverseLogGamma;
+        const double mMinValue;
+        const int mMinIndex;
+        const std::size_t mBucketCount;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> mCounts;
+        std::atomic<std::uint64_t> mZeroCount;
+        std::atomic<double> mSum;
+        std::atomic<double> mMin;
+        std::atomic<double> mMax;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_HISTOGRAM_H
@@ -28,14 +28,21 @@
 #ifndef INFLUXDATA_INFLUXDB_H
 #define INFLUXDATA_INFLUXDB_H
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
+#include <memory_resource>
+#include <optional>
 #include <string>
 #include <vector>
-#include <deque>
 
 #include "Transport.h"
 #include "Point.h"
+#include "LoadShedder.h"
+#include "Histogram.h"
+#include "Observer.h"
 #include "influxdb_export.h"
 
 namespace influxdb
@@ -44,6 +51,74 @@ namespace influxdb
     class INFLUXDB_EXPORT InfluxDB
     {
     public:
+        /// Handling of writes exceeding the buffer limit, see setBufferLimit()
+        enum class OverflowPolicy
+        {
+            /// Retries flushing until there is room or the timeout expired, then throws
+            Block,
+
+            /// Drops the oldest buffered points
+            DropOldest,
+
+            /// Drops the point written
+            DropNewest,
+
+            /// Throws an InfluxDBException
+            FailFast
+        };
+
+        struct BufferStatistics
+        {
+            /// Points dropped by policy or discarded after a failed flush
+            std::uint64_t dropped;
+
+            /// Writes rejected by FailFast or after the Block timeout
+            std::uint64_t rejected;
+
+            /// Writes which had to wait for room
+            std::uint64_t blocked;
+
+            /// Flushes failed
+            std::uint64_t failedFlushes;
+        };
+
+        /// Counters of the client, see stats()
+        struct Statistics
+        {
+            /// Points passed to write()
+            std::uint64_t points;
+
+            /// Lines sent successfully
+            std::uint64_t lines;
+
+            /// Bytes sent successfully
+            std::uint64_t bytes;
+
+            /// Batches sent successfully
+            std::uint64_t batches;
+
+            /// Sends failed
+            std::uint64_t failedSends;
+
+            /// Points dropped by load shedding or buffer limits
+            std::uint64_t dropped;
+
+            /// Time spent formatting line protocol
+            std::chrono::nanoseconds serializeTime;
+
+            /// Time spent in the transport
+            std::chrono::nanoseconds sendTime;
+
+            /// Latency of sends in milliseconds
+            HistogramSnapshot sendLatency;
+
+            /// Counters of the transport
+            Transport::Statistics transport;
+        };
+
+        /// Called with each point dropped
+        using DropCallback = std::function<void(const Point&)>;
+
         /// Disable copy constructor
         InfluxDB& operator=(const InfluxDB&) = delete;
 
@@ -86,6 +161,48 @@ namespace influxdb
         /// Clears the point batch
         void clearBatch();
 
+        /// Bounds the batches kept for retry after failed flushes to maxPoints and maxBytes (approximated)
+        /// Writes beyond the limit are handled by policy; automatic flushes within write() then
+        /// no longer throw but retry every batch size points. Without a limit, the kept batch
+        /// is unbounded.
+        /// \throw InfluxDBException   if a limit is 0
+        void setBufferLimit(std::size_t maxPoints, std::size_t maxBytes, OverflowPolicy policy,
+                            std::chrono::milliseconds blockTimeout = std::chrono::milliseconds{0});
+
+        /// Discards a batch failing to flush before the exception propagates, instead of keeping it for retry
+        void setDiscardFailedBatches(bool enabled);
+
+        /// Sets the function called with each point dropped, e.g. to spill it elsewhere
+        void setDropCallback(DropCallback callback);
+
+        /// Returns counters of the point buffer
+        BufferStatistics bufferStatistics() const;
+
+        /// Allocates the point batch from resource
+        /// The batch storage is released after each flush and clear, so the resource
+        /// (e.g. a monotonic arena holding the points too) can be released afterwards.
+        /// \param resource   resource outliving this instance, nullptr to use the default one
+        void setBatchMemoryResource(std::pmr::memory_resource* resource);
+
+        /// Merges points of a batch sharing measurement, tag set and timestamp into one line
+        /// Fields written later replace earlier fields of the same name.
+        void setBatchCoalescing(bool enabled);
+
+        /// Samples points per series while sends take longer than latencyThreshold or fail
+        /// Kept points carry a marker field of the sampling factor, see LoadShedder.
+        void setLoadShedding(std::chrono::milliseconds latencyThreshold, std::uint64_t maxSamplingFactor = LoadShedder::defaultMaxSamplingFactor,
+                             std::string_view markerField = LoadShedder::defaultMarkerField);
+
+        /// Sets the observer called along writes and queries
+        /// \param observer   observer outliving this instance, nullptr to remove it
+        void setObserver(Observer* observer);
+
+        /// Returns counters of points written and sent, safe to call from any thread
+        Statistics stats() const;
+
+        /// Writes stats() as a point of measurement
+        void writeStatistics(std::string_view measurement = "influxdb_client");
+
         /// Adds a global tag
         /// \param name
         /// \param value
@@ -98,8 +215,45 @@ namespace influxdb
     private:
         void addPointToBatch(Point&& point);
 
+        /// Applies the overflow policy until point fits, false if it is dropped
+        bool makeRoomFor(const Point& point, std::size_t bytes);
+
+        /// Drops the oldest buffered point
+        void dropOldest();
+
+        /// Drops all buffered points
+        void dropBatch();
+
+        /// Counts points dropped
+        void countDropped(std::size_t points, bool buffered);
+
+        /// Destroys the batch and recreates it empty using mBatchResource
+        void resetBatch();
+
         /// line protocol batch to be written
-        std::deque<Point> mPointBatch;
+        std::pmr::vector<Point> mPointBatch;
+
+        /// Index of the oldest point of the batch, points before were dropped
+        std::size_t mBatchFront;
+
+        /// Approximate line protocol size of the batch, only kept with a buffer limit
+        std::size_t mBufferedBytes;
+
+        /// Points added since the last flush attempt
+        std::size_t mWritesSinceFlush;
+
+        /// Buffer limits, 0 if unlimited
+        std::size_t mMaxBufferedPoints;
+        std::size_t mMaxBufferedBytes;
+
+        OverflowPolicy mOverflowPolicy;
+        std::chrono::milliseconds mBlockTimeout;
+        DropCallback mDropCallback;
+        bool mDiscardFailedBatches;
+        BufferStatistics mBufferStatistics;
+
+        /// Custom resource of the point batch, nullptr if default
+        std::pmr::memory_resource* mBatchResource;
 
         /// Flag stating whether point buffering is enabled
         bool mIsBatchingActivated;
@@ -107,6 +261,33 @@ namespace influxdb
         /// Points batch size
         std::size_t mBatchSize;
 
+        /// Flag stating whether points of a batch are coalesced
+        bool mIsBatchCoalescingActivated;
+
+        /// Counters of stats(), updated by the writing thread only
+        struct Counters
+        {
+            std::atomic<std::uint64_t> points{0};
+            std::atomic<std::uint64_t> lines{0};
+            std::atomic<std::uint64_t> bytes{0};
+            std::atomic<std::uint64_t> batches{0};
+            std::atomic<std::uint64_t> failedSends{0};
+            std::atomic<std::uint64_t> dropped{0};
+            std::atomic<std::uint64_t> serializeNanoseconds{0};
+            std::atomic<std::uint64_t> sendNanoseconds{0};
+        };
+
+        Counters mCounters;
+
+        /// Send latencies in milliseconds
+        Histogram mSendLatency;
+
+        /// Observer of writes and queries, nullptr if none
+        Observer* mObserver;
+
+        /// Sampling of points under overload, if enabled
+        std::optional<LoadShedder> mLoadShedder;
+
         /// Underlying transport UDP/HTTP/Unix socket
         std::unique_ptr<Transport> mTransport;
 
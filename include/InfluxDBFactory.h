@@ -29,9 +29,16 @@
 #define INFLUXDATA_INFLUXDB_FACTORY_H
 
 #include "InfluxDB.h"
+#include "ReplicatedInfluxDB.h"
+#include "ShardedInfluxDB.h"
 #include "Transport.h"
 #include "influxdb_export.h"
 
+namespace boost::asio
+{
+    class io_context;
+}
+
 namespace influxdb
 {
 
@@ -58,10 +65,45 @@ namespace influxdb
         /// \throw InfluxDBException     if unrecognised backend, missing protocol or unsupported proxy
         static std::unique_ptr<InfluxDB> Get(const std::string& url, const Proxy& proxy);
 
-    private:
-        ///\return  backend based on provided URL
+        /// InfluxDB factory
+        /// Provides InfluxDB instance with a transport sending on context, see GetTransport()
+        /// \param url   URL defining transport details
+        /// \param context   io_context outliving the instance
+        /// \throw InfluxDBException     if unrecognised backend or missing protocol
+        static std::unique_ptr<InfluxDB> Get(const std::string& url, boost::asio::io_context& context);
+
+        /// Transport factory
+        /// Provides the transport used by an InfluxDB instance for url
+        /// \param url   URL defining transport details
+        /// \throw InfluxDBException     if unrecognised backend or missing protocol
         static std::unique_ptr<Transport> GetTransport(const std::string& url);
 
+        /// Transport factory for transports sharing an io_context run by the application
+        /// UDP, TCP and unix socket transports send asynchronously on context, HTTP ignores it.
+        /// \param url   URL defining transport details
+        /// \param context   io_context outliving the transport
+        /// \throw InfluxDBException     if unrecognised backend or missing protocol
+        static std::unique_ptr<Transport> GetTransport(const std::string& url, boost::asio::io_context& context);
+
+        /// Sharded InfluxDB factory
+        /// Provides a shard per URL; repeating a URL adds connections to the same endpoint
+        /// \param urls   URLs defining transport details
+        /// \param batchSize   points per batch of each shard
+        /// \throw InfluxDBException     if urls is empty, or an unrecognised backend or missing protocol
+        static std::unique_ptr<ShardedInfluxDB> GetSharded(const std::vector<std::string>& urls,
+                                                           std::size_t batchSize = ShardedInfluxDB::defaultBatchSize);
+
+        /// Replicated InfluxDB factory
+        /// Provides a replica per URL, each receiving all points written
+        /// \param urls   URLs defining transport details
+        /// \param batchSize   points per batch, serialized once for all replicas
+        /// \throw InfluxDBException     if urls is empty, or an unrecognised backend or missing protocol
+        static std::unique_ptr<ReplicatedInfluxDB> GetReplicated(const std::vector<std::string>& urls,
+                                                                 std::size_t batchSize = ReplicatedInfluxDB::defaultBatchSize);
+
+    private:
+        static std::unique_ptr<Transport> GetTransport(const std::string& url, boost::asio::io_context* context);
+
         /// Private constructor disallows to create instance of Factory
         InfluxDBFactory() = default;
     };
@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_LINEPROTOCOLPARSER_H
+#define INFLUXDATA_LINEPROTOCOLPARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "Point.h"
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+
+    /// \brief Non-owning view of a parsed line protocol point
+    ///
+    /// All views refer to the parsed input and are still escaped, the input
+    /// has to outlive the view.
+    class INFLUXDB_EXPORT PointView
+    {
+    public:
+        /// Measurement, escaped
+        std::string_view measurement() const;
+
+        /// Tag set without the leading comma, empty if the point has no tags
+        std::string_view tags() const;
+
+        /// Field set
+        std::string_view fields() const;
+
+        /// Timestamp as written, std::nullopt if the line has none
+        std::optional<std::int64_t> timestamp() const;
+
+        /// Whole line without line terminator
+        std::string_view line() const;
+
+        /// Calls function(key, value) for each tag, both escaped
+        template <class Function>
+        void forEachTag(Function&& function) const
+        {
+            std::size_t pos{0};
+            while (const auto tag = nextPair(mTags, pos, false))
+            {
+                function(tag->first, tag->second);
+            }
+        }
+
+        /// Calls function(key, value) for each field, the value as written
+        /// including type suffix or quotes (e.g. 1i, "text")
+        template <class Function>
+        void forEachField(Function&& function) const
+        {
+            std::size_t pos{0};
+            while (const auto field = nextPair(mFields, pos, true))
+            {
+                function(field->first, field->second);
+            }
+        }
+
+        /// Converts the view to an owning, unescaped point
+        /// Points without timestamp get the current time.
+        Point toPoint() const;
+
+    private:
+        friend class LineProtocolParser;
+
+        static std::optional<std::pair<std::string_view, std::string_view>> nextPair(std::string_view elements, std::size_t& pos, bool fields);
+
+        std::string_view mLine;
+        std::string_view mMeasurement;
+        std::string_view mTags;
+        std::string_view mFields;
+        std::optional<std::int64_t> mTimestamp;
+    };
+
+
+    /// \brief Parses line protocol into point views without copying
+    ///
+    /// The input can be any buffer, e.g. a memory-mapped file; it has to outlive
+    /// the parser and all views returned. Empty lines and comments are skipped.
+    class INFLUXDB_EXPORT LineProtocolParser
+    {
+    public:
+        explicit LineProtocolParser(std::string_view input);
+
+        /// Returns the next point, std::nullopt at the end of the input
+        /// \throw InfluxDBException if the line is malformed, the next call continues with the following line
+        std::optional<PointView> next();
+
+        /// Number of the line returned last, starting at 1
+        std::size_t lineNumber() const;
+
+        /// Parses a single line without line terminator
+        /// \throw InfluxDBException if the line is malformed
+        static PointView parseLine(std::string_view line);
+
+    private:
+        std::string_view mInput;
+        std::size_t mPosition;
+        std::size_t mLineNumber;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_LINEPROTOCOLPARSER_H
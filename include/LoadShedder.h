@@ -0,0 +1,87 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_LOADSHEDDER_H
+#define INFLUXDATA_LOADSHEDDER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Point.h"
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+
+    /// \brief Samples points per series while sends are slow or failing
+    ///
+    /// While the smoothed send latency exceeds the threshold or sends fail, the sampling
+    /// factor N doubles up to the maximum; for every 10 consecutive sends below half the
+    /// threshold, it halves back towards 1. Each series keeps 1 of N points, so every
+    /// series stays visible. Kept points get a marker field, "sample_rate" by default, of N
+    /// for re-weighting on the server, points without it were not sampled. Points already
+    /// carrying a field of that name keep it unchanged. Not thread-safe, like InfluxDB.
+    class INFLUXDB_EXPORT LoadShedder
+    {
+    public:
+        static inline constexpr std::uint64_t defaultMaxSamplingFactor{64};
+        static inline constexpr std::string_view defaultMarkerField{"sample_rate"};
+
+        /// Constructs a shedder sampling once sends take longer than latencyThreshold
+        /// \param markerField   name of the field carrying the sampling factor, empty to not mark points
+        /// \throw InfluxDBException   if the threshold is not positive or maxSamplingFactor is 0
+        explicit LoadShedder(std::chrono::milliseconds latencyThreshold, std::uint64_t maxSamplingFactor = defaultMaxSamplingFactor,
+                             std::string_view markerField = defaultMarkerField);
+
+        /// Returns whether point is kept, adding the marker field while sampling
+        bool admit(Point& point);
+
+        /// Reports the duration of a send and whether it failed
+        void update(std::chrono::nanoseconds latency, bool failed);
+
+        /// Current sampling factor, 1 if all points are kept
+        std::uint64_t samplingFactor() const;
+
+        /// Points dropped so far
+        std::uint64_t dropped() const;
+
+    private:
+        /// Series tracked at most, the counters restart beyond
+        static inline constexpr std::size_t maxSeries{100000};
+
+        std::chrono::nanoseconds mLatencyThreshold;
+        std::uint64_t mMaxSamplingFactor;
+        std::string mMarkerField;
+        std::uint64_t mSamplingFactor;
+        double mSmoothedLatency;
+        std::uint64_t mHealthySends;
+        std::uint64_t mDropped;
+        std::unordered_map<std::uint64_t, std::uint64_t> mSeriesCounters;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_LOADSHEDDER_H
@@ -0,0 +1,218 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_METRICSREGISTRY_H
+#define INFLUXDATA_METRICSREGISTRY_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Histogram.h"
+#include "InfluxDB.h"
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+    namespace detail
+    {
+        /// Cell of the calling thread, threads are assigned cells round robin
+        inline std::size_t threadCell(std::size_t cellCount) noexcept
+        {
+            static std::atomic<std::size_t> next{0};
+            thread_local const std::size_t cell = next.fetch_add(1, std::memory_order_relaxed);
+            return cell % cellCount;
+        }
+    }
+
+
+    /// \brief Monotonic counter, an increment is a relaxed atomic add on a per-thread cell
+    class INFLUXDB_EXPORT Counter
+    {
+    public:
+        Counter() = default;
+
+        /// Disable copy constructor
+        Counter(const Counter&) = delete;
+
+        /// Disable copy constructor
+        Counter& operator=(const Counter&) = delete;
+
+        /// Adds n, safe to call concurrently
+        void increment(std::int64_t n = 1) noexcept
+        {
+            mCells[detail::threadCell(cellCount)].value.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        /// Sum of all increments
+        std::int64_t value() const noexcept;
+
+    private:
+        static inline constexpr std::size_t cellCount{16};
+
+        /// Padded to a cache line so threads never share one
+        struct alignas(64) Cell
+        {
+            std::atomic<std::int64_t> value{0};
+        };
+
+        std::array<Cell, cellCount> mCells{};
+    };
+
+
+    /// \brief Gauge holding the last value set
+    class INFLUXDB_EXPORT Gauge
+    {
+    public:
+        Gauge() = default;
+
+        /// Disable copy constructor
+        Gauge(const Gauge&) = delete;
+
+        /// Disable copy constructor
+        Gauge& operator=(const Gauge&) = delete;
+
+        /// Sets the value, safe to call concurrently
+        void set(double value) noexcept
+        {
+            mValue.store(value, std::memory_order_relaxed);
+        }
+
+        /// Adds delta to the value, safe to call concurrently
+        void add(double delta) noexcept;
+
+        /// Current value
+        double value() const noexcept
+        {
+            return mValue.load(std::memory_order_relaxed);
+        }
+
+    private:
+        std::atomic<double> mValue{0.0};
+    };
+
+
+    /// \brief Registry of named counters, gauges and histograms, written periodically
+    ///
+    /// Metrics are registered once and updated without locks or allocations. A
+    /// background thread snapshots all metrics at a fixed interval into one point per
+    /// metric, with the metric name as measurement and a "value" field (histograms use the
+    /// fields of HistogramSnapshot::addFields()), and writes them to db. InfluxDB is not
+    /// thread-safe, so db must not be used by others while the registry exists.
+    class INFLUXDB_EXPORT MetricsRegistry
+    {
+    public:
+        using Tags = std::vector<std::pair<std::string, std::string>>;
+
+        struct Statistics
+        {
+            /// Snapshots written
+            std::uint64_t flushes;
+
+            /// Points written
+            std::uint64_t points;
+
+            /// Snapshots failed to write
+            std::uint64_t failures;
+        };
+
+        /// Constructs a registry writing to db, which has to outlive it, every interval
+        /// \throw InfluxDBException   if interval is not positive
+        MetricsRegistry(InfluxDB& db, std::chrono::milliseconds interval);
+
+        /// Stops the scheduler and writes a last snapshot
+        ~MetricsRegistry();
+
+        /// Disable copy constructor
+        MetricsRegistry(const MetricsRegistry&) = delete;
+
+        /// Disable copy constructor
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+        /// Returns the counter of name and tags, registering it on first use
+        /// The reference remains valid for the lifetime of the registry.
+        Counter& counter(std::string_view name, const Tags& tags = {});
+
+        /// Returns the gauge of name and tags, registering it on first use
+        Gauge& gauge(std::string_view name, const Tags& tags = {});
+
+        /// Returns the histogram of name and tags, registering it on first use
+        /// Histograms are reset by each snapshot.
+        Histogram& histogram(std::string_view name, const Tags& tags = {});
+
+        /// Writes a snapshot of all metrics now
+        /// \throw InfluxDBException   if writing fails
+        void flush();
+
+        /// Returns statistics of the snapshots written
+        Statistics statistics() const;
+
+    private:
+        template <class Metric>
+        struct Entry
+        {
+            std::string name;
+            Tags tags;
+            std::unique_ptr<Metric> metric;
+        };
+
+        template <class Metric>
+        using Metrics = std::map<std::string, Entry<Metric>, std::less<>>;
+
+        template <class Metric>
+        Metric& find(Metrics<Metric>& metrics, std::string_view name, const Tags& tags);
+
+        std::vector<Point> snapshot();
+
+        void run();
+
+        InfluxDB& mDb;
+        const std::chrono::milliseconds mInterval;
+
+        mutable std::mutex mMetricsMutex;
+        Metrics<Counter> mCounters;
+        Metrics<Gauge> mGauges;
+        Metrics<Histogram> mHistograms;
+
+        mutable std::mutex mFlushMutex;
+        Statistics mStatistics;
+
+        std::mutex mSchedulerMutex;
+        std::condition_variable mStopCondition;
+        bool mStopping;
+        std::thread mScheduler;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_METRICSREGISTRY_H
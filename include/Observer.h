@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_OBSERVER_H
+#define INFLUXDATA_OBSERVER_H
+
+#include <cstddef>
+#include <exception>
+#include <string>
+
+#include "Point.h"
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+
+    /// \brief Hooks called by InfluxDB along the write and query lifecycle, e.g. for tracing
+    ///
+    /// All hooks do nothing by default, override the ones needed. They are called
+    /// synchronously on the thread using InfluxDB, so they should return quickly and must
+    /// not throw. error is nullptr on success.
+    class INFLUXDB_EXPORT Observer
+    {
+    public:
+        virtual ~Observer() = default;
+
+        /// Point accepted by write(), before it is batched or sent
+        virtual void onWrite([[maybe_unused]] const Point& point)
+        {
+        }
+
+        /// Batch of points about to be flushed
+        virtual void onBatchSealed([[maybe_unused]] std::size_t points)
+        {
+        }
+
+        /// Formatting points to line protocol starts
+        virtual void onSerializeStart([[maybe_unused]] std::size_t points)
+        {
+        }
+
+        /// Formatting points to line protocol finished
+        virtual void onSerializeEnd([[maybe_unused]] std::size_t bytes)
+        {
+        }
+
+        /// Transport starts sending
+        virtual void onSendStart([[maybe_unused]] std::size_t bytes)
+        {
+        }
+
+        /// Transport finished sending
+        virtual void onSendEnd([[maybe_unused]] std::size_t bytes, [[maybe_unused]] const std::exception* error)
+        {
+        }
+
+        /// Query or command starts
+        virtual void onQueryStart([[maybe_unused]] const std::string& query)
+        {
+        }
+
+        /// Query or command finished
+        virtual void onQueryEnd([[maybe_unused]] const std::string& query, [[maybe_unused]] const std::exception* error)
+        {
+        }
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_OBSERVER_H
@@ -31,10 +31,12 @@
 #include <string>
 #include <string_view>
 #include <chrono>
+#include <memory_resource>
 #include <variant>
-#include <deque>
 #include <type_traits>
 
+#include "SmallVector.h"
+#include "StringPool.h"
 #include "influxdb_export.h"
 
 namespace influxdb
@@ -49,9 +51,17 @@ namespace influxdb
         /// Constructs point based on measurement name
         explicit Point(const std::string& measurement);
 
+        /// Constructs point allocating its strings and tags/fields exceeding the inline capacity from resource
+        /// The resource must outlive the point; copies use the default memory resource.
+        Point(const std::string& measurement, std::pmr::memory_resource* resource);
+
         /// Adds a tags
         Point&& addTag(std::string_view key, std::string_view value);
 
+        /// Adds a tag referring to strings interned in pool
+        /// Falls back to copies if the pool is full; the point must not outlive the pool.
+        Point&& addTag(std::string_view key, std::string_view value, StringPool& pool);
+
         /// Adds field
         using FieldValue = std::variant<int, long long int, std::string, double, bool, unsigned int, unsigned long long int>;
         Point&& addField(std::string_view name, const FieldValue& value);
@@ -76,6 +86,9 @@ namespace influxdb
         /// Name getter
         std::string getName() const;
 
+        /// Name without copying, refers to the point
+        std::string_view getNameView() const;
+
         /// Timestamp getter
         std::chrono::time_point<std::chrono::system_clock> getTimestamp() const;
 
@@ -85,21 +98,65 @@ namespace influxdb
         /// Tags getter
         std::string getTags() const;
 
+        /// Field value as seen by forEachField(), strings refer to the point
+        using FieldView = std::variant<int, long long int, std::string_view, double, bool, unsigned int, unsigned long long int>;
+
+        /// Calls function(key, value) for each tag in insertion order, both unescaped
+        template <class Function>
+        void forEachTag(Function&& function) const
+        {
+            for (const auto& [key, value] : mTags)
+            {
+                function(toView(key), toView(value));
+            }
+        }
+
+        /// Calls function(name, value) for each field in insertion order
+        template <class Function>
+        void forEachField(Function&& function) const
+        {
+            for (const auto& [name, value] : mFields)
+            {
+                function(std::string_view{name}, std::visit([](const auto& v)
+                                                             { return FieldView{v}; },
+                                                             value));
+            }
+        }
+
         /// Precision for float fields
         static inline int floatsPrecision{defaultFloatsPrecision};
 
     protected:
         /// A name
-        std::string mMeasurement;
+        std::pmr::string mMeasurement;
 
         /// A timestamp
         std::chrono::time_point<std::chrono::system_clock> mTimestamp;
 
+        /// Tag key or value, either owned or a view of an interned string
+        using TagString = std::variant<std::pmr::string, std::string_view>;
+
+        /// Field value as stored, strings are allocated from the memory resource of the point
+        using FieldStorage = std::variant<int, long long int, std::pmr::string, double, bool, unsigned int, unsigned long long int>;
+
+        /// Number of tags and fields stored without allocation
+        static inline constexpr std::size_t inlineCapacity{4};
+
+        template <class T>
+        using SmallVector = detail::SmallVector<T, inlineCapacity, std::pmr::polymorphic_allocator<T>>;
+
+        static std::string_view toView(const TagString& value)
+        {
+            return std::visit([](const auto& v)
+                              { return std::string_view{v}; },
+                              value);
+        }
+
         //// Tags
-        std::deque<std::pair<std::string, std::string>> mTags;
+        SmallVector<std::pair<TagString, TagString>> mTags;
 
         //// Fields
-        std::deque<std::pair<std::string, FieldValue>> mFields;
+        SmallVector<std::pair<std::pmr::string, FieldStorage>> mFields;
     };
 
 } // namespace influxdb
@@ -0,0 +1,139 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_REPLICATEDINFLUXDB_H
+#define INFLUXDATA_REPLICATEDINFLUXDB_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Point.h"
+#include "Transport.h"
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+
+    /// \brief Writes every point to several destinations, serializing each batch once
+    ///
+    /// A full batch is serialized into one immutable buffer, which is shared by the
+    /// queues of all replicas. UDP, TCP and Unix socket transports send from that buffer,
+    /// HTTP copies it into the body of each request, as cpr owns request bodies. Each
+    /// replica sends from its own thread with its own retries, and drops its oldest batch
+    /// once maxQueuedBatches are waiting, so a slow or failing replica doesn't stall the
+    /// others. Not thread-safe, like InfluxDB.
+    class INFLUXDB_EXPORT ReplicatedInfluxDB
+    {
+    public:
+        static inline constexpr std::size_t defaultBatchSize{5000};
+        static inline constexpr std::size_t defaultMaxQueuedBatches{16};
+        static inline constexpr std::size_t defaultRetries{3};
+        static inline constexpr std::chrono::milliseconds defaultRetryDelay{100};
+
+        struct ReplicaStatistics
+        {
+            /// Batches sent successfully
+            std::uint64_t sent;
+
+            /// Sends retried
+            std::uint64_t retries;
+
+            /// Batches failed after all retries
+            std::uint64_t failed;
+
+            /// Batches dropped from a full queue
+            std::uint64_t dropped;
+
+            /// Batches waiting to be sent
+            std::size_t queued;
+        };
+
+        /// Constructs a replica per transport, failed sends are retried after retryDelay,
+        /// doubling with each retry
+        /// \throw InfluxDBException   if there are no transports, batchSize or maxQueuedBatches is 0
+        explicit ReplicatedInfluxDB(std::vector<std::unique_ptr<Transport>> transports, std::size_t batchSize = defaultBatchSize,
+                                    std::size_t maxQueuedBatches = defaultMaxQueuedBatches, std::size_t retries = defaultRetries,
+                                    std::chrono::milliseconds retryDelay = defaultRetryDelay);
+
+        /// Sends all points written and stops the sending threads
+        ~ReplicatedInfluxDB();
+
+        /// Disable copy constructor
+        ReplicatedInfluxDB(const ReplicatedInfluxDB&) = delete;
+
+        /// Disable copy constructor
+        ReplicatedInfluxDB& operator=(const ReplicatedInfluxDB&) = delete;
+
+        /// Adds point to the batch, which is queued for all replicas once full
+        void write(Point&& point);
+
+        /// Adds points to the batch
+        void write(std::vector<Point>&& points);
+
+        /// Queues the current batch and waits until all replicas sent or gave up on their queues
+        void flushBatch();
+
+        std::size_t replicaCount() const;
+
+        ReplicaStatistics statistics(std::size_t replica) const;
+
+    private:
+        using Message = std::shared_ptr<const std::string>;
+
+        struct Replica
+        {
+            explicit Replica(std::unique_ptr<Transport> transport);
+
+            std::unique_ptr<Transport> transport;
+            mutable std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable idle;
+            std::deque<Message> queue;
+            bool sending;
+            bool stopping;
+            ReplicaStatistics statistics;
+            std::thread sender;
+        };
+
+        void seal();
+        void send(Replica& replica);
+        bool sendWithRetries(Replica& replica, const Message& message);
+
+        const std::size_t mBatchSize;
+        const std::size_t mMaxQueuedBatches;
+        const std::size_t mRetries;
+        const std::chrono::milliseconds mRetryDelay;
+        std::vector<Point> mBatch;
+        std::vector<std::unique_ptr<Replica>> mReplicas;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_REPLICATEDINFLUXDB_H
@@ -0,0 +1,114 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_SHARDEDINFLUXDB_H
+#define INFLUXDATA_SHARDEDINFLUXDB_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "InfluxDB.h"
+#include "Point.h"
+#include "Transport.h"
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+
+    /// \brief Writes points to several shards, each series always to the same one
+    ///
+    /// A point is routed by a jump consistent hash of its measurement and tags to one
+    /// of the shards, so adding a shard moves only 1/N of the series. Each shard has its
+    /// own batch, transport and sending thread, so shards transmit in parallel. write()
+    /// blocks while the queue of the shard is full. A batch failing to send is dropped and
+    /// counted, the points queued after it are sent with backoff. Not thread-safe, like InfluxDB.
+    class INFLUXDB_EXPORT ShardedInfluxDB
+    {
+    public:
+        static inline constexpr std::size_t defaultBatchSize{5000};
+
+        /// Constructs a shard per transport, sending batches of batchSize points
+        /// \throw InfluxDBException   if there are no transports or batchSize is 0
+        explicit ShardedInfluxDB(std::vector<std::unique_ptr<Transport>> transports, std::size_t batchSize = defaultBatchSize);
+
+        /// Sends all points written and stops the sending threads
+        ~ShardedInfluxDB();
+
+        /// Disable copy constructor
+        ShardedInfluxDB(const ShardedInfluxDB&) = delete;
+
+        /// Disable copy constructor
+        ShardedInfluxDB& operator=(const ShardedInfluxDB&) = delete;
+
+        /// Queues point for its shard
+        void write(Point&& point);
+
+        /// Queues points for their shards
+        void write(std::vector<Point>&& points);
+
+        /// Sends all points written so far and waits until done
+        /// \throw InfluxDBException   first error of any shard since the last flush
+        void flushBatch();
+
+        std::size_t shardCount() const;
+
+        /// Index of the shard point is written to
+        std::size_t shardOf(const Point& point) const;
+
+        /// Returns statistics of the client of shard, dropped includes failed batches and points
+        /// not sent on shutdown
+        InfluxDB::Statistics stats(std::size_t shard) const;
+
+    private:
+        struct Shard
+        {
+            explicit Shard(std::unique_ptr<Transport> transport, std::size_t batchSize);
+
+            InfluxDB db;
+            mutable std::mutex mutex;
+            std::condition_variable wake;
+            std::condition_variable progress;
+            std::vector<Point> queue;
+            std::uint64_t flushRequested;
+            std::uint64_t flushCompleted;
+            bool stopping;
+            std::exception_ptr error;
+            std::uint64_t dropped;
+            std::thread sender;
+        };
+
+        void enqueue(Shard& shard, Point&& point);
+        void send(Shard& shard);
+
+        const std::size_t mBatchSize;
+        std::vector<std::unique_ptr<Shard>> mShards;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_SHARDEDINFLUXDB_H
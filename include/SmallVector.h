@@ -0,0 +1,315 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_SMALLVECTOR_H
+#define INFLUXDATA_SMALLVECTOR_H
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace influxdb::detail
+{
+
+    /// \brief Vector storing up to N elements inline before allocating
+    template <class T, std::size_t N, class Allocator = std::allocator<T>>
+    class SmallVector
+    {
+        static_assert(N > 0, "Inline capacity must not be zero");
+        static_assert(std::is_nothrow_move_constructible_v<T>, "Elements must be nothrow move constructible");
+
+        using AllocatorTraits = std::allocator_traits<Allocator>;
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using allocator_type = Allocator;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        SmallVector() noexcept
+            : SmallVector(Allocator{})
+        {
+        }
+
+        explicit SmallVector(const Allocator& allocator) noexcept
+            : mAllocator(allocator), mData(inlineData()), mSize(0), mCapacity(N)
+        {
+        }
+
+        SmallVector(const SmallVector& other)
+            : SmallVector(AllocatorTraits::select_on_container_copy_construction(other.mAllocator))
+        {
+            append(other);
+        }
+
+        SmallVector(SmallVector&& other) noexcept
+            : SmallVector(other.mAllocator)
+        {
+            takeFrom(std::move(other));
+        }
+
+        ~SmallVector()
+        {
+            clear();
+            deallocate();
+        }
+
+        SmallVector& operator=(const SmallVector& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                append(other);
+            }
+            return *this;
+        }
+
+        SmallVector& operator=(SmallVector&& other) noexcept(AllocatorTraits::propagate_on_container_move_assignment::value)
+        {
+            if (this == &other)
+            {
+                return *this;
+            }
+
+            clear();
+
+            if constexpr (AllocatorTraits::propagate_on_container_move_assignment::value)
+            {
+                deallocate();
+                mAllocator = other.mAllocator;
+                takeFrom(std::move(other));
+            }
+            else
+            {
+                if (mAllocator == other.mAllocator)
+                {
+                    deallocate();
+                    takeFrom(std::move(other));
+                }
+                else
+                {
+                    reserve(other.size());
+                    for (auto& element : other)
+                    {
+                        emplace_back(std::move(element));
+                    }
+                    other.clear();
+                }
+            }
+            return *this;
+        }
+
+        template <class... Args>
+        T& emplace_back(Args&&... args)
+        {
+            if (mSize == mCapacity)
+            {
+                // Constructed before moving the elements, as args may refer to one of them
+                const size_type capacity = mCapacity * 2;
+                T* data = AllocatorTraits::allocate(mAllocator, capacity);
+
+                try
+                {
+                    AllocatorTraits::construct(mAllocator, data + mSize, std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    AllocatorTraits::deallocate(mAllocator, data, capacity);
+                    throw;
+                }
+                moveTo(data, capacity);
+                return mData[mSize++];
+            }
+            AllocatorTraits::construct(mAllocator, mData + mSize, std::forward<Args>(args)...);
+            return mData[mSize++];
+        }
+
+        void push_back(const T& value)
+        {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value)
+        {
+            emplace_back(std::move(value));
+        }
+
+        void reserve(size_type capacity)
+        {
+            if (capacity <= mCapacity)
+            {
+                return;
+            }
+
+            moveTo(AllocatorTraits::allocate(mAllocator, capacity), capacity);
+        }
+
+        void clear() noexcept
+        {
+            for (auto& element : *this)
+            {
+                AllocatorTraits::destroy(mAllocator, &element);
+            }
+            mSize = 0;
+        }
+
+        allocator_type get_allocator() const noexcept
+        {
+            return mAllocator;
+        }
+
+        size_type size() const noexcept
+        {
+            return mSize;
+        }
+
+        size_type capacity() const noexcept
+        {
+            return mCapacity;
+        }
+
+        bool empty() const noexcept
+        {
+            return mSize == 0;
+        }
+
+        /// Returns true if the elements are stored inline
+        bool isInline() const noexcept
+        {
+            return mData == inlineData();
+        }
+
+        T& operator[](size_type index) noexcept
+        {
+            return mData[index];
+        }
+
+        const T& operator[](size_type index) const noexcept
+        {
+            return mData[index];
+        }
+
+        T& back() noexcept
+        {
+            return mData[mSize - 1];
+        }
+
+        const T& back() const noexcept
+        {
+            return mData[mSize - 1];
+        }
+
+        iterator begin() noexcept
+        {
+            return mData;
+        }
+
+        iterator end() noexcept
+        {
+            return mData + mSize;
+        }
+
+        const_iterator begin() const noexcept
+        {
+            return mData;
+        }
+
+        const_iterator end() const noexcept
+        {
+            return mData + mSize;
+        }
+
+    private:
+        T* inlineData() noexcept
+        {
+            return reinterpret_cast<T*>(mInline);
+        }
+
+        const T* inlineData() const noexcept
+        {
+            return reinterpret_cast<const T*>(mInline);
+        }
+
+        /// Moves the elements to data, which takes over as storage
+        void moveTo(T* data, size_type capacity) noexcept
+        {
+            for (size_type i = 0; i < mSize; ++i)
+            {
+                AllocatorTraits::construct(mAllocator, data + i, std::move(mData[i]));
+                AllocatorTraits::destroy(mAllocator, mData + i);
+            }
+            deallocate();
+            mData = data;
+            mCapacity = capacity;
+        }
+
+        void append(const SmallVector& other)
+        {
+            reserve(mSize + other.size());
+            for (const auto& element : other)
+            {
+                emplace_back(element);
+            }
+        }
+
+        void deallocate() noexcept
+        {
+            if (!isInline())
+            {
+                AllocatorTraits::deallocate(mAllocator, mData, mCapacity);
+                mData = inlineData();
+                mCapacity = N;
+            }
+        }
+
+        /// Expects this to be empty and inline, allocators must compare equal
+        void takeFrom(SmallVector&& other) noexcept
+        {
+            if (other.isInline())
+            {
+                for (auto& element : other)
+                {
+                    AllocatorTraits::construct(mAllocator, mData + mSize, std::move(element));
+                    ++mSize;
+                }
+                other.clear();
+            }
+            else
+            {
+                mData = std::exchange(other.mData, other.inlineData());
+                mSize = std::exchange(other.mSize, 0);
+                mCapacity = std::exchange(other.mCapacity, N);
+            }
+        }
+
+        Allocator mAllocator;
+        T* mData;
+        size_type mSize;
+        size_type mCapacity;
+        alignas(T) unsigned char mInline[N * sizeof(T)];
+    };
+
+} // namespace influxdb::detail
+
+#endif // INFLUXDATA_SMALLVECTOR_H
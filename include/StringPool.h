@@ -0,0 +1,105 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_STRINGPOOL_H
+#define INFLUXDATA_STRINGPOOL_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include "influxdb_export.h"
+
+namespace influxdb
+{
+
+    /// \brief Thread-safe pool of immutable, deduplicated strings
+    ///
+    /// Interned strings remain valid as long as the pool exists, points
+    /// referring to interned strings must not outlive it.
+    class INFLUXDB_EXPORT StringPool
+    {
+    public:
+        /// Pool statistics
+        struct Statistics
+        {
+            /// Number of distinct strings stored
+            std::size_t uniqueStrings;
+
+            /// Bytes occupied by the stored strings
+            std::size_t storedBytes;
+
+            /// Bytes not copied because an interned string was reused
+            std::size_t bytesSaved;
+
+            /// Number of strings rejected because the pool was full
+            std::size_t rejected;
+        };
+
+        static inline constexpr std::size_t defaultMaxBytes{16 * 1024 * 1024};
+
+        /// Constructs a pool storing at most maxBytes of string data
+        explicit StringPool(std::size_t maxBytes = defaultMaxBytes);
+
+        /// Disable copy constructor
+        StringPool(const StringPool&) = delete;
+
+        /// Disable copy constructor
+        StringPool& operator=(const StringPool&) = delete;
+
+        /// Returns the interned copy of value
+        /// \return  view of the interned string or std::nullopt if the pool is full
+        std::optional<std::string_view> intern(std::string_view value);
+
+        /// Returns a snapshot of the pool statistics
+        Statistics statistics() const;
+
+        /// Maximum number of bytes stored
+        std::size_t maxBytes() const;
+
+    private:
+        static inline constexpr std::size_t shardCount{16};
+
+        struct Shard
+        {
+            std::mutex mutex;
+            std::unordered_set<std::string_view> index;
+            std::deque<std::string> storage;
+        };
+
+        std::size_t mMaxBytes;
+        std::array<Shard, shardCount> mShards;
+        std::atomic<std::size_t> mUniqueStrings;
+        std::atomic<std::size_t> mStoredBytes;
+        std::atomic<std::size_t> mBytesSaved;
+        std::atomic<std::size_t> mRejected;
+    };
+
+} // namespace influxdb
+
+#endif // INFLUXDATA_STRINGPOOL_H
@@ -31,6 +31,9 @@
 #include "InfluxDBException.h"
 #include "influxdb_export.h"
 #include "Proxy.h"
+#include <cstdint>
+#include <memory>
+#include <string>
 
 namespace influxdb
 {
@@ -39,13 +42,49 @@ namespace influxdb
     class INFLUXDB_EXPORT Transport
     {
     public:
+        /// Counters of a transport
+        struct Statistics
+        {
+            /// Messages sent successfully
+            std::uint64_t messages;
+
+            /// Bytes of the messages sent successfully
+            std::uint64_t bytes;
+
+            /// Sends failed to connect or transmit
+            std::uint64_t networkErrors;
+
+            /// Sends rejected by the server
+            std::uint64_t serverErrors;
+
+            /// Payloads split after the server rejected them as too large
+            std::uint64_t splits;
+
+            /// Parts of split payloads sent again
+            std::uint64_t resent;
+        };
+
         Transport() = default;
 
         virtual ~Transport() = default;
 
+        /// Returns the counters, safe to call concurrently with send()
+        /// Transports not counting return zeros.
+        virtual Statistics stats() const
+        {
+            return Statistics{0, 0, 0, 0, 0, 0};
+        }
+
         /// Sends string blob
         virtual void send(std::string&& message) = 0;
 
+        /// Sends string blob shared with other transports, which must not be modified
+        /// Transports that can't send from a shared buffer send a copy.
+        virtual void sendShared(const std::shared_ptr<const std::string>& message)
+        {
+            send(std::string{*message});
+        }
+
         /// Sends request
         virtual std::string query([[maybe_unused]] const std::string& query)
         {
@@ -0,0 +1,281 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Aggregator.h"
+#include "InfluxDBException.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <variant>
+
+namespace influxdb
+{
+    namespace
+    {
+        std::optional<double> toNumber(const Point::FieldView& value)
+        {
+            return std::visit([](const auto& v) -> std::optional<double>
+                              {
+                                  using T = std::decay_t<decltype(v)>;
+
+                                  if constexpr (std::is_same_v<T, std::string_view> || std::is_same_v<T, bool>)
+                                  {
+                                      return std::nullopt;
+                                  }
+                                  else
+                                  {
+                                      return static_cast<double>(v);
+                                  } },
+                              value);
+        }
+
+        Point::FieldValue toFieldValue(const Point::FieldView& value)
+        {
+            return std::visit([](const auto& v)
+                              {
+                                  using T = std::decay_t<decltype(v)>;
+
+                                  if constexpr (std::is_same_v<T, std::string_view>)
+                                  {
+                                      return Point::FieldValue{std::string{v}};
+                                  }
+                                  else
+                                  {
+                                      return Point::FieldValue{v};
+                                  } },
+                              value);
+        }
+
+        void appendKeyPart(std::string& key, std::string_view part)
+        {
+            key.append(part);
+            key.push_back('\0');
+        }
+    }
+
+    Aggregator::Aggregator(InfluxDB& db, std::chrono::milliseconds window)
+        : Aggregator(db, window, Aggregates{})
+    {
+    }
+
+    Aggregator::Aggregator(InfluxDB& db, std::chrono::milliseconds window, Aggregates aggregates)
+        : mDb(db), mWindow(window), mAggregates(aggregates), mSeries{}, mNextFlush{}, mFlushedUntil{TimePoint::min()}, mStatistics{0, 0, 0}
+    {
+        if (window.count() <= 0)
+        {
+            throw InfluxDBException{"Aggregation window must be positive"};
+        }
+        mNextFlush = windowStartOf(std::chrono::system_clock::now()) + mWindow;
+    }
+
+    void Aggregator::write(const Point& point)
+    {
+        if (const auto now = std::chrono::system_clock::now(); now >= mNextFlush)
+        {
+            flushUntil(now);
+        }
+        ++mStatistics.samples;
+
+        // Tag order does not change the series, so the key uses the sorted tag set
+        mSortedTags.clear();
+        point.forEachTag([this](std::string_view key, std::string_view value)
+                         { mSortedTags.emplace_back(key, value); });
+        std::sort(mSortedTags.begin(), mSortedTags.end());
+
+        const auto measurement = point.getNameView();
+        mKey.clear();
+        appendKeyPart(mKey, measurement);
+
+        for (const auto& [key, value] : mSortedTags)
+        {
+            appendKeyPart(mKey, key);
+            appendKeyPart(mKey, value);
+        }
+
+        const auto windowStart = windowStartOf(point.getTimestamp());
+        auto series = mSeries.find(mKey);
+
+        if (windowStart < mFlushedUntil || (series != mSeries.end() && windowStart < series->second.windowStart))
+        {
+            ++mStatistics.late;
+            mDb.write(Point{point});
+            return;
+        }
+
+        if (series == mSeries.end())
+        {
+            Series created{std::string{measurement}, {}, windowStart, {}};
+            created.tags.assign(mSortedTags.begin(), mSortedTags.end());
+            series = mSeries.emplace(mKey, std::move(created)).first;
+        }
+        else if (windowStart > series->second.windowStart)
+        {
+            emit(series->second);
+            series->second.windowStart = windowStart;
+            series->second.fields.clear();
+        }
+
+        add(series->second, point);
+    }
+
+    void Aggregator::flush()
+    {
+        flushUntil(std::chrono::system_clock::now());
+    }
+
+    void Aggregator::flushAll()
+    {
+        for (const auto& [key, series] : mSeries)
+        {
+            emit(series);
+            mFlushedUntil = std::max(mFlushedUntil, series.windowStart + mWindow);
+        }
+        mSeries.clear();
+    }
+
+    std::size_t Aggregator::seriesCount() const
+    {
+        return mSeries.size();
+    }
+
+    Aggregator::Statistics Aggregator::statistics() const
+    {
+        return mStatistics;
+    }
+
+    Aggregator::TimePoint Aggregator::windowStartOf(TimePoint timestamp) const
+    {
+        auto offset = timestamp.time_since_epoch() % mWindow;
+
+        if (offset.count() < 0)
+        {
+            offset += mWindow;
+        }
+        return timestamp - offset;
+    }
+
+    void Aggregator::add(Series& series, const Point& point)
+    {
+        point.forEachField([&series](std::string_view name, const Point::FieldView& value)
+                           {
+                               auto field = std::find_if(series.fields.begin(), series.fields.end(), [name](const FieldAggregate& f)
+                                                         { return f.name == name; });
+
+                               if (field == series.fields.end())
+                               {
+                                   field = series.fields.insert(series.fields.end(),
+                                                                FieldAggregate{std::string{name}, 0, 0.0,
+                                                                               std::numeric_limits<double>::max(),
+                                                                               std::numeric_limits<double>::lowest(),
+                                                                               0.0, 0.0, Point::FieldValue{}});
+                               }
+
+                               field->last = toFieldValue(value);
+
+                               if (const auto number = toNumber(value); number.has_value())
+                               {
+                                   // Welford's online algorithm keeps mean and variance numerically stable
+                                   ++field->count;
+                                   field->sum += *number;
+                                   field->min = std::min(field->min, *number);
+                                   field->max = std::max(field->max, *number);
+                                   const double delta = *number - field->mean;
+                                   field->mean += delta / static_cast<double>(field->count);
+                                   field->m2 += delta * (*number - field->mean);
+                               } });
+    }
+
+    void Aggregator::emit(const Series& series)
+    {
+        Point point{series.measurement};
+
+        for (const auto& [key, value] : series.tags)
+        {
+            point.addTag(key, value);
+        }
+
+        for (const auto& field : series.fields)
+        {
+            if (field.count == 0)
+            {
+                point.addField(field.name, field.last);
+                continue;
+            }
+
+            if (mAggregates.count)
+            {
+                point.addField(field.name + "_count", static_cast<long long>(field.count));
+            }
+            if (mAggregates.sum)
+            {
+                point.addField(field.name + "_sum", field.sum);
+            }
+            if (mAggregates.min)
+            {
+                point.addField(field.name + "_min", field.min);
+            }
+            if (mAggregates.max)
+            {
+                point.addField(field.name + "_max", field.max);
+            }
+            if (mAggregates.last)
+            {
+                point.addField(field.name + "_last", field.last);
+            }
+            if (mAggregates.mean)
+            {
+                point.addField(field.name + "_mean", field.mean);
+            }
+            if (mAggregates.stddev)
+            {
+                const double variance = field.count > 1 ? field.m2 / static_cast<double>(field.count - 1) : 0.0;
+                point.addField(field.name + "_stddev", std::sqrt(variance));
+            }
+        }
+
+        ++mStatistics.points;
+        mDb.write(point.setTimestamp(series.windowStart));
+    }
+
+    void Aggregator::flushUntil(TimePoint now)
+    {
+        const auto currentWindow = windowStartOf(now);
+
+        for (auto series = mSeries.begin(); series != mSeries.end();)
+        {
+            if (series->second.windowStart < currentWindow)
+            {
+                emit(series->second);
+                series = mSeries.erase(series);
+            }
+            else
+            {
+                ++series;
+            }
+        }
+        mFlushedUntil = std::max(mFlushedUntil, currentWindow);
+        mNextFlush = currentWindow + mWindow;
+    }
+}
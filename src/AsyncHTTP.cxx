@@ -0,0 +1,267 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AsyncHTTP.h"
+#include "InfluxDBException.h"
+#include "UriParser.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/beast/core/flat_buffer.hpp>
+#include <boost/beast/http/read.hpp>
+#include <boost/beast/http/write.hpp>
+
+namespace influxdb::transports
+{
+    namespace
+    {
+        namespace beast = boost::beast;
+        using boost::asio::use_awaitable;
+
+        std::string encodeUrl(const std::string& value)
+        {
+            static constexpr char hex[] = "0123456789ABCDEF";
+            std::string encoded;
+            encoded.reserve(value.size());
+
+            for (const char c : value)
+            {
+                const auto byte = static_cast<unsigned char>(c);
+
+                if (std::isalnum(byte) != 0 || c == '-' || c == '_' || c == '.' || c == '~')
+                {
+                    encoded += c;
+                }
+                else
+                {
+                    encoded += '%';
+                    encoded += hex[byte >> 4];
+                    encoded += hex[byte & 0x0f];
+                }
+            }
+            return encoded;
+        }
+
+        std::string encodeBase64(const std::string& value)
+        {
+            static constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+            std::string encoded;
+            encoded.reserve((value.size() + 2) / 3 * 4);
+
+            for (std::size_t i = 0; i < value.size(); i += 3)
+            {
+                const std::size_t remaining = value.size() - i;
+                std::uint32_t group = static_cast<std::uint32_t>(static_cast<unsigned char>(value[i])) << 16;
+
+                if (remaining > 1)
+                {
+                    group |= static_cast<std::uint32_t>(static_cast<unsigned char>(value[i + 1])) << 8;
+                }
+                if (remaining > 2)
+                {
+                    group |= static_cast<unsigned char>(value[i + 2]);
+                }
+
+                encoded += alphabet[(group >> 18) & 0x3f];
+                encoded += alphabet[(group >> 12) & 0x3f];
+                encoded += remaining > 1 ? alphabet[(group >> 6) & 0x3f] : '=';
+                encoded += remaining > 2 ? alphabet[group & 0x3f] : '=';
+            }
+            return encoded;
+        }
+
+        http::url parseUrl(const std::string& url)
+        {
+            auto urlCopy = url;
+            auto parsedUrl = http::ParseHttpUrl(urlCopy);
+
+            if (parsedUrl.search.rfind("db=", 0) != 0)
+            {
+                throw InfluxDBException{"No Database specified"};
+            }
+            if (!parsedUrl.path.empty() && parsedUrl.path.back() == '/')
+            {
+                parsedUrl.path.pop_back();
+            }
+            return parsedUrl;
+        }
+    }
+
+
+    AsyncHTTP::AsyncHTTP(const boost::asio::any_io_executor& executor_, const std::string& url, std::size_t maxConnections_)
+        : executor(executor_),
+          host(),
+          port(),
+          pathPrefix(),
+          databaseName(),
+          authorization(),
+          timeout(std::chrono::seconds{10}),
+          maxConnections(std::max<std::size_t>(maxConnections_, 1)),
+          connections(0),
+          idle(),
+          available(executor_, boost::asio::steady_timer::time_point::max())
+    {
+        const auto parsedUrl = parseUrl(url);
+        host = parsedUrl.host;
+        port = parsedUrl.port > 0 ? std::to_string(parsedUrl.port) : "80";
+        pathPrefix = parsedUrl.path;
+        databaseName = encodeUrl(parsedUrl.search.substr(3));
+    }
+
+    boost::asio::awaitable<void> AsyncHTTP::sendAsync(std::string lineprotocol)
+    {
+        Request message{beast::http::verb::post, pathPrefix + "/write?db=" + databaseName, 11};
+        message.set(beast::http::field::content_type, "text/plain; charset=utf-8");
+        message.body() = std::move(lineprotocol);
+        co_await request(std::move(message));
+    }
+
+    boost::asio::awaitable<std::string> AsyncHTTP::queryAsync(std::string query)
+    {
+        Request message{beast::http::verb::get, pathPrefix + "/query?db=" + databaseName + "&q=" + encodeUrl(query), 11};
+        auto response = co_await request(std::move(message));
+        co_return std::move(response.body());
+    }
+
+    void AsyncHTTP::setBasicAuthentication(const std::string& user, const std::string& pass)
+    {
+        authorization = "Basic " + encodeBase64(user + ":" + pass);
+    }
+
+    boost::asio::awaitable<AsyncHTTP::Response> AsyncHTTP::request(Request request)
+    {
+        request.set(beast::http::field::host, host);
+        request.keep_alive(true);
+
+        if (!authorization.empty())
+        {
+            request.set(beast::http::field::authorization, authorization);
+        }
+        request.prepare_payload();
+
+        Response response;
+
+        try
+        {
+            response = co_await exchange(request);
+        }
+        catch (const boost::system::system_error& e)
+        {
+            throw InfluxDBException{"Request error: (" + std::to_string(e.code().value()) + ") " + e.code().message()};
+        }
+
+        if (const auto status = response.result_int(); status < 200 || status >= 300)
+        {
+            throw InfluxDBException{"Request failed: (" + std::to_string(status) + ") " + std::string{response.reason()}};
+        }
+        co_return response;
+    }
+
+    boost::asio::awaitable<AsyncHTTP::Response> AsyncHTTP::exchange(const Request& request)
+    {
+        // A reused connection may have been closed by the server meanwhile, so a request
+        // failing on one is repeated; it fails for good on a new connection only
+        while (true)
+        {
+            auto [stream, reused] = co_await acquire();
+            boost::system::error_code error;
+            Response response;
+
+            stream->expires_after(timeout);
+            co_await beast::http::async_write(*stream, request, boost::asio::redirect_error(use_awaitable, error));
+
+            if (!error)
+            {
+                beast::flat_buffer buffer;
+                co_await beast::http::async_read(*stream, buffer, response, boost::asio::redirect_error(use_awaitable, error));
+            }
+
+            if (!error)
+            {
+                if (!response.keep_alive())
+                {
+                    stream.reset();
+                }
+                release(std::move(stream));
+                co_return response;
+            }
+
+            release(nullptr);
+
+            if (!reused)
+            {
+                throw boost::system::system_error{error};
+            }
+        }
+    }
+
+    boost::asio::awaitable<AsyncHTTP::Connection> AsyncHTTP::acquire()
+    {
+        while (idle.empty() && connections >= maxConnections)
+        {
+            // The timer never expires, release() cancels it to wake a waiting request
+            boost::system::error_code ignored;
+            co_await available.async_wait(boost::asio::redirect_error(use_awaitable, ignored));
+        }
+
+        if (!idle.empty())
+        {
+            auto stream = std::move(idle.back());
+            idle.pop_back();
+            co_return Connection{std::move(stream), true};
+        }
+
+        ++connections;
+
+        try
+        {
+            boost::asio::ip::tcp::resolver resolver{executor};
+            const auto endpoints = co_await resolver.async_resolve(host, port, use_awaitable);
+            auto stream = std::make_unique<beast::tcp_stream>(executor);
+            stream->expires_after(timeout);
+            co_await stream->async_connect(endpoints, use_awaitable);
+            co_return Connection{std::move(stream), false};
+        }
+        catch (const boost::system::system_error&)
+        {
+            release(nullptr);
+            throw;
+        }
+    }
+
+    void AsyncHTTP::release(std::unique_ptr<beast::tcp_stream> stream)
+    {
+        if (stream != nullptr)
+        {
+            idle.push_back(std::move(stream));
+        }
+        else
+        {
+            --connections;
+        }
+        available.cancel_one();
+    }
+
+} // namespace influxdb::transports
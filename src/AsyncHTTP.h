@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef INFLUXDATA_TRANSPORTS_ASYNCHTTP_H
+#define INFLUXDATA_TRANSPORTS_ASYNCHTTP_H
+
+#include "AsyncTransport.h"
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/beast/core/tcp_stream.hpp>
+#include <boost/beast/http/string_body.hpp>
+#include <boost/beast/http/message.hpp>
+
+namespace influxdb::transports
+{
+
+    /// \brief Non-blocking HTTP transport
+    /// Keeps up to maxConnections keep-alive connections, requests beyond wait for one.
+    class AsyncHTTP : public AsyncTransport
+    {
+    public:
+        static inline constexpr std::size_t defaultMaxConnections{8};
+
+        /// Constructor
+        /// \throw InfluxDBException   if the url has no database
+        AsyncHTTP(const boost::asio::any_io_executor& executor, const std::string& url, std::size_t maxConnections = defaultMaxConnections);
+
+        /// Sends point via HTTP POST
+        /// \throw InfluxDBException   when send fails
+        boost::asio::awaitable<void> sendAsync(std::string lineprotocol) override;
+
+        /// Queries database
+        /// \throw InfluxDBException   when query fails
+        boost::asio::awaitable<std::string> queryAsync(std::string query) override;
+
+        /// Enable Basic Authentication
+        /// \param user username
+        /// \param pass password
+        void setBasicAuthentication(const std::string& user, const std::string& pass);
+
+    private:
+        using Request = boost::beast::http::request<boost::beast::http::string_body>;
+        using Response = boost::beast::http::response<boost::beast::http::string_body>;
+
+        struct Connection
+        {
+            std::unique_ptr<boost::beast::tcp_stream> stream;
+            bool reused;
+        };
+
+        boost::asio::awaitable<Response> request(Request request);
+        boost::asio::awaitable<Response> exchange(const Request& request);
+        boost::asio::awaitable<Connection> acquire();
+        void release(std::unique_ptr<boost::beast::tcp_stream> stream);
+
+        boost::asio::any_io_executor executor;
+        std::string host;
+        std::string port;
+        std::string pathPrefix;
+        std::string databaseName;
+        std::string authorization;
+        std::chrono::seconds timeout;
+        std::size_t maxConnections;
+        std::size_t connections;
+        std::vector<std::unique_ptr<boost::beast::tcp_stream>> idle;
+        boost::asio::steady_timer available;
+    };
+
+} // namespace influxdb::transports
+
+#endif // INFLUXDATA_TRANSPORTS_ASYNCHTTP_H
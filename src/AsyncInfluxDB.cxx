@@ -0,0 +1,138 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AsyncInfluxDB.h"
+#include "BoostSupport.h"
+#include "Escape.h"
+#include "InfluxDBException.h"
+#include "LineProtocol.h"
+#include <utility>
+
+namespace influxdb
+{
+    AsyncInfluxDB::AsyncInfluxDB(std::unique_ptr<AsyncTransport> transport)
+        : mTransport(std::move(transport)),
+          mBatch(),
+          mIsBatchingActivated{false},
+          mBatchSize{0},
+          mGlobalTags()
+    {
+        if (mTransport == nullptr)
+        {
+            throw InfluxDBException{"Transport must not be nullptr"};
+        }
+    }
+
+    boost::asio::awaitable<void> AsyncInfluxDB::writeAsync(Point point)
+    {
+        if (!mIsBatchingActivated)
+        {
+            std::vector<Point> points;
+            points.push_back(std::move(point));
+            co_await transmit(std::move(points));
+            co_return;
+        }
+
+        mBatch.push_back(std::move(point));
+
+        if (mBatch.size() >= mBatchSize)
+        {
+            co_await flushBatchAsync();
+        }
+    }
+
+    boost::asio::awaitable<void> AsyncInfluxDB::writeAsync(std::vector<Point> points)
+    {
+        if (!mIsBatchingActivated)
+        {
+            co_await transmit(std::move(points));
+            co_return;
+        }
+
+        for (auto&& point : points)
+        {
+            mBatch.push_back(std::move(point));
+
+            if (mBatch.size() >= mBatchSize)
+            {
+                co_await flushBatchAsync();
+            }
+        }
+    }
+
+    boost::asio::awaitable<void> AsyncInfluxDB::flushBatchAsync()
+    {
+        // Detaches the batch before suspending, so concurrent writes fill a new one
+        std::vector<Point> points;
+        points.swap(mBatch);
+        mBatch.reserve(mBatchSize);
+        co_await transmit(std::move(points));
+    }
+
+    boost::asio::awaitable<std::vector<Point>> AsyncInfluxDB::queryAsync(std::string query)
+    {
+        co_return internal::parseQueryResponse(co_await mTransport->queryAsync(std::move(query)));
+    }
+
+    void AsyncInfluxDB::batchOf(std::size_t size)
+    {
+        mBatchSize = size;
+        mIsBatchingActivated = true;
+    }
+
+    std::size_t AsyncInfluxDB::batchSize() const
+    {
+        return mBatch.size();
+    }
+
+    void AsyncInfluxDB::addGlobalTag(std::string_view name, std::string_view value)
+    {
+        if (!mGlobalTags.empty())
+        {
+            mGlobalTags += ",";
+        }
+        internal::appendEscaped(mGlobalTags, name, internal::EscapeContext::Key);
+        mGlobalTags += "=";
+        internal::appendEscaped(mGlobalTags, value, internal::EscapeContext::Key);
+    }
+
+    boost::asio::awaitable<void> AsyncInfluxDB::transmit(std::vector<Point> points)
+    {
+        if (points.empty())
+        {
+            co_return;
+        }
+
+        const LineProtocol formatter{mGlobalTags};
+        std::string lineProtocol;
+
+        for (const auto& point : points)
+        {
+            lineProtocol += formatter.format(point);
+            lineProtocol += '\n';
+        }
+        lineProtocol.pop_back();
+
+        co_await mTransport->sendAsync(std::move(lineProtocol));
+    }
+
+} // namespace influxdb
@@ -0,0 +1,56 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AsyncInfluxDBFactory.h"
+#include "AsyncHTTP.h"
+#include "InfluxDBException.h"
+#include "UriParser.h"
+
+namespace influxdb
+{
+    std::unique_ptr<AsyncTransport> AsyncInfluxDBFactory::GetTransport(const boost::asio::any_io_executor& executor, const std::string& url)
+    {
+        auto urlCopy = url;
+        http::url parsedUrl = http::ParseHttpUrl(urlCopy);
+        if (parsedUrl.protocol.empty())
+        {
+            throw InfluxDBException("Ill-formed URI");
+        }
+        if (parsedUrl.protocol != "http")
+        {
+            throw InfluxDBException("Unrecognized backend " + parsedUrl.protocol);
+        }
+
+        auto transport = std::make_unique<transports::AsyncHTTP>(executor, parsedUrl.url);
+        if (!parsedUrl.user.empty())
+        {
+            transport->setBasicAuthentication(parsedUrl.user, parsedUrl.password);
+        }
+        return transport;
+    }
+
+    std::unique_ptr<AsyncInfluxDB> AsyncInfluxDBFactory::Get(const boost::asio::any_io_executor& executor, const std::string& url)
+    {
+        return std::make_unique<AsyncInfluxDB>(AsyncInfluxDBFactory::GetTransport(executor, url));
+    }
+
+} // namespace influxdb
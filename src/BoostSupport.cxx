@@ -46,7 +46,11 @@ namespace influxdb::internal
 
     std::vector<Point> queryImpl(Transport* transport, const std::string& query)
     {
-        const auto response = transport->query(query);
+        return parseQueryResponse(transport->query(query));
+    }
+
+    std::vector<Point> parseQueryResponse(const std::string& response)
+    {
         std::stringstream responseString;
         responseString << response;
         std::vector<Point> points;
@@ -101,18 +105,30 @@ namespace influxdb::internal
         return points;
     }
 
-    std::unique_ptr<Transport> withUdpTransport(const http::url& uri)
+    std::unique_ptr<Transport> withUdpTransport(const http::url& uri, boost::asio::io_context* context)
     {
+        if (context != nullptr)
+        {
+            return std::make_unique<transports::UDP>(*context, uri.host, uri.port);
+        }
         return std::make_unique<transports::UDP>(uri.host, uri.port);
     }
 
-    std::unique_ptr<Transport> withTcpTransport(const http::url& uri)
+    std::unique_ptr<Transport> withTcpTransport(const http::url& uri, boost::asio::io_context* context)
     {
+        if (context != nullptr)
+        {
+            return std::make_unique<transports::TCP>(*context, uri.host, uri.port);
+        }
         return std::make_unique<transports::TCP>(uri.host, uri.port);
     }
 
-    std::unique_ptr<Transport> withUnixSocketTransport(const http::url& uri)
+    std::unique_ptr<Transport> withUnixSocketTransport(const http::url& uri, boost::asio::io_context* context)
     {
+        if (context != nullptr)
+        {
+            return std::make_unique<transports::UnixSocket>(*context, uri.path);
+        }
         return std::make_unique<transports::UnixSocket>(uri.path);
     }
 }
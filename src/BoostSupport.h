@@ -30,11 +30,20 @@
 #include <string>
 #include <vector>
 
+namespace boost::asio
+{
+    class io_context;
+}
+
 namespace influxdb::internal
 {
     std::vector<Point> queryImpl(Transport* transport, const std::string& query);
 
-    std::unique_ptr<Transport> withUdpTransport(const http::url& uri);
-    std::unique_ptr<Transport> withTcpTransport(const http::url& uri);
-    std::unique_ptr<Transport> withUnixSocketTransport(const http::url& uri);
+    /// Converts the JSON response of a query into points
+    std::vector<Point> parseQueryResponse(const std::string& response);
+
+    /// Transports sending asynchronously on context if not nullptr
+    std::unique_ptr<Transport> withUdpTransport(const http::url& uri, boost::asio::io_context* context = nullptr);
+    std::unique_ptr<Transport> withTcpTransport(const http::url& uri, boost::asio::io_context* context = nullptr);
+    std::unique_ptr<Transport> withUnixSocketTransport(const http::url& uri, boost::asio::io_context* context = nullptr);
 }
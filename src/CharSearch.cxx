@@ -0,0 +1,151 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "CharSearch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define INFLUXDB_SEARCH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(INFLUXDB_SEARCH_SSE2) && (defined(__GNUC__) || defined(__clang__)) && !defined(__AVX2__)
+#define INFLUXDB_SEARCH_AVX2_DISPATCH
+#endif
+
+#if defined(__AVX2__) || defined(INFLUXDB_SEARCH_AVX2_DISPATCH)
+#include <immintrin.h>
+#endif
+
+namespace influxdb::internal
+{
+    namespace
+    {
+        std::size_t findScalar(std::string_view value, const CharSet& set, std::size_t pos)
+        {
+            for (; pos < value.size(); ++pos)
+            {
+                if (const char c = value[pos]; c == set[0] || c == set[1] || c == set[2] || c == set[3])
+                {
+                    return pos;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+        int countTrailingZeros(unsigned int mask)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return __builtin_ctz(mask);
+#else
+            int count{0};
+            while ((mask & 1u) == 0)
+            {
+                mask >>= 1;
+                ++count;
+            }
+            return count;
+#endif
+        }
+
+#ifdef INFLUXDB_SEARCH_SSE2
+        std::size_t findSse2(std::string_view value, const CharSet& set, std::size_t pos)
+        {
+            const __m128i char0 = _mm_set1_epi8(set[0]);
+            const __m128i char1 = _mm_set1_epi8(set[1]);
+            const __m128i char2 = _mm_set1_epi8(set[2]);
+            const __m128i char3 = _mm_set1_epi8(set[3]);
+
+            for (; pos + 16 <= value.size(); pos += 16)
+            {
+                const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(value.data() + pos));
+                const __m128i matches = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, char0),
+                                                                  _mm_cmpeq_epi8(chunk, char1)),
+                                                     _mm_or_si128(_mm_cmpeq_epi8(chunk, char2),
+                                                                  _mm_cmpeq_epi8(chunk, char3)));
+
+                if (const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(matches)); mask != 0)
+                {
+                    return pos + static_cast<std::size_t>(countTrailingZeros(mask));
+                }
+            }
+            return findScalar(value, set, pos);
+        }
+#endif
+
+#if defined(__AVX2__) || defined(INFLUXDB_SEARCH_AVX2_DISPATCH)
+#ifdef INFLUXDB_SEARCH_AVX2_DISPATCH
+        __attribute__((target("avx2")))
+#endif
+        std::size_t
+        findAvx2(std::string_view value, const CharSet& set, std::size_t pos)
+        {
+            const __m256i char0 = _mm256_set1_epi8(set[0]);
+            const __m256i char1 = _mm256_set1_epi8(set[1]);
+            const __m256i char2 = _mm256_set1_epi8(set[2]);
+            const __m256i char3 = _mm256_set1_epi8(set[3]);
+
+            for (; pos + 32 <= value.size(); pos += 32)
+            {
+                const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(value.data() + pos));
+                const __m256i matches = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, char0),
+                                                                        _mm256_cmpeq_epi8(chunk, char1)),
+                                                        _mm256_or_si256(_mm256_cmpeq_epi8(chunk, char2),
+                                                                        _mm256_cmpeq_epi8(chunk, char3)));
+
+                if (const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(matches)); mask != 0)
+                {
+                    return pos + static_cast<std::size_t>(countTrailingZeros(mask));
+                }
+            }
+            return findSse2(value, set, pos);
+        }
+#endif
+
+        using FindFunction = std::size_t (*)(std::string_view, const CharSet&, std::size_t);
+
+        FindFunction selectFind()
+        {
+#if defined(__AVX2__)
+            return findAvx2;
+#elif defined(INFLUXDB_SEARCH_AVX2_DISPATCH)
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") ? findAvx2 : findSse2;
+#elif defined(INFLUXDB_SEARCH_SSE2)
+            return findSse2;
+#else
+            return findScalar;
+#endif
+        }
+    }
+
+    std::size_t findFirstOf(std::string_view value, const CharSet& set, std::size_t pos)
+    {
+        // Vector loads only pay off for longer ranges, most keys and values are short
+        if (pos >= value.size() || value.size() - pos < 16)
+        {
+            return findScalar(value, set, pos);
+        }
+
+        static const FindFunction findVectorized = selectFind();
+        return findVectorized(value, set, pos);
+    }
+}
@@ -0,0 +1,109 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Escape.h"
+#include "CharSearch.h"
+
+namespace influxdb::internal
+{
+    namespace
+    {
+        constexpr CharSet specialsOf(EscapeContext context)
+        {
+            switch (context)
+            {
+                case EscapeContext::Measurement:
+                    return {',', ' ', ',', ','};
+                case EscapeContext::Key:
+                    return {',', '=', ' ', ','};
+                case EscapeContext::StringValue:
+                    return {'"', '\\', '"', '"'};
+            }
+            return {',', ' ', ',', ','};
+        }
+
+        constexpr bool isSpecial(char c, const CharSet& specials)
+        {
+            return c == specials[0] || c == specials[1] || c == specials[2] || c == specials[3];
+        }
+    }
+
+    std::size_t findEscapable(std::string_view value, EscapeContext context, std::size_t pos)
+    {
+        return findFirstOf(value, specialsOf(context), pos);
+    }
+
+    void appendEscaped(std::string& dest, std::string_view value, EscapeContext context)
+    {
+        std::size_t begin{0};
+        std::size_t special = findEscapable(value, context, begin);
+
+        while (special != std::string_view::npos)
+        {
+            dest.append(value.substr(begin, special - begin));
+            dest.push_back('\\');
+            dest.push_back(value[special]);
+            begin = special + 1;
+            special = findEscapable(value, context, begin);
+        }
+        dest.append(value.substr(begin));
+    }
+
+    std::string escape(std::string_view value, EscapeContext context)
+    {
+        std::string escaped;
+        escaped.reserve(value.size());
+        appendEscaped(escaped, value, context);
+        return escaped;
+    }
+
+    void appendUnescaped(std::string& dest, std::string_view value, EscapeContext context)
+    {
+        const CharSet specials = specialsOf(context);
+        std::size_t begin{0};
+        std::size_t backslash = value.find('\\');
+
+        while (backslash != std::string_view::npos && backslash + 1 < value.size())
+        {
+            if (const char escaped = value[backslash + 1]; isSpecial(escaped, specials))
+            {
+                dest.append(value.substr(begin, backslash - begin));
+                dest.push_back(escaped);
+                begin = backslash + 2;
+                backslash = value.find('\\', begin);
+            }
+            else
+            {
+                backslash = value.find('\\', backslash + 1);
+            }
+        }
+        dest.append(value.substr(begin));
+    }
+
+    std::string unescape(std::string_view value, EscapeContext context)
+    {
+        std::string unescaped;
+        unescaped.reserve(value.size());
+        appendUnescaped(unescaped, value, context);
+        return unescaped;
+    }
+}
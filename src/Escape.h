@@ -0,0 +1,56 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace influxdb::internal
+{
+    /// Characters escaped in line protocol, depending on the element
+    enum class EscapeContext
+    {
+        /// Measurement: comma and space
+        Measurement,
+        /// Tag key, tag value and field key: comma, equals sign and space
+        Key,
+        /// String field value: double quote and backslash
+        StringValue
+    };
+
+    /// Returns the position of the first character requiring escaping at or after pos, npos if none
+    std::size_t findEscapable(std::string_view value, EscapeContext context, std::size_t pos = 0);
+
+    /// Appends value to dest, escaping special characters of the context
+    void appendEscaped(std::string& dest, std::string_view value, EscapeContext context);
+
+    /// Returns value with special characters of the context escaped
+    std::string escape(std::string_view value, EscapeContext context);
+
+    /// Appends value to dest, removing backslashes preceding special characters of the context
+    void appendUnescaped(std::string& dest, std::string_view value, EscapeContext context);
+
+    /// Returns value with escaped special characters of the context restored
+    std::string unescape(std::string_view value, EscapeContext context);
+}
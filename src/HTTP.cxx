@@ -27,11 +27,15 @@
 
 #include "HTTP.h"
 #include "InfluxDBException.h"
+#include <algorithm>
 
 namespace influxdb::transports
 {
     namespace
     {
+        constexpr std::int32_t payloadTooLarge{413};
+        constexpr std::size_t acceptedUntilRelearn{1024};
+
         void checkResponse(const cpr::Response& resp)
         {
             if (resp.error)
@@ -70,11 +74,25 @@ namespace influxdb::transports
             }
             return url.substr(dbParameterPosition + 4);
         }
+
+        /// Position of the line break nearest to the middle, npos for a single line
+        std::size_t middleLineBreak(std::string_view payload)
+        {
+            const auto middle = payload.size() / 2;
+            const auto before = payload.rfind('\n', middle);
+            const auto after = payload.find('\n', middle);
+
+            if (before == std::string_view::npos || (after != std::string_view::npos && after - middle < middle - before))
+            {
+                return after;
+            }
+            return before;
+        }
     }
 
 
     HTTP::HTTP(const std::string& url)
-        : endpointUrl(parseUrl(url)), databaseName(parseDatabaseName(url))
+        : endpointUrl(parseUrl(url)), databaseName(parseDatabaseName(url)), largestAccepted(0), smallestRejected(0), acceptedSinceRejected(0)
     {
         session.SetTimeout(cpr::Timeout{std::chrono::seconds{10}});
         session.SetConnectTimeout(cpr::ConnectTimeout{std::chrono::seconds{10}});
@@ -97,14 +115,106 @@ namespace influxdb::transports
     }
 
     void HTTP::send(std::string&& lineprotocol)
+    {
+        sendLines(lineprotocol);
+    }
+
+    void HTTP::sendShared(const std::shared_ptr<const std::string>& lineprotocol)
+    {
+        sendLines(*lineprotocol);
+    }
+
+    void HTTP::sendLines(std::string_view lineprotocol)
+    {
+        std::string_view remaining{lineprotocol};
+
+        // Splits at the last line break within the limit; lines longer are sent alone
+        for (auto limit = payloadLimit(); limit != 0 && remaining.size() > limit; limit = payloadLimit())
+        {
+            auto end = remaining.rfind('\n', limit);
+
+            if (end == std::string_view::npos || end == 0)
+            {
+                end = std::min(remaining.find('\n', 1), remaining.size());
+            }
+            sendSplitting(remaining.substr(0, end));
+            remaining.remove_prefix(std::min(end + 1, remaining.size()));
+        }
+
+        if (!remaining.empty() || lineprotocol.empty())
+        {
+            sendSplitting(remaining);
+        }
+    }
+
+    void HTTP::sendSplitting(std::string_view payload)
+    {
+        const auto response = post(payload);
+
+        if (!response.error && response.status_code == payloadTooLarge)
+        {
+            smallestRejected = smallestRejected == 0 ? payload.size() : std::min(smallestRejected, payload.size());
+            largestAccepted = std::min(largestAccepted, smallestRejected - 1);
+            acceptedSinceRejected = 0;
+
+            if (const auto lineBreak = middleLineBreak(payload); lineBreak != std::string_view::npos)
+            {
+                counters.split(2);
+                sendSplitting(payload.substr(0, lineBreak));
+                sendSplitting(payload.substr(lineBreak + 1));
+                return;
+            }
+        }
+
+        if (response.error)
+        {
+            counters.networkError();
+        }
+        else if (!cpr::status::is_success(response.status_code))
+        {
+            counters.serverError();
+        }
+        checkResponse(response);
+
+        if (payload.size() >= smallestRejected || ++acceptedSinceRejected >= acceptedUntilRelearn)
+        {
+            // Probes again whether the server accepts larger payloads now
+            smallestRejected = 0;
+        }
+        largestAccepted = std::max(largestAccepted, payload.size());
+        counters.sent(payload.size());
+    }
+
+    cpr::Response HTTP::post(std::string_view payload)
     {
         session.SetUrl(cpr::Url{endpointUrl + "/write"});
         session.SetHeader(cpr::Header{{"Content-Type", "application/json"}});
         session.SetParameters(cpr::Parameters{{"db", databaseName}});
-        session.SetBody(cpr::Body{lineprotocol});
+        session.SetBody(cpr::Body{std::string{payload}});
 
-        const auto response = session.Post();
-        checkResponse(response);
+        return session.Post();
+    }
+
+    std::size_t HTTP::payloadLimit() const
+    {
+        if (smallestRejected == 0)
+        {
+            return 0;
+        }
+
+        // Probes between the largest accepted and smallest rejected size until they are close
+        const auto gap = smallestRejected - largestAccepted;
+
+        if (gap <= smallestRejected / 16)
+        {
+            return largestAccepted;
+        }
+        return std::max<std::size_t>(largestAccepted + gap / 2, 1);
+    }
+
+    Transport::Statistics HTTP::stats() const
+    {
+        return counters.snapshot();
     }
 
     void HTTP::setProxy(const Proxy& proxy)
@@ -29,8 +29,11 @@
 #define INFLUXDATA_TRANSPORTS_HTTP_H
 
 #include "Transport.h"
+#include "TransportCounters.h"
+#include <cstddef>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <cpr/cpr.h>
 
 namespace influxdb::transports
@@ -44,9 +47,17 @@ namespace influxdb::transports
         explicit HTTP(const std::string& url);
 
         /// Sends point via HTTP POST
+        /// Payloads rejected as too large (413) are split at line boundaries and sent in
+        /// parts. Payload sizes accepted and rejected are learned, so later payloads are
+        /// split before sending; the limit is probed again after 1024 accepted payloads.
+        /// Parts sent before an error are not sent again.
         ///  \throw InfluxDBException	when send fails
         void send(std::string&& lineprotocol) override;
 
+        /// Sends points shared with other transports like send(), without copying them first
+        /// cpr owns the body of a request, so each part sent is still copied once into it.
+        void sendShared(const std::shared_ptr<const std::string>& lineprotocol) override;
+
         /// Queries database
         /// \throw InfluxDBException	when query fails
         std::string query(const std::string& query) override;
@@ -67,10 +78,30 @@ namespace influxdb::transports
         /// Sets proxy
         void setProxy(const Proxy& proxy) override;
 
+        /// Returns counters of messages sent and payloads split on 413
+        Statistics stats() const override;
+
     private:
+        /// Posts lineprotocol in parts of the learned payload limit
+        void sendLines(std::string_view lineprotocol);
+
+        /// Posts payload, splitting it in halves if it is too large
+        void sendSplitting(std::string_view payload);
+
+        cpr::Response post(std::string_view payload);
+
+        /// Size payloads are split at before sending, 0 if unlimited
+        std::size_t payloadLimit() const;
+
         std::string endpointUrl;
         std::string databaseName;
         cpr::Session session;
+        internal::TransportCounters counters;
+
+        /// Largest payload accepted, and smallest rejected as too large (0 if none)
+        std::size_t largestAccepted;
+        std::size_t smallestRejected;
+        std::size_t acceptedSinceRejected;
     };
 
 } // namespace influxdb
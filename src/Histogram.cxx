@@ -0,0 +1,293 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Histogram.h"
+#include "InfluxDBException.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <string>
+
+namespace influxdb
+{
+    namespace
+    {
+        constexpr double infinity{std::numeric_limits<double>::infinity()};
+
+        int keyOf(double value, double inverseLogGamma)
+        {
+            return static_cast<int>(std::ceil(std::log(value) * inverseLogGamma));
+        }
+
+        std::string formatNumber(double value)
+        {
+            std::ostringstream stream;
+            stream << value;
+            return stream.str();
+        }
+
+        double gammaOf(double relativeAccuracy)
+        {
+            if (!(relativeAccuracy > 0.0 && relativeAccuracy < 1.0))
+            {
+                throw InfluxDBException{"Histogram: Relative accuracy must be within (0, 1)"};
+            }
+            return (1.0 + relativeAccuracy) / (1.0 - relativeAccuracy);
+        }
+
+        double checkedMinValue(double minValue, double maxValue)
+        {
+            if (!(minValue > 0.0 && minValue < maxValue && std::isfinite(maxValue)))
+            {
+                throw InfluxDBException{"Histogram: Invalid value range"};
+            }
+            return minValue;
+        }
+
+        template <class T>
+        void updateIf(std::atomic<T>& target, T value, bool (*better)(T, T)) noexcept
+        {
+            T current = target.load(std::memory_order_relaxed);
+            while (better(value, current) && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+    }
+
+
+    Histogram::Histogram(double relativeAccuracy, double minValue, double maxValue)
+        : mGamma(gammaOf(relativeAccuracy)),
+          mInverseLogGamma(1.0 / std::log(mGamma)),
+          mMinValue(checkedMinValue(minValue, maxValue)),
+          mMinIndex(keyOf(minValue, mInverseLogGamma)),
+          mBucketCount(static_cast<std::size_t>(keyOf(maxValue, mInverseLogGamma) - mMinIndex + 1)),
+          mCounts(std::make_unique<std::atomic<std::uint64_t>[]>(mBucketCount)),
+          mZeroCount(0),
+          mSum(0.0),
+          mMin(infinity),
+          mMax(-infinity)
+    {
+    }
+
+    void Histogram::record(double value) noexcept
+    {
+        if (std::isnan(value))
+        {
+            return;
+        }
+
+        if (value < mMinValue)
+        {
+            mZeroCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            const auto key = std::clamp(keyOf(value, mInverseLogGamma) - mMinIndex, 0, static_cast<int>(mBucketCount) - 1);
+            mCounts[static_cast<std::size_t>(key)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        double sum = mSum.load(std::memory_order_relaxed);
+        while (!mSum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed))
+        {
+        }
+        updateIf<double>(mMin, value, [](double a, double b)
+                         { return a < b; });
+        updateIf<double>(mMax, value, [](double a, double b)
+                         { return a > b; });
+    }
+
+    HistogramSnapshot Histogram::snapshot() const
+    {
+        auto result = emptySnapshot();
+        for (std::size_t i = 0; i < mBucketCount; ++i)
+        {
+            result.mCounts[i] = mCounts[i].load(std::memory_order_relaxed);
+        }
+        result.mZeroCount = mZeroCount.load(std::memory_order_relaxed);
+        result.mSum = mSum.load(std::memory_order_relaxed);
+        result.mMin = mMin.load(std::memory_order_relaxed);
+        result.mMax = mMax.load(std::memory_order_relaxed);
+        return result;
+    }
+
+    HistogramSnapshot Histogram::collect()
+    {
+        auto result = emptySnapshot();
+        for (std::size_t i = 0; i < mBucketCount; ++i)
+        {
+            result.mCounts[i] = mCounts[i].exchange(0, std::memory_order_relaxed);
+        }
+        result.mZeroCount = mZeroCount.exchange(0, std::memory_order_relaxed);
+        result.mSum = mSum.exchange(0.0, std::memory_order_relaxed);
+        result.mMin = mMin.exchange(infinity, std::memory_order_relaxed);
+        result.mMax = mMax.exchange(-infinity, std::memory_order_relaxed);
+        return result;
+    }
+
+    HistogramSnapshot Histogram::emptySnapshot() const
+    {
+        HistogramSnapshot result;
+        result.mGamma = mGamma;
+        result.mMinValue = mMinValue;
+        result.mMinIndex = mMinIndex;
+        result.mCounts.resize(mBucketCount);
+        return result;
+    }
+
+
+    std::uint64_t HistogramSnapshot::count() const
+    {
+        std::uint64_t total{mZeroCount};
+        for (const auto n : mCounts)
+        {
+            total += n;
+        }
+        return total;
+    }
+
+    double HistogramSnapshot::sum() const
+    {
+        return mSum;
+    }
+
+    double HistogramSnapshot::min() const
+    {
+        return std::isfinite(mMin) ? mMin : 0.0;
+    }
+
+    double HistogramSnapshot::max() const
+    {
+        return std::isfinite(mMax) ? mMax : 0.0;
+    }
+
+    double HistogramSnapshot::mean() const
+    {
+        const auto n = count();
+        return n > 0 ? mSum / static_cast<double>(n) : 0.0;
+    }
+
+    double HistogramSnapshot::quantile(double q) const
+    {
+        const auto n = count();
+        if (n == 0)
+        {
+            return 0.0;
+        }
+        if (q <= 0.0)
+        {
+            return min();
+        }
+        if (q >= 1.0)
+        {
+            return max();
+        }
+
+        const auto rank = q * static_cast<double>(n - 1);
+        auto seen = static_cast<double>(mZeroCount);
+
+        if (seen > rank)
+        {
+            return std::clamp(0.0, min(), max());
+        }
+
+        for (std::size_t i = 0; i < mCounts.size(); ++i)
+        {
+            seen += static_cast<double>(mCounts[i]);
+            if (seen > rank)
+            {
+                return std::clamp(valueOf(i), min(), max());
+            }
+        }
+        return max();
+    }
+
+    std::uint64_t HistogramSnapshot::countAtMost(double bound) const
+    {
+        if (bound >= max())
+        {
+            return count();
+        }
+        if (bound < min() || count() == 0)
+        {
+            return 0;
+        }
+
+        std::uint64_t total{mZeroCount};
+        if (bound >= mMinValue)
+        {
+            const auto last = keyOf(bound, 1.0 / std::log(mGamma)) - mMinIndex;
+            for (std::size_t i = 0; i < mCounts.size() && static_cast<int>(i) <= last; ++i)
+            {
+                total += mCounts[i];
+            }
+        }
+        return total;
+    }
+
+    void HistogramSnapshot::merge(const HistogramSnapshot& other)
+    {
+        if (other.mGamma != mGamma || other.mMinValue != mMinValue || other.mCounts.size() != mCounts.size())
+        {
+            throw InfluxDBException{"Histogram: Cannot merge histograms of different accuracy or range"};
+        }
+
+        for (std::size_t i = 0; i < mCounts.size(); ++i)
+        {
+            mCounts[i] += other.mCounts[i];
+        }
+        mZeroCount += other.mZeroCount;
+        mSum += other.mSum;
+        mMin = std::min(mMin, other.mMin);
+        mMax = std::max(mMax, other.mMax);
+    }
+
+    Point&& HistogramSnapshot::addFields(Point&& point, const std::vector<double>& percentiles, const std::vector<double>& bounds) const
+    {
+        const auto n = count();
+        point.addField("count", static_cast<long long int>(n)).addField("sum", mSum);
+
+        if (n > 0)
+        {
+            point.addField("min", min()).addField("max", max()).addField("mean", mean());
+
+            for (const auto percentile : percentiles)
+            {
+                auto name = "p" + formatNumber(percentile);
+                std::replace(name.begin(), name.end(), '.', '_');
+                point.addField(name, quantile(percentile / 100.0));
+            }
+        }
+
+        for (const auto bound : bounds)
+        {
+            point.addField("le_" + formatNumber(bound), static_cast<long long int>(countAtMost(bound)));
+        }
+        return std::move(point);
+    }
+
+    double HistogramSnapshot::valueOf(std::size_t index) const
+    {
+        return 2.0 * std::pow(mGamma, static_cast<int>(index) + mMinIndex) / (mGamma + 1.0);
+    }
+
+} // namespace influxdb
@@ -28,18 +28,222 @@
 #include "InfluxDB.h"
 #include "InfluxDBException.h"
 #include "LineProtocol.h"
+#include "Escape.h"
 #include "BoostSupport.h"
+#include <algorithm>
+#include <cstdint>
+#include <functional>
 #include <iostream>
+#include <iterator>
 #include <memory>
+#include <new>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <variant>
 
 namespace influxdb
 {
+    namespace
+    {
+        struct CoalescedPoint
+        {
+            const Point* point;
+            std::vector<std::pair<std::string_view, Point::FieldView>> fields;
+        };
+
+        Point::FieldValue toFieldValue(const Point::FieldView& value)
+        {
+            return std::visit([](const auto& v)
+                              {
+                                  using T = std::decay_t<decltype(v)>;
+
+                                  if constexpr (std::is_same_v<T, std::string_view>)
+                                  {
+                                      return Point::FieldValue{std::string{v}};
+                                  }
+                                  else
+                                  {
+                                      return Point::FieldValue{v};
+                                  } },
+                              value);
+        }
+
+        void appendKeyPart(std::string& key, std::string_view part)
+        {
+            key.append(part);
+            key.push_back('\0');
+        }
+
+        /// Merges points of the same series and timestamp, using a hash index to stay linear
+        template <class Iterator>
+        std::string coalescePoints(Iterator begin, Iterator end, const LineProtocol& formatter)
+        {
+            std::vector<CoalescedPoint> coalesced;
+            std::unordered_map<std::string, std::size_t> index;
+            std::vector<std::pair<std::string_view, std::string_view>> sortedTags;
+            std::string key;
+            const auto size = static_cast<std::size_t>(std::distance(begin, end));
+            coalesced.reserve(size);
+            index.reserve(size);
+
+            for (auto point = begin; point != end; ++point)
+            {
+                // Tag order does not change the series, so the key uses the sorted tag set
+                sortedTags.clear();
+                point->forEachTag([&sortedTags](std::string_view tagKey, std::string_view value)
+                                  { sortedTags.emplace_back(tagKey, value); });
+                std::sort(sortedTags.begin(), sortedTags.end());
+
+                key.clear();
+                appendKeyPart(key, point->getNameView());
+
+                for (const auto& [tagKey, value] : sortedTags)
+                {
+                    appendKeyPart(key, tagKey);
+                    appendKeyPart(key, value);
+                }
+
+                const auto timestamp = point->getTimestamp().time_since_epoch().count();
+                key.append(reinterpret_cast<const char*>(&timestamp), sizeof(timestamp));
+
+                const auto [entry, inserted] = index.try_emplace(key, coalesced.size());
+
+                if (inserted)
+                {
+                    coalesced.push_back(CoalescedPoint{&*point, {}});
+                }
+
+                auto& fields = coalesced[entry->second].fields;
+                point->forEachField([&fields](std::string_view name, const Point::FieldView& value)
+                                    {
+                                        const auto existing = std::find_if(fields.begin(), fields.end(), [name](const auto& field)
+                                                                           { return field.first == name; });
+
+                                        if (existing != fields.end())
+                                        {
+                                            existing->second = value;
+                                        }
+                                        else
+                                        {
+                                            fields.emplace_back(name, value);
+                                        } });
+            }
+
+            std::string joined;
+
+            for (const auto& [point, fields] : coalesced)
+            {
+                if (index.size() == size)
+                {
+                    // Nothing was merged
+                    joined.append(formatter.format(*point)).append("\n");
+                    continue;
+                }
+
+                Point merged{point->getName()};
+                point->forEachTag([&merged](std::string_view tagKey, std::string_view value)
+                                  { merged.addTag(tagKey, value); });
+
+                for (const auto& [name, value] : fields)
+                {
+                    merged.addField(name, toFieldValue(value));
+                }
+                joined.append(formatter.format(merged.setTimestamp(point->getTimestamp()))).append("\n");
+            }
+
+            joined.pop_back();
+            return joined;
+        }
+
+        std::uint64_t nanosecondsSince(std::chrono::steady_clock::time_point start)
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        /// Returns the line protocol of function, adding its duration to total
+        template <class Function>
+        std::string serialize(std::atomic<std::uint64_t>& total, Observer* observer, std::size_t points, Function&& function)
+        {
+            if (observer != nullptr)
+            {
+                observer->onSerializeStart(points);
+            }
+
+            const auto start = std::chrono::steady_clock::now();
+            auto lineProtocol = function();
+            total.fetch_add(nanosecondsSince(start), std::memory_order_relaxed);
+
+            if (observer != nullptr)
+            {
+                observer->onSerializeEnd(lineProtocol.size());
+            }
+            return lineProtocol;
+        }
+
+        /// Calls function, notifying observer of the query
+        template <class Function>
+        auto observeQuery(Observer* observer, const std::string& query, Function&& function)
+        {
+            if (observer == nullptr)
+            {
+                return function();
+            }
+
+            observer->onQueryStart(query);
+            try
+            {
+                auto result = function();
+                observer->onQueryEnd(query, nullptr);
+                return result;
+            }
+            catch (const std::exception& e)
+            {
+                observer->onQueryEnd(query, &e);
+                throw;
+            }
+        }
+
+        /// Approximate line protocol size of point, numbers count as 20 characters
+        std::size_t approximateSize(const Point& point)
+        {
+            constexpr std::size_t numberSize{20};
+            std::size_t size{point.getName().size() + numberSize};
+
+            point.forEachTag([&size](std::string_view key, std::string_view value)
+                             { size += key.size() + value.size() + 2; });
+            point.forEachField([&size](std::string_view name, const Point::FieldView& value)
+                               {
+                                   const auto* text = std::get_if<std::string_view>(&value);
+                                   size += name.size() + (text != nullptr ? text->size() + 3 : numberSize) + 1; });
+            return size;
+        }
+    }
 
     InfluxDB::InfluxDB(std::unique_ptr<Transport> transport)
         : mPointBatch{},
+          mBatchFront{0},
+          mBufferedBytes{0},
+          mWritesSinceFlush{0},
+          mMaxBufferedPoints{0},
+          mMaxBufferedBytes{0},
+          mOverflowPolicy{OverflowPolicy::FailFast},
+          mBlockTimeout{0},
+          mDropCallback{},
+          mDiscardFailedBatches{false},
+          mBufferStatistics{0, 0, 0, 0},
+          mBatchResource{nullptr},
           mIsBatchingActivated{false},
           mBatchSize{0},
+          mIsBatchCoalescingActivated{false},
+          mCounters{},
+          mSendLatency{},
+          mObserver{nullptr},
+          mLoadShedder{},
           mTransport(std::move(transport)),
           mGlobalTags{}
     {
@@ -57,33 +261,122 @@ namespace influxdb
 
     std::size_t InfluxDB::batchSize() const
     {
-        return mPointBatch.size();
+        return mPointBatch.size() - mBatchFront;
     }
 
     void InfluxDB::clearBatch()
     {
-        mPointBatch.clear();
+        if (mBatchResource != nullptr)
+        {
+            resetBatch();
+        }
+        else
+        {
+            mPointBatch.clear();
+        }
+        mBatchFront = 0;
+        mBufferedBytes = 0;
+    }
+
+    void InfluxDB::setBufferLimit(std::size_t maxPoints, std::size_t maxBytes, OverflowPolicy policy, std::chrono::milliseconds blockTimeout)
+    {
+        if (maxPoints == 0 || maxBytes == 0)
+        {
+            throw InfluxDBException{"Buffer limits must be positive"};
+        }
+        if (mMaxBufferedPoints == 0)
+        {
+            mBufferedBytes = 0;
+            std::for_each(std::next(mPointBatch.cbegin(), static_cast<std::ptrdiff_t>(mBatchFront)), mPointBatch.cend(), [this](const Point& point)
+                          { mBufferedBytes += approximateSize(point); });
+        }
+        mMaxBufferedPoints = maxPoints;
+        mMaxBufferedBytes = maxBytes;
+        mOverflowPolicy = policy;
+        mBlockTimeout = blockTimeout;
+    }
+
+    void InfluxDB::setDiscardFailedBatches(bool enabled)
+    {
+        mDiscardFailedBatches = enabled;
+    }
+
+    void InfluxDB::setDropCallback(DropCallback callback)
+    {
+        mDropCallback = std::move(callback);
+    }
+
+    InfluxDB::BufferStatistics InfluxDB::bufferStatistics() const
+    {
+        return mBufferStatistics;
+    }
+
+    void InfluxDB::setBatchMemoryResource(std::pmr::memory_resource* resource)
+    {
+        std::pmr::vector<Point> pending{std::move(mPointBatch)};
+        const auto front = std::exchange(mBatchFront, 0);
+        mBatchResource = resource;
+        resetBatch();
+        mPointBatch.reserve(pending.size() - front);
+        std::move(std::next(pending.begin(), static_cast<std::ptrdiff_t>(front)), pending.end(), std::back_inserter(mPointBatch));
+    }
+
+    void InfluxDB::resetBatch()
+    {
+        // Assignment never replaces the allocator of a pmr container
+        mPointBatch.~vector();
+        ::new (&mPointBatch) std::pmr::vector<Point>{mBatchResource != nullptr ? mBatchResource : std::pmr::get_default_resource()};
     }
 
     void InfluxDB::flushBatch()
     {
-        if (mIsBatchingActivated && !mPointBatch.empty())
+        if (mIsBatchingActivated && batchSize() > 0)
         {
-            transmit(joinLineProtocolBatch());
-            mPointBatch.clear();
+            mWritesSinceFlush = 0;
+
+            if (mObserver != nullptr)
+            {
+                mObserver->onBatchSealed(batchSize());
+            }
+
+            try
+            {
+                transmit(serialize(mCounters.serializeNanoseconds, mObserver, batchSize(), [this]
+                                   { return joinLineProtocolBatch(); }));
+            }
+            catch (...)
+            {
+                ++mBufferStatistics.failedFlushes;
+
+                if (mDiscardFailedBatches)
+                {
+                    dropBatch();
+                }
+                throw;
+            }
+            mCounters.batches.fetch_add(1, std::memory_order_relaxed);
+            clearBatch();
         }
     }
 
-    std::string InfluxDB::joinLineProtocolBatch() const
+    void InfluxDB::setBatchCoalescing(bool enabled)
     {
-        std::string joinedBatch;
+        mIsBatchCoalescingActivated = enabled;
+    }
 
+    std::string InfluxDB::joinLineProtocolBatch() const
+    {
         LineProtocol formatter{mGlobalTags};
-        for (const auto& point : mPointBatch)
+
+        if (mIsBatchCoalescingActivated)
         {
-            joinedBatch += formatter.format(point) + "\n";
+            return coalescePoints(std::next(mPointBatch.cbegin(), static_cast<std::ptrdiff_t>(mBatchFront)), mPointBatch.cend(), formatter);
         }
 
+        std::string joinedBatch;
+        std::for_each(std::next(mPointBatch.cbegin(), static_cast<std::ptrdiff_t>(mBatchFront)), mPointBatch.cend(), [&joinedBatch, &formatter](const Point& point)
+                      { joinedBatch += formatter.format(point) + "\n"; });
+
         joinedBatch.erase(std::prev(joinedBatch.end()));
         return joinedBatch;
     }
@@ -95,18 +388,123 @@ namespace influxdb
         {
             mGlobalTags += ",";
         }
-        mGlobalTags += name;
+        internal::appendEscaped(mGlobalTags, name, internal::EscapeContext::Key);
         mGlobalTags += "=";
-        mGlobalTags += value;
+        internal::appendEscaped(mGlobalTags, value, internal::EscapeContext::Key);
+    }
+
+    void InfluxDB::setLoadShedding(std::chrono::milliseconds latencyThreshold, std::uint64_t maxSamplingFactor, std::string_view markerField)
+    {
+        mLoadShedder.emplace(latencyThreshold, maxSamplingFactor, markerField);
     }
 
     void InfluxDB::transmit(std::string&& point)
     {
-        mTransport->send(std::move(point));
+        const auto bytes = point.size();
+        const auto lines = static_cast<std::uint64_t>(std::count(point.cbegin(), point.cend(), '\n')) + 1;
+        if (mObserver != nullptr)
+        {
+            mObserver->onSendStart(bytes);
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto finish = [this, start](bool failed)
+        {
+            const auto elapsed = nanosecondsSince(start);
+            mCounters.sendNanoseconds.fetch_add(elapsed, std::memory_order_relaxed);
+            mSendLatency.record(static_cast<double>(elapsed) / 1e6);
+
+            if (mLoadShedder)
+            {
+                mLoadShedder->update(std::chrono::nanoseconds{elapsed}, failed);
+            }
+        };
+
+        try
+        {
+            mTransport->send(std::move(point));
+        }
+        catch (const std::exception& e)
+        {
+            finish(true);
+            mCounters.failedSends.fetch_add(1, std::memory_order_relaxed);
+
+            if (mObserver != nullptr)
+            {
+                mObserver->onSendEnd(bytes, &e);
+            }
+            throw;
+        }
+        finish(false);
+
+        if (mObserver != nullptr)
+        {
+            mObserver->onSendEnd(bytes, nullptr);
+        }
+        mCounters.lines.fetch_add(lines, std::memory_order_relaxed);
+        mCounters.bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void InfluxDB::setObserver(Observer* observer)
+    {
+        mObserver = observer;
+    }
+
+    InfluxDB::Statistics InfluxDB::stats() const
+    {
+        return Statistics{mCounters.points.load(std::memory_order_relaxed),
+                          mCounters.lines.load(std::memory_order_relaxed),
+                          mCounters.bytes.load(std::memory_order_relaxed),
+                          mCounters.batches.load(std::memory_order_relaxed),
+                          mCounters.failedSends.load(std::memory_order_relaxed),
+                          mCounters.dropped.load(std::memory_order_relaxed),
+                          std::chrono::nanoseconds{mCounters.serializeNanoseconds.load(std::memory_order_relaxed)},
+                          std::chrono::nanoseconds{mCounters.sendNanoseconds.load(std::memory_order_relaxed)},
+                          mSendLatency.snapshot(),
+                          mTransport->stats()};
+    }
+
+    void InfluxDB::writeStatistics(std::string_view measurement)
+    {
+        const auto current = stats();
+        const auto toInteger = [](std::uint64_t value)
+        {
+            return static_cast<long long int>(value);
+        };
+
+        write(Point{std::string{measurement}}
+                  .addField("points", toInteger(current.points))
+                  .addField("lines", toInteger(current.lines))
+                  .addField("bytes", toInteger(current.bytes))
+                  .addField("batches", toInteger(current.batches))
+                  .addField("failed_sends", toInteger(current.failedSends))
+                  .addField("dropped", toInteger(current.dropped))
+                  .addField("serialize_ns", toInteger(static_cast<std::uint64_t>(current.serializeTime.count())))
+                  .addField("send_ns", toInteger(static_cast<std::uint64_t>(current.sendTime.count())))
+                  .addField("send_latency_p50_ms", current.sendLatency.quantile(0.5))
+                  .addField("send_latency_p99_ms", current.sendLatency.quantile(0.99))
+                  .addField("send_latency_max_ms", current.sendLatency.max())
+                  .addField("transport_network_errors", toInteger(current.transport.networkErrors))
+                  .addField("transport_server_errors", toInteger(current.transport.serverErrors))
+                  .addField("transport_splits", toInteger(current.transport.splits))
+                  .addField("transport_resent", toInteger(current.transport.resent)));
     }
 
     void InfluxDB::write(Point&& point)
     {
+        mCounters.points.fetch_add(1, std::memory_order_relaxed);
+
+        if (mLoadShedder && !mLoadShedder->admit(point))
+        {
+            countDropped(1, false);
+            return;
+        }
+
+        if (mObserver != nullptr)
+        {
+            mObserver->onWrite(point);
+        }
+
         if (mIsBatchingActivated)
         {
             addPointToBatch(std::move(point));
@@ -114,12 +512,34 @@ namespace influxdb
         else
         {
             LineProtocol formatter{mGlobalTags};
-            transmit(formatter.format(point));
+            transmit(serialize(mCounters.serializeNanoseconds, mObserver, 1, [&formatter, &point]
+                               { return formatter.format(point); }));
         }
     }
 
     void InfluxDB::write(std::vector<Point>&& points)
     {
+        mCounters.points.fetch_add(points.size(), std::memory_order_relaxed);
+
+        if (mLoadShedder)
+        {
+            const auto admitted = std::remove_if(points.begin(), points.end(), [this](Point& point)
+                                                 { return !mLoadShedder->admit(point); });
+            countDropped(static_cast<std::size_t>(std::distance(admitted, points.end())), false);
+            points.erase(admitted, points.end());
+        }
+
+        if (points.empty())
+        {
+            return;
+        }
+
+        if (mObserver != nullptr)
+        {
+            std::for_each(points.cbegin(), points.cend(), [this](const Point& point)
+                          { mObserver->onWrite(point); });
+        }
+
         if (mIsBatchingActivated)
         {
             for (auto&& point : points)
@@ -129,37 +549,176 @@ namespace influxdb
         }
         else
         {
-            std::string lineProtocol;
             LineProtocol formatter{mGlobalTags};
+            transmit(serialize(mCounters.serializeNanoseconds, mObserver, points.size(), [&formatter, &points]
+                               {
+                                   std::string lineProtocol;
+                                   for (const auto& point : points)
+                                   {
+                                       lineProtocol += formatter.format(point) + "\n";
+                                   }
 
-            for (const auto& point : points)
-            {
-                lineProtocol += formatter.format(point) + "\n";
-            }
-
-            lineProtocol.erase(std::prev(lineProtocol.end()));
-            transmit(std::move(lineProtocol));
+                                   lineProtocol.erase(std::prev(lineProtocol.end()));
+                                   return lineProtocol; }));
         }
     }
 
     std::string InfluxDB::execute(const std::string& cmd)
     {
-        return mTransport->execute(cmd);
+        return observeQuery(mObserver, cmd, [this, &cmd]
+                            { return mTransport->execute(cmd); });
     }
 
     void InfluxDB::addPointToBatch(Point&& point)
     {
+        if (mMaxBufferedPoints > 0)
+        {
+            // Sizes are only needed to enforce a buffer limit
+            const auto bytes = approximateSize(point);
+
+            if (!makeRoomFor(point, bytes))
+            {
+                return;
+            }
+            mBufferedBytes += bytes;
+        }
+
         mPointBatch.emplace_back(std::move(point));
+        ++mWritesSinceFlush;
 
-        if (mPointBatch.size() >= mBatchSize)
+        if (batchSize() < mBatchSize)
+        {
+            return;
+        }
+
+        if (mMaxBufferedPoints == 0)
         {
             flushBatch();
         }
+        else if (mWritesSinceFlush >= mBatchSize)
+        {
+            try
+            {
+                flushBatch();
+            }
+            catch (const std::exception&)
+            {
+                // Kept for retry, counted as failed flush
+            }
+        }
+    }
+
+    bool InfluxDB::makeRoomFor(const Point& point, std::size_t bytes)
+    {
+        const auto fits = [this, bytes]
+        {
+            return batchSize() == 0 || (batchSize() < mMaxBufferedPoints && mBufferedBytes + bytes <= mMaxBufferedBytes);
+        };
+
+        if (fits())
+        {
+            return true;
+        }
+
+        switch (mOverflowPolicy)
+        {
+            case OverflowPolicy::DropOldest:
+                while (!fits())
+                {
+                    dropOldest();
+                }
+                return true;
+            case OverflowPolicy::DropNewest:
+                countDropped(1, true);
+                if (mDropCallback)
+                {
+                    mDropCallback(point);
+                }
+                return false;
+            case OverflowPolicy::Block:
+            {
+                ++mBufferStatistics.blocked;
+                const auto deadline = std::chrono::steady_clock::now() + mBlockTimeout;
+                std::chrono::milliseconds backoff{10};
+
+                while (true)
+                {
+                    try
+                    {
+                        flushBatch();
+                    }
+                    catch (const std::exception&)
+                    {
+                        // Kept for retry, counted as failed flush
+                    }
+
+                    if (fits())
+                    {
+                        return true;
+                    }
+
+                    const auto now = std::chrono::steady_clock::now();
+                    if (now >= deadline)
+                    {
+                        break;
+                    }
+                    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(backoff, deadline - now));
+                    backoff = std::min(backoff * 2, std::chrono::milliseconds{1000});
+                }
+                break;
+            }
+            case OverflowPolicy::FailFast:
+                break;
+        }
+
+        ++mBufferStatistics.rejected;
+        throw InfluxDBException{"Point buffer full"};
+    }
+
+    void InfluxDB::countDropped(std::size_t points, bool buffered)
+    {
+        mCounters.dropped.fetch_add(points, std::memory_order_relaxed);
+
+        if (buffered)
+        {
+            mBufferStatistics.dropped += points;
+        }
+    }
+
+    void InfluxDB::dropOldest()
+    {
+        const auto& oldest = mPointBatch[mBatchFront++];
+        mBufferedBytes -= std::min(mBufferedBytes, approximateSize(oldest));
+        countDropped(1, true);
+
+        if (mDropCallback)
+        {
+            mDropCallback(oldest);
+        }
+
+        // Compacting once half the batch was dropped keeps dropping amortized constant
+        if (mBatchFront * 2 >= mPointBatch.size())
+        {
+            mPointBatch.erase(mPointBatch.begin(), std::next(mPointBatch.begin(), static_cast<std::ptrdiff_t>(mBatchFront)));
+            mBatchFront = 0;
+        }
+    }
+
+    void InfluxDB::dropBatch()
+    {
+        countDropped(batchSize(), true);
+
+        if (mDropCallback)
+        {
+            std::for_each(std::next(mPointBatch.cbegin(), static_cast<std::ptrdiff_t>(mBatchFront)), mPointBatch.cend(), mDropCallback);
+        }
+        clearBatch();
     }
 
     std::vector<Point> InfluxDB::query(const std::string& query)
     {
-        return internal::queryImpl(mTransport.get(), query);
+        return observeQuery(mObserver, query, [this, &query]
+                            { return internal::queryImpl(mTransport.get(), query); });
     }
 
     void InfluxDB::createDatabaseIfNotExists()
@@ -39,7 +39,7 @@ namespace influxdb
 {
     namespace internal
     {
-        std::unique_ptr<Transport> withHttpTransport(const http::url& uri)
+        std::unique_ptr<Transport> withHttpTransport(const http::url& uri, [[maybe_unused]] boost::asio::io_context* context)
         {
             auto transport = std::make_unique<transports::HTTP>(uri.url);
             if (!uri.user.empty())
@@ -53,7 +53,17 @@ namespace influxdb
 
     std::unique_ptr<Transport> InfluxDBFactory::GetTransport(const std::string& url)
     {
-        static const std::map<std::string, std::function<std::unique_ptr<Transport>(const http::url&)>> map = {
+        return GetTransport(url, nullptr);
+    }
+
+    std::unique_ptr<Transport> InfluxDBFactory::GetTransport(const std::string& url, boost::asio::io_context& context)
+    {
+        return GetTransport(url, &context);
+    }
+
+    std::unique_ptr<Transport> InfluxDBFactory::GetTransport(const std::string& url, boost::asio::io_context* context)
+    {
+        static const std::map<std::string, std::function<std::unique_ptr<Transport>(const http::url&, boost::asio::io_context*)>> map = {
             {"udp", internal::withUdpTransport},
             {"tcp", internal::withTcpTransport},
             {"http", internal::withHttpTransport},
@@ -74,7 +84,7 @@ namespace influxdb
             throw InfluxDBException("Unrecognized backend " + parsedUrl.protocol);
         }
 
-        return iterator->second(parsedUrl);
+        return iterator->second(parsedUrl, context);
     }
 
     std::unique_ptr<InfluxDB> InfluxDBFactory::Get(const std::string& url)
@@ -82,6 +92,11 @@ namespace influxdb
         return std::make_unique<InfluxDB>(InfluxDBFactory::GetTransport(url));
     }
 
+    std::unique_ptr<InfluxDB> InfluxDBFactory::Get(const std::string& url, boost::asio::io_context& context)
+    {
+        return std::make_unique<InfluxDB>(InfluxDBFactory::GetTransport(url, context));
+    }
+
     std::unique_ptr<InfluxDB> InfluxDBFactory::Get(const std::string& url, const Proxy& proxy)
     {
         auto transport = InfluxDBFactory::GetTransport(url);
@@ -89,4 +104,28 @@ namespace influxdb
         return std::make_unique<InfluxDB>(std::move(transport));
     }
 
+    std::unique_ptr<ShardedInfluxDB> InfluxDBFactory::GetSharded(const std::vector<std::string>& urls, std::size_t batchSize)
+    {
+        std::vector<std::unique_ptr<Transport>> transports;
+        transports.reserve(urls.size());
+
+        for (const auto& url : urls)
+        {
+            transports.push_back(InfluxDBFactory::GetTransport(url));
+        }
+        return std::make_unique<ShardedInfluxDB>(std::move(transports), batchSize);
+    }
+
+    std::unique_ptr<ReplicatedInfluxDB> InfluxDBFactory::GetReplicated(const std::vector<std::string>& urls, std::size_t batchSize)
+    {
+        std::vector<std::unique_ptr<Transport>> transports;
+        transports.reserve(urls.size());
+
+        for (const auto& url : urls)
+        {
+            transports.push_back(InfluxDBFactory::GetTransport(url));
+        }
+        return std::make_unique<ReplicatedInfluxDB>(std::move(transports), batchSize);
+    }
+
 } // namespace influxdb
@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include "LineProtocol.h"
+#include "Escape.h"
 
 namespace influxdb
 {
@@ -46,7 +47,7 @@ namespace influxdb
 
     std::string LineProtocol::format(const Point& point) const
     {
-        std::string line{point.getName()};
+        std::string line{internal::escape(point.getName(), internal::EscapeContext::Measurement)};
         appendIfNotEmpty(line, globalTags, ',');
         appendIfNotEmpty(line, point.getTags(), ',');
         appendIfNotEmpty(line, point.getFields(), ' ');
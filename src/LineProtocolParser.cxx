@@ -0,0 +1,454 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LineProtocolParser.h"
+#include "InfluxDBException.h"
+#include "CharSearch.h"
+#include "Escape.h"
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+
+namespace influxdb
+{
+    namespace
+    {
+        using internal::CharSet;
+        using internal::EscapeContext;
+        using internal::findFirstOf;
+
+        constexpr auto npos = std::string_view::npos;
+
+        constexpr CharSet measurementEnd{',', ' ', '\\', '\\'};
+        constexpr CharSet keyEnd{'=', ',', ' ', '\\'};
+        constexpr CharSet tagValueEnd{',', ' ', '\\', '\\'};
+        constexpr CharSet fieldValueEnd{',', ' ', ',', ','};
+        constexpr CharSet stringValueEnd{'"', '\\', '"', '"'};
+        constexpr CharSet tagEnd{',', '\\', ',', ','};
+        constexpr CharSet pairSeparator{'=', '\\', '=', '='};
+
+        enum class FieldType
+        {
+            Float,
+            Integer,
+            UnsignedInteger,
+            String,
+            Boolean
+        };
+
+        /// Returns the position of the first character of set at or after pos not preceded by a backslash
+        std::size_t findUnescaped(std::string_view line, const CharSet& set, std::size_t pos)
+        {
+            pos = findFirstOf(line, set, pos);
+
+            while (pos != npos && line[pos] == '\\')
+            {
+                pos = findFirstOf(line, set, pos + 2);
+            }
+            return pos;
+        }
+
+        bool isDigit(char c)
+        {
+            return c >= '0' && c <= '9';
+        }
+
+        std::size_t skipDigits(std::string_view value, std::size_t pos)
+        {
+            while (pos < value.size() && isDigit(value[pos]))
+            {
+                ++pos;
+            }
+            return pos;
+        }
+
+        bool isFloat(std::string_view value)
+        {
+            std::size_t pos{0};
+
+            if (pos < value.size() && (value[pos] == '-' || value[pos] == '+'))
+            {
+                ++pos;
+            }
+
+            const std::size_t integerEnd = skipDigits(value, pos);
+            std::size_t digits = integerEnd - pos;
+            pos = integerEnd;
+
+            if (pos < value.size() && value[pos] == '.')
+            {
+                const std::size_t fractionEnd = skipDigits(value, pos + 1);
+                digits += fractionEnd - pos - 1;
+                pos = fractionEnd;
+            }
+
+            if (digits == 0)
+            {
+                return false;
+            }
+
+            if (pos < value.size() && (value[pos] == 'e' || value[pos] == 'E'))
+            {
+                ++pos;
+
+                if (pos < value.size() && (value[pos] == '-' || value[pos] == '+'))
+                {
+                    ++pos;
+                }
+
+                const std::size_t exponentEnd = skipDigits(value, pos);
+
+                if (exponentEnd == pos)
+                {
+                    return false;
+                }
+                pos = exponentEnd;
+            }
+            return pos == value.size();
+        }
+
+        template <class T>
+        bool parseInteger(std::string_view value, T& result)
+        {
+            const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+            return error == std::errc{} && end == value.data() + value.size();
+        }
+
+        std::optional<bool> parseBoolean(std::string_view value)
+        {
+            if (value == "t" || value == "T" || value == "true" || value == "True" || value == "TRUE")
+            {
+                return true;
+            }
+            if (value == "f" || value == "F" || value == "false" || value == "False" || value == "FALSE")
+            {
+                return false;
+            }
+            return std::nullopt;
+        }
+
+        std::optional<FieldType> fieldTypeOf(std::string_view value)
+        {
+            if (value.empty())
+            {
+                return std::nullopt;
+            }
+
+            if (value.size() >= 2 && value.front() == '"' && value.back() == '"')
+            {
+                return FieldType::String;
+            }
+
+            const std::string_view number = value.substr(0, value.size() - 1);
+
+            switch (value.back())
+            {
+                case 'i':
+                {
+                    long long integer{};
+                    return parseInteger(number, integer) ? std::optional{FieldType::Integer} : std::nullopt;
+                }
+                case 'u':
+                {
+                    unsigned long long integer{};
+                    return parseInteger(number, integer) ? std::optional{FieldType::UnsignedInteger} : std::nullopt;
+                }
+                default:
+                    break;
+            }
+
+            if (parseBoolean(value))
+            {
+                return FieldType::Boolean;
+            }
+            return isFloat(value) ? std::optional{FieldType::Float} : std::nullopt;
+        }
+
+        Point::FieldValue toFieldValue(std::string_view value)
+        {
+            const std::string_view number = value.substr(0, value.size() - 1);
+
+            switch (*fieldTypeOf(value))
+            {
+                case FieldType::String:
+                    return internal::unescape(value.substr(1, value.size() - 2), EscapeContext::StringValue);
+                case FieldType::Integer:
+                {
+                    long long integer{};
+                    parseInteger(number, integer);
+                    return integer;
+                }
+                case FieldType::UnsignedInteger:
+                {
+                    unsigned long long integer{};
+                    parseInteger(number, integer);
+                    return integer;
+                }
+                case FieldType::Boolean:
+                    return *parseBoolean(value);
+                case FieldType::Float:
+                    break;
+            }
+            return std::strtod(std::string{value}.c_str(), nullptr);
+        }
+
+        /// Splits line into view, returns the reason if the line is malformed
+        const char* parse(std::string_view line, std::string_view& measurement, std::string_view& tags,
+                          std::string_view& fields, std::optional<std::int64_t>& timestamp)
+        {
+            std::size_t pos = findUnescaped(line, measurementEnd, 0);
+
+            if (pos == 0)
+            {
+                return "missing measurement";
+            }
+            if (pos == npos)
+            {
+                return "missing fields";
+            }
+            measurement = line.substr(0, pos);
+
+            if (line[pos] == ',')
+            {
+                const std::size_t tagsBegin = pos + 1;
+
+                do
+                {
+                    const std::size_t keyBegin = pos + 1;
+                    pos = findUnescaped(line, keyEnd, keyBegin);
+
+                    if (pos == npos || line[pos] != '=')
+                    {
+                        return "tag without value";
+                    }
+                    if (pos == keyBegin)
+                    {
+                        return "missing tag key";
+                    }
+
+                    const std::size_t valueBegin = pos + 1;
+                    pos = findUnescaped(line, tagValueEnd, valueBegin);
+
+                    if (pos == npos)
+                    {
+                        return "missing fields";
+                    }
+                    if (pos == valueBegin)
+                    {
+                        return "missing tag value";
+                    }
+                } while (line[pos] == ',');
+
+                tags = line.substr(tagsBegin, pos - tagsBegin);
+            }
+
+            const std::size_t fieldsBegin = pos + 1;
+
+            do
+            {
+                const std::size_t keyBegin = pos + 1;
+                pos = findUnescaped(line, keyEnd, keyBegin);
+
+                if (pos == npos || line[pos] != '=')
+                {
+                    return "field without value";
+                }
+                if (pos == keyBegin)
+                {
+                    return "missing field key";
+                }
+
+                const std::size_t valueBegin = pos + 1;
+
+                if (valueBegin < line.size() && line[valueBegin] == '"')
+                {
+                    pos = findUnescaped(line, stringValueEnd, valueBegin + 1);
+
+                    if (pos == npos)
+                    {
+                        return "unterminated string field";
+                    }
+                    ++pos;
+
+                    if (pos < line.size() && line[pos] != ',' && line[pos] != ' ')
+                    {
+                        return "unexpected character after string field";
+                    }
+                }
+                else
+                {
+                    pos = std::min(findFirstOf(line, fieldValueEnd, valueBegin), line.size());
+
+                    if (!fieldTypeOf(line.substr(valueBegin, pos - valueBegin)))
+                    {
+                        return "invalid field value";
+                    }
+                }
+            } while (pos < line.size() && line[pos] == ',');
+
+            fields = line.substr(fieldsBegin, pos - fieldsBegin);
+
+            if (pos < line.size())
+            {
+                const std::string_view value = line.substr(pos + 1);
+                std::int64_t result{};
+
+                if (value.empty() || !parseInteger(value, result))
+                {
+                    return "invalid timestamp";
+                }
+                timestamp = result;
+            }
+            return nullptr;
+        }
+    }
+
+
+    std::string_view PointView::measurement() const
+    {
+        return mMeasurement;
+    }
+
+    std::string_view PointView::tags() const
+    {
+        return mTags;
+    }
+
+    std::string_view PointView::fields() const
+    {
+        return mFields;
+    }
+
+    std::optional<std::int64_t> PointView::timestamp() const
+    {
+        return mTimestamp;
+    }
+
+    std::string_view PointView::line() const
+    {
+        return mLine;
+    }
+
+    Point PointView::toPoint() const
+    {
+        Point point{internal::unescape(mMeasurement, EscapeContext::Measurement)};
+
+        forEachTag([&point](std::string_view key, std::string_view value)
+                   { point.addTag(internal::unescape(key, EscapeContext::Key), internal::unescape(value, EscapeContext::Key)); });
+        forEachField([&point](std::string_view key, std::string_view value)
+                     { point.addField(internal::unescape(key, EscapeContext::Key), toFieldValue(value)); });
+
+        if (mTimestamp)
+        {
+            using namespace std::chrono;
+            point.setTimestamp(system_clock::time_point{duration_cast<system_clock::duration>(nanoseconds{*mTimestamp})});
+        }
+        return point;
+    }
+
+    std::optional<std::pair<std::string_view, std::string_view>> PointView::nextPair(std::string_view elements, std::size_t& pos, bool fields)
+    {
+        if (pos >= elements.size())
+        {
+            return std::nullopt;
+        }
+
+        const std::size_t separator = findUnescaped(elements, pairSeparator, pos);
+        const std::size_t valueBegin = separator + 1;
+        std::size_t valueEnd{};
+
+        if (!fields)
+        {
+            valueEnd = findUnescaped(elements, tagEnd, valueBegin);
+        }
+        else if (elements[valueBegin] == '"')
+        {
+            valueEnd = findUnescaped(elements, stringValueEnd, valueBegin + 1) + 1;
+        }
+        else
+        {
+            valueEnd = findFirstOf(elements, fieldValueEnd, valueBegin);
+        }
+        valueEnd = std::min(valueEnd, elements.size());
+
+        const std::string_view key = elements.substr(pos, separator - pos);
+        const std::string_view value = elements.substr(valueBegin, valueEnd - valueBegin);
+        pos = valueEnd + 1;
+        return std::pair{key, value};
+    }
+
+
+    LineProtocolParser::LineProtocolParser(std::string_view input)
+        : mInput(input), mPosition(0), mLineNumber(0)
+    {
+    }
+
+    std::optional<PointView> LineProtocolParser::next()
+    {
+        while (mPosition < mInput.size())
+        {
+            const std::size_t end = std::min(mInput.find('\n', mPosition), mInput.size());
+            std::string_view line = mInput.substr(mPosition, end - mPosition);
+            mPosition = end + 1;
+            ++mLineNumber;
+
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.remove_suffix(1);
+            }
+
+            if (line.empty() || line.front() == '#')
+            {
+                continue;
+            }
+
+            PointView view;
+            view.mLine = line;
+
+            if (const char* error = parse(line, view.mMeasurement, view.mTags, view.mFields, view.mTimestamp); error != nullptr)
+            {
+                throw InfluxDBException{"Line " + std::to_string(mLineNumber) + ": " + error};
+            }
+            return view;
+        }
+        return std::nullopt;
+    }
+
+    std::size_t LineProtocolParser::lineNumber() const
+    {
+        return mLineNumber;
+    }
+
+    PointView LineProtocolParser::parseLine(std::string_view line)
+    {
+        PointView view;
+        view.mLine = line;
+
+        if (const char* error = parse(line, view.mMeasurement, view.mTags, view.mFields, view.mTimestamp); error != nullptr)
+        {
+            throw InfluxDBException{error};
+        }
+        return view;
+    }
+}
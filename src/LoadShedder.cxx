@@ -0,0 +1,125 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LoadShedder.h"
+#include "InfluxDBException.h"
+#include "SeriesHash.h"
+#include <algorithm>
+
+namespace influxdb
+{
+    namespace
+    {
+        /// Weight of the latest send in the smoothed latency
+        constexpr double smoothing{0.2};
+
+        /// Consecutive fast sends required to halve the sampling factor
+        constexpr std::uint64_t recoverySends{10};
+    }
+
+
+    LoadShedder::LoadShedder(std::chrono::milliseconds latencyThreshold, std::uint64_t maxSamplingFactor, std::string_view markerField)
+        : mLatencyThreshold(latencyThreshold),
+          mMaxSamplingFactor(maxSamplingFactor),
+          mMarkerField(markerField),
+          mSamplingFactor(1),
+          mSmoothedLatency(0.0),
+          mHealthySends(0),
+          mDropped(0),
+          mSeriesCounters{}
+    {
+        if (latencyThreshold.count() <= 0 || maxSamplingFactor == 0)
+        {
+            throw InfluxDBException{"Load shedding requires a positive latency threshold and sampling factor"};
+        }
+    }
+
+    bool LoadShedder::admit(Point& point)
+    {
+        if (mSamplingFactor == 1)
+        {
+            return true;
+        }
+
+        if (mSeriesCounters.size() >= maxSeries)
+        {
+            mSeriesCounters.clear();
+        }
+
+        if (mSeriesCounters[internal::seriesHashOf(point)]++ % mSamplingFactor != 0)
+        {
+            ++mDropped;
+            return false;
+        }
+        if (mMarkerField.empty())
+        {
+            return true;
+        }
+
+        bool marked{false};
+        point.forEachField([this, &marked](std::string_view name, const auto&)
+                           { marked = marked || name == mMarkerField; });
+
+        if (!marked)
+        {
+            point.addField(mMarkerField, static_cast<long long int>(mSamplingFactor));
+        }
+        return true;
+    }
+
+    void LoadShedder::update(std::chrono::nanoseconds latency, bool failed)
+    {
+        mSmoothedLatency += smoothing * (static_cast<double>(latency.count()) - mSmoothedLatency);
+        const auto threshold = static_cast<double>(mLatencyThreshold.count());
+
+        if (failed || mSmoothedLatency > threshold)
+        {
+            mSamplingFactor = std::min(mSamplingFactor * 2, mMaxSamplingFactor);
+            mHealthySends = 0;
+        }
+        else if (mSmoothedLatency >= threshold / 2)
+        {
+            mHealthySends = 0;
+        }
+        else if (mSamplingFactor > 1 && ++mHealthySends >= recoverySends)
+        {
+            mSamplingFactor /= 2;
+            mHealthySends = 0;
+
+            if (mSamplingFactor == 1)
+            {
+                mSeriesCounters.clear();
+            }
+        }
+    }
+
+    std::uint64_t LoadShedder::samplingFactor() const
+    {
+        return mSamplingFactor;
+    }
+
+    std::uint64_t LoadShedder::dropped() const
+    {
+        return mDropped;
+    }
+
+} // namespace influxdb
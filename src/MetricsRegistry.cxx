@@ -0,0 +1,216 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MetricsRegistry.h"
+#include "InfluxDBException.h"
+#include <algorithm>
+
+namespace influxdb
+{
+    namespace
+    {
+        MetricsRegistry::Tags sorted(const MetricsRegistry::Tags& tags)
+        {
+            auto result = tags;
+            std::sort(result.begin(), result.end());
+            return result;
+        }
+
+        std::string keyOf(std::string_view name, const MetricsRegistry::Tags& sortedTags)
+        {
+            std::string key{name};
+            for (const auto& [tagKey, tagValue] : sortedTags)
+            {
+                key.append(1, '\0').append(tagKey).append(1, '\0').append(tagValue);
+            }
+            return key;
+        }
+
+        template <class Entry>
+        Point pointOf(const Entry& entry, std::chrono::time_point<std::chrono::system_clock> timestamp)
+        {
+            Point point{entry.name};
+            for (const auto& [key, value] : entry.tags)
+            {
+                point.addTag(key, value);
+            }
+            return std::move(point.setTimestamp(timestamp));
+        }
+    }
+
+
+    std::int64_t Counter::value() const noexcept
+    {
+        std::int64_t sum{0};
+        for (const auto& cell : mCells)
+        {
+            sum += cell.value.load(std::memory_order_relaxed);
+        }
+        return sum;
+    }
+
+    void Gauge::add(double delta) noexcept
+    {
+        double current = mValue.load(std::memory_order_relaxed);
+        while (!mValue.compare_exchange_weak(current, current + delta, std::memory_order_relaxed))
+        {
+        }
+    }
+
+
+    MetricsRegistry::MetricsRegistry(InfluxDB& db, std::chrono::milliseconds interval)
+        : mDb(db), mInterval(interval), mCounters{}, mGauges{}, mHistograms{}, mStatistics{0, 0, 0}, mStopping(false), mScheduler{}
+    {
+        if (interval.count() <= 0)
+        {
+            throw InfluxDBException{"Metrics interval must be positive"};
+        }
+        mScheduler = std::thread{&MetricsRegistry::run, this};
+    }
+
+    MetricsRegistry::~MetricsRegistry()
+    {
+        {
+            std::lock_guard lock{mSchedulerMutex};
+            mStopping = true;
+        }
+        mStopCondition.notify_all();
+        mScheduler.join();
+
+        try
+        {
+            flush();
+        }
+        catch (const std::exception&)
+        {
+            // Already counted as failure
+        }
+    }
+
+    Counter& MetricsRegistry::counter(std::string_view name, const Tags& tags)
+    {
+        return find(mCounters, name, tags);
+    }
+
+    Gauge& MetricsRegistry::gauge(std::string_view name, const Tags& tags)
+    {
+        return find(mGauges, name, tags);
+    }
+
+    Histogram& MetricsRegistry::histogram(std::string_view name, const Tags& tags)
+    {
+        return find(mHistograms, name, tags);
+    }
+
+    void MetricsRegistry::flush()
+    {
+        std::lock_guard lock{mFlushMutex};
+        auto points = snapshot();
+
+        if (points.empty())
+        {
+            return;
+        }
+
+        const auto count = points.size();
+        try
+        {
+            mDb.write(std::move(points));
+            mDb.flushBatch();
+        }
+        catch (const std::exception&)
+        {
+            ++mStatistics.failures;
+            throw;
+        }
+        ++mStatistics.flushes;
+        mStatistics.points += count;
+    }
+
+    MetricsRegistry::Statistics MetricsRegistry::statistics() const
+    {
+        std::lock_guard lock{mFlushMutex};
+        return mStatistics;
+    }
+
+    template <class Metric>
+    Metric& MetricsRegistry::find(Metrics<Metric>& metrics, std::string_view name, const Tags& tags)
+    {
+        auto sortedTags = sorted(tags);
+        auto key = keyOf(name, sortedTags);
+
+        std::lock_guard lock{mMetricsMutex};
+        auto itr = metrics.find(key);
+
+        if (itr == metrics.end())
+        {
+            itr = metrics.emplace(std::move(key), Entry<Metric>{std::string{name}, std::move(sortedTags), std::make_unique<Metric>()}).first;
+        }
+        return *itr->second.metric;
+    }
+
+    std::vector<Point> MetricsRegistry::snapshot()
+    {
+        const auto timestamp = std::chrono::system_clock::now();
+        std::vector<Point> points;
+
+        std::lock_guard lock{mMetricsMutex};
+        points.reserve(mCounters.size() + mGauges.size() + mHistograms.size());
+
+        for (const auto& [key, entry] : mCounters)
+        {
+            points.push_back(pointOf(entry, timestamp).addField("value", static_cast<long long int>(entry.metric->value())));
+        }
+        for (const auto& [key, entry] : mGauges)
+        {
+            points.push_back(pointOf(entry, timestamp).addField("value", entry.metric->value()));
+        }
+        for (const auto& [key, entry] : mHistograms)
+        {
+            points.push_back(entry.metric->collect().addFields(pointOf(entry, timestamp)));
+        }
+        return points;
+    }
+
+    void MetricsRegistry::run()
+    {
+        std::unique_lock lock{mSchedulerMutex};
+        auto next = std::chrono::steady_clock::now() + mInterval;
+
+        while (!mStopCondition.wait_until(lock, next, [this]
+                                          { return mStopping; }))
+        {
+            next += mInterval;
+            lock.unlock();
+            try
+            {
+                flush();
+            }
+            catch (const std::exception&)
+            {
+                // Counted as failure, retried with the next snapshot
+            }
+            lock.lock();
+        }
+    }
+
+} // namespace influxdb
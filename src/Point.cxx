@@ -27,6 +27,7 @@
 
 #include "Point.h"
 #include "LineProtocol.h"
+#include "Escape.h"
 #include <chrono>
 #include <memory>
 #include <sstream>
@@ -43,8 +44,45 @@ namespace influxdb
     template <class... Ts>
     overloaded(Ts...) -> overloaded<Ts...>;
 
+    namespace
+    {
+        using TagString = std::variant<std::pmr::string, std::string_view>;
+        using FieldStorage = std::variant<int, long long int, std::pmr::string, double, bool, unsigned int, unsigned long long int>;
+
+        TagString internOrCopy(std::string_view value, StringPool& pool, std::pmr::memory_resource* resource)
+        {
+            if (const auto interned = pool.intern(value); interned.has_value())
+            {
+                return *interned;
+            }
+            return TagString{std::in_place_type<std::pmr::string>, value, resource};
+        }
+
+        FieldStorage toStorage(const Point::FieldValue& value, std::pmr::memory_resource* resource)
+        {
+            return std::visit([resource](const auto& v)
+                              {
+                                  using T = std::decay_t<decltype(v)>;
+
+                                  if constexpr (std::is_same_v<T, std::string>)
+                                  {
+                                      return FieldStorage{std::in_place_type<std::pmr::string>, v, resource};
+                                  }
+                                  else
+                                  {
+                                      return FieldStorage{std::in_place_type<T>, v};
+                                  } },
+                              value);
+        }
+    }
+
     Point::Point(const std::string& measurement)
-        : mMeasurement(measurement), mTimestamp(std::chrono::system_clock::now()), mTags({}), mFields({})
+        : Point(measurement, std::pmr::get_default_resource())
+    {
+    }
+
+    Point::Point(const std::string& measurement, std::pmr::memory_resource* resource)
+        : mMeasurement(measurement, resource), mTimestamp(std::chrono::system_clock::now()), mTags{resource}, mFields{resource}
     {
     }
 
@@ -55,7 +93,9 @@ namespace influxdb
             return std::move(*this);
         }
 
-        mFields.emplace_back(std::make_pair(name, value));
+        mFields.emplace_back(std::piecewise_construct,
+                             std::forward_as_tuple(name),
+                             std::forward_as_tuple(toStorage(value, mFields.get_allocator().resource())));
         return std::move(*this);
     }
 
@@ -66,7 +106,21 @@ namespace influxdb
             return std::move(*this);
         }
 
-        mTags.emplace_back(std::make_pair(key, value));
+        auto* resource = mTags.get_allocator().resource();
+        mTags.emplace_back(TagString{std::in_place_type<std::pmr::string>, key, resource},
+                           TagString{std::in_place_type<std::pmr::string>, value, resource});
+        return std::move(*this);
+    }
+
+    Point&& Point::addTag(std::string_view key, std::string_view value, StringPool& pool)
+    {
+        if (key.empty() || value.empty())
+        {
+            return std::move(*this);
+        }
+
+        auto* resource = mTags.get_allocator().resource();
+        mTags.emplace_back(internOrCopy(key, pool, resource), internOrCopy(value, pool, resource));
         return std::move(*this);
     }
 
@@ -88,6 +142,11 @@ namespace influxdb
     }
 
     std::string Point::getName() const
+    {
+        return std::string{mMeasurement};
+    }
+
+    std::string_view Point::getNameView() const
     {
         return mMeasurement;
     }
@@ -109,7 +168,7 @@ namespace influxdb
                 convert << ',';
             }
 
-            convert << field.first << "=";
+            convert << internal::escape(field.first, internal::EscapeContext::Key) << "=";
             std::visit(overloaded{
                            [&convert](int v)
                            { convert << v << 'i'; },
@@ -117,8 +176,8 @@ namespace influxdb
                            { convert << v << 'i'; },
                            [&convert](double v)
                            { convert << v; },
-                           [&convert](const std::string& v)
-                           { convert << '"' << v << '"'; },
+                           [&convert](const std::pmr::string& v)
+                           { convert << '"' << internal::escape(v, internal::EscapeContext::StringValue) << '"'; },
                            [&convert](bool v)
                            { convert << (v ? "true" : "false"); },
                            [&convert](unsigned int v)
@@ -144,9 +203,9 @@ namespace influxdb
         for (const auto& tag : mTags)
         {
             tags += ",";
-            tags += tag.first;
+            internal::appendEscaped(tags, toView(tag.first), internal::EscapeContext::Key);
             tags += "=";
-            tags += tag.second;
+            internal::appendEscaped(tags, toView(tag.second), internal::EscapeContext::Key);
         }
 
         return tags.substr(1, tags.size());
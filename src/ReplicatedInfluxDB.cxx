@@ -0,0 +1,216 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ReplicatedInfluxDB.h"
+#include "InfluxDBException.h"
+#include "LineProtocol.h"
+#include <utility>
+
+namespace influxdb
+{
+    ReplicatedInfluxDB::Replica::Replica(std::unique_ptr<Transport> transport_)
+        : transport(std::move(transport_)), queue(), sending(false), stopping(false), statistics{0, 0, 0, 0, 0}, sender()
+    {
+    }
+
+    ReplicatedInfluxDB::ReplicatedInfluxDB(std::vector<std::unique_ptr<Transport>> transports, std::size_t batchSize,
+                                           std::size_t maxQueuedBatches, std::size_t retries, std::chrono::milliseconds retryDelay)
+        : mBatchSize(batchSize), mMaxQueuedBatches(maxQueuedBatches), mRetries(retries), mRetryDelay(retryDelay), mBatch(), mReplicas()
+    {
+        if (transports.empty() || batchSize == 0 || maxQueuedBatches == 0)
+        {
+            throw InfluxDBException{"Replication requires at least one transport, a positive batch size and queue"};
+        }
+
+        mBatch.reserve(batchSize);
+
+        for (auto& transport : transports)
+        {
+            mReplicas.push_back(std::make_unique<Replica>(std::move(transport)));
+        }
+
+        for (auto& replica : mReplicas)
+        {
+            replica->sender = std::thread{[this, &replica = *replica]
+                                          { send(replica); }};
+        }
+    }
+
+    ReplicatedInfluxDB::~ReplicatedInfluxDB()
+    {
+        seal();
+
+        for (auto& replica : mReplicas)
+        {
+            {
+                std::lock_guard lock{replica->mutex};
+                replica->stopping = true;
+            }
+            replica->wake.notify_one();
+        }
+
+        for (auto& replica : mReplicas)
+        {
+            replica->sender.join();
+        }
+    }
+
+    void ReplicatedInfluxDB::write(Point&& point)
+    {
+        mBatch.push_back(std::move(point));
+
+        if (mBatch.size() >= mBatchSize)
+        {
+            seal();
+        }
+    }
+
+    void ReplicatedInfluxDB::write(std::vector<Point>&& points)
+    {
+        for (auto&& point : points)
+        {
+            write(std::move(point));
+        }
+    }
+
+    void ReplicatedInfluxDB::flushBatch()
+    {
+        seal();
+
+        for (auto& replica : mReplicas)
+        {
+            std::unique_lock lock{replica->mutex};
+            replica->idle.wait(lock, [&replica]
+                               { return replica->queue.empty() && !replica->sending; });
+        }
+    }
+
+    std::size_t ReplicatedInfluxDB::replicaCount() const
+    {
+        return mReplicas.size();
+    }
+
+    ReplicatedInfluxDB::ReplicaStatistics ReplicatedInfluxDB::statistics(std::size_t replica) const
+    {
+        const Replica& selected = *mReplicas.at(replica);
+        std::lock_guard lock{selected.mutex};
+        ReplicaStatistics statistics = selected.statistics;
+        statistics.queued = selected.queue.size();
+        return statistics;
+    }
+
+    void ReplicatedInfluxDB::seal()
+    {
+        if (mBatch.empty())
+        {
+            return;
+        }
+
+        const LineProtocol formatter;
+        std::string joined;
+
+        for (const auto& point : mBatch)
+        {
+            joined += formatter.format(point);
+            joined += '\n';
+        }
+        joined.pop_back();
+        mBatch.clear();
+
+        const Message message = std::make_shared<const std::string>(std::move(joined));
+
+        for (auto& replica : mReplicas)
+        {
+            {
+                std::lock_guard lock{replica->mutex};
+
+                if (replica->queue.size() >= mMaxQueuedBatches)
+                {
+                    replica->queue.pop_front();
+                    ++replica->statistics.dropped;
+                }
+                replica->queue.push_back(message);
+            }
+            replica->wake.notify_one();
+        }
+    }
+
+    void ReplicatedInfluxDB::send(Replica& replica)
+    {
+        std::unique_lock lock{replica.mutex};
+
+        while (true)
+        {
+            replica.wake.wait(lock, [&replica]
+                              { return !replica.queue.empty() || replica.stopping; });
+
+            if (replica.queue.empty())
+            {
+                return;
+            }
+
+            const Message message = std::move(replica.queue.front());
+            replica.queue.pop_front();
+            replica.sending = true;
+            lock.unlock();
+
+            const bool sent = sendWithRetries(replica, message);
+
+            lock.lock();
+            replica.sending = false;
+            ++(sent ? replica.statistics.sent : replica.statistics.failed);
+
+            if (replica.queue.empty())
+            {
+                replica.idle.notify_all();
+            }
+        }
+    }
+
+    bool ReplicatedInfluxDB::sendWithRetries(Replica& replica, const Message& message)
+    {
+        auto delay = mRetryDelay;
+
+        for (std::size_t attempt = 0;; ++attempt)
+        {
+            try
+            {
+                replica.transport->sendShared(message);
+                return true;
+            }
+            catch (const std::exception&)
+            {
+                std::unique_lock lock{replica.mutex};
+
+                if (attempt >= mRetries || replica.stopping)
+                {
+                    return false;
+                }
+
+                ++replica.statistics.retries;
+                replica.wake.wait_for(lock, delay, [&replica]
+                                      { return replica.stopping; });
+                delay *= 2;
+            }
+        }
+    }
+}
@@ -0,0 +1,116 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "InfluxDBException.h"
+#include "TransportCounters.h"
+#include <atomic>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <boost/asio.hpp>
+
+namespace influxdb::internal
+{
+    /// \brief Messages written one at a time by asynchronous operations of a socket
+    ///
+    /// The socket is expected to run on a strand of an io_context run by the application,
+    /// so completions are serialized with the messages pushed from any thread. Handlers
+    /// share ownership: queued messages are still sent after the transport is destroyed.
+    template <class Socket>
+    class SendQueue : public std::enable_shared_from_this<SendQueue<Socket>>
+    {
+    public:
+        using Message = std::shared_ptr<const std::string>;
+        using Completion = std::function<void(const boost::system::error_code&, std::size_t)>;
+
+        /// Starts writing message, which stays alive until completion is called
+        using Write = std::function<void(Socket& socket, const std::string& message, Completion completion)>;
+
+        static inline constexpr std::size_t defaultMaxPending{1024};
+
+        SendQueue(Socket socket, Write write, std::shared_ptr<TransportCounters> counters, std::size_t maxPending = defaultMaxPending)
+            : mSocket(std::move(socket)), mWrite(std::move(write)), mCounters(std::move(counters)), mMaxPending(maxPending), mPending(0), mQueue()
+        {
+        }
+
+        /// Queues message, safe to call from any thread
+        /// \throw InfluxDBException   if maxPending messages are waiting already
+        void push(Message message)
+        {
+            if (mPending.fetch_add(1, std::memory_order_relaxed) >= mMaxPending)
+            {
+                mPending.fetch_sub(1, std::memory_order_relaxed);
+                mCounters->networkError();
+                throw InfluxDBException{"Send queue is full"};
+            }
+
+            boost::asio::post(mSocket.get_executor(), [self = this->shared_from_this(), message = std::move(message)]() mutable
+                              {
+                                  self->mQueue.push_back(std::move(message));
+
+                                  if (self->mQueue.size() == 1)
+                                  {
+                                      self->writeFront();
+                                  }
+                              });
+        }
+
+    private:
+        void writeFront()
+        {
+            mWrite(mSocket, *mQueue.front(), [self = this->shared_from_this()](const boost::system::error_code& error, std::size_t bytes)
+                   { self->written(error, bytes); });
+        }
+
+        void written(const boost::system::error_code& error, std::size_t bytes)
+        {
+            mQueue.pop_front();
+            mPending.fetch_sub(1, std::memory_order_relaxed);
+
+            if (error)
+            {
+                mCounters->networkError();
+            }
+            else
+            {
+                mCounters->sent(bytes);
+            }
+
+            if (!mQueue.empty())
+            {
+                writeFront();
+            }
+        }
+
+        Socket mSocket;
+        Write mWrite;
+        std::shared_ptr<TransportCounters> mCounters;
+        const std::size_t mMaxPending;
+        std::atomic<std::size_t> mPending;
+        std::deque<Message> mQueue;
+    };
+}
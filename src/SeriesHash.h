@@ -0,0 +1,65 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Point.h"
+#include "SmallVector.h"
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+
+namespace influxdb::internal
+{
+    /// 64 bit FNV-1a of data, continuing from hash
+    constexpr std::uint64_t fnv1a(std::string_view data, std::uint64_t hash = 14695981039346656037ULL)
+    {
+        for (const char c : data)
+        {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    /// Hash of the measurement and tag set of point, independent of tag order and the
+    /// same across builds and platforms (FNV-1a over measurement and sorted tags)
+    inline std::uint64_t seriesHashOf(const Point& point)
+    {
+        detail::SmallVector<std::pair<std::string_view, std::string_view>, 8> tags;
+        point.forEachTag([&tags](std::string_view key, std::string_view value)
+                         { tags.emplace_back(key, value); });
+        std::sort(tags.begin(), tags.end());
+
+        // Parts are terminated by a zero byte, so moving characters between them changes the hash
+        constexpr std::string_view separator{"\0", 1};
+        std::uint64_t hash = fnv1a(separator, fnv1a(point.getNameView()));
+
+        for (const auto& [key, value] : tags)
+        {
+            hash = fnv1a(separator, fnv1a(key, hash));
+            hash = fnv1a(separator, fnv1a(value, hash));
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,266 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ShardedInfluxDB.h"
+#include "InfluxDBException.h"
+#include "SeriesHash.h"
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <utility>
+
+namespace influxdb
+{
+    namespace
+    {
+        /// Batches a shard queues before write() blocks
+        constexpr std::size_t queuedBatches{4};
+        constexpr std::chrono::milliseconds retryDelay{100};
+        constexpr std::chrono::milliseconds maxRetryDelay{5000};
+
+        /// Jump consistent hash (Lamping, Veach), maps key to one of buckets
+        std::size_t jumpHash(std::uint64_t key, std::size_t buckets)
+        {
+            std::int64_t bucket{-1};
+            std::int64_t next{0};
+
+            while (next < static_cast<std::int64_t>(buckets))
+            {
+                bucket = next;
+                key = key * 2862933555777941757ULL + 1;
+                next = static_cast<std::int64_t>(static_cast<double>(bucket + 1) * (static_cast<double>(1LL << 31) / static_cast<double>((key >> 33) + 1)));
+            }
+            return static_cast<std::size_t>(bucket);
+        }
+    }
+
+
+    ShardedInfluxDB::Shard::Shard(std::unique_ptr<Transport> transport, std::size_t batchSize)
+        : db(std::move(transport)), queue(), flushRequested(0), flushCompleted(0), stopping(false), error(), dropped(0), sender()
+    {
+        db.batchOf(batchSize);
+        db.setDiscardFailedBatches(true);
+        queue.reserve(batchSize * queuedBatches);
+    }
+
+    ShardedInfluxDB::ShardedInfluxDB(std::vector<std::unique_ptr<Transport>> transports, std::size_t batchSize)
+        : mBatchSize(batchSize), mShards()
+    {
+        if (transports.empty() || batchSize == 0)
+        {
+            throw InfluxDBException{"Sharding requires at least one transport and a positive batch size"};
+        }
+
+        for (auto& transport : transports)
+        {
+            mShards.push_back(std::make_unique<Shard>(std::move(transport), batchSize));
+        }
+
+        for (auto& shard : mShards)
+        {
+            shard->sender = std::thread{[this, &shard = *shard]
+                                        { send(shard); }};
+        }
+    }
+
+    ShardedInfluxDB::~ShardedInfluxDB()
+    {
+        for (auto& shard : mShards)
+        {
+            {
+                std::lock_guard lock{shard->mutex};
+                shard->stopping = true;
+            }
+            shard->wake.notify_one();
+        }
+
+        for (auto& shard : mShards)
+        {
+            shard->sender.join();
+        }
+    }
+
+    void ShardedInfluxDB::write(Point&& point)
+    {
+        enqueue(*mShards[shardOf(point)], std::move(point));
+    }
+
+    void ShardedInfluxDB::write(std::vector<Point>&& points)
+    {
+        for (auto&& point : points)
+        {
+            write(std::move(point));
+        }
+    }
+
+    void ShardedInfluxDB::flushBatch()
+    {
+        std::vector<std::uint64_t> tickets;
+        tickets.reserve(mShards.size());
+
+        for (auto& shard : mShards)
+        {
+            {
+                std::lock_guard lock{shard->mutex};
+                tickets.push_back(++shard->flushRequested);
+            }
+            shard->wake.notify_one();
+        }
+
+        std::exception_ptr error;
+
+        for (std::size_t i = 0; i < mShards.size(); ++i)
+        {
+            Shard& shard = *mShards[i];
+            std::unique_lock lock{shard.mutex};
+            shard.progress.wait(lock, [&shard, ticket = tickets[i]]
+                                { return shard.flushCompleted >= ticket; });
+
+            if (error == nullptr)
+            {
+                error = shard.error;
+            }
+            shard.error = nullptr;
+        }
+
+        if (error != nullptr)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::size_t ShardedInfluxDB::shardCount() const
+    {
+        return mShards.size();
+    }
+
+    std::size_t ShardedInfluxDB::shardOf(const Point& point) const
+    {
+        return jumpHash(internal::seriesHashOf(point), mShards.size());
+    }
+
+    InfluxDB::Statistics ShardedInfluxDB::stats(std::size_t shard) const
+    {
+        Shard& target = *mShards.at(shard);
+        auto statistics = target.db.stats();
+        std::lock_guard lock{target.mutex};
+        statistics.dropped += target.dropped;
+        return statistics;
+    }
+
+    void ShardedInfluxDB::enqueue(Shard& shard, Point&& point)
+    {
+        std::unique_lock lock{shard.mutex};
+        shard.progress.wait(lock, [this, &shard]
+                            { return shard.queue.size() < mBatchSize * queuedBatches; });
+        shard.queue.push_back(std::move(point));
+
+        if (shard.queue.size() % mBatchSize == 0)
+        {
+            lock.unlock();
+            shard.wake.notify_one();
+        }
+    }
+
+    void ShardedInfluxDB::send(Shard& shard)
+    {
+        std::vector<Point> points;
+        points.reserve(mBatchSize * queuedBatches);
+        auto delay = retryDelay;
+        std::unique_lock lock{shard.mutex};
+
+        while (true)
+        {
+            shard.wake.wait(lock, [this, &shard]
+                            { return shard.queue.size() >= mBatchSize || shard.flushRequested != shard.flushCompleted || shard.stopping; });
+
+            points.swap(shard.queue);
+            const auto ticket = shard.flushRequested;
+            const bool flush = ticket != shard.flushCompleted || shard.stopping;
+            lock.unlock();
+            shard.progress.notify_all();
+
+            // Points are added one at a time, so those after a failed flush are still ours
+            std::size_t added{0};
+            std::exception_ptr error;
+
+            try
+            {
+                for (; added < points.size(); ++added)
+                {
+                    shard.db.write(std::move(points[added]));
+                }
+
+                if (flush)
+                {
+                    shard.db.flushBatch();
+                }
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            lock.lock();
+
+            if (error != nullptr)
+            {
+                if (shard.error == nullptr)
+                {
+                    shard.error = error;
+                }
+
+                // The point being added when the flush failed is in the batch already
+                const auto unsent = std::next(points.begin(), static_cast<std::ptrdiff_t>(std::min(added + 1, points.size())));
+
+                if (shard.stopping)
+                {
+                    shard.dropped += static_cast<std::uint64_t>(std::distance(unsent, points.end()));
+                }
+                else
+                {
+                    shard.queue.insert(shard.queue.begin(), std::make_move_iterator(unsent), std::make_move_iterator(points.end()));
+                }
+            }
+            points.clear();
+            shard.flushCompleted = ticket;
+            shard.progress.notify_all();
+
+            if (shard.stopping && shard.queue.empty())
+            {
+                return;
+            }
+
+            if (error != nullptr)
+            {
+                // Backs off before retrying, unless a flush is requested or the client stops
+                shard.wake.wait_for(lock, delay, [&shard]
+                                    { return shard.flushRequested != shard.flushCompleted || shard.stopping; });
+                delay = std::min(delay * 2, maxRetryDelay);
+            }
+            else
+            {
+                delay = retryDelay;
+            }
+        }
+    }
+}
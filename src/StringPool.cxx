@@ -0,0 +1,74 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "StringPool.h"
+#include <functional>
+
+namespace influxdb
+{
+    StringPool::StringPool(std::size_t maxBytes)
+        : mMaxBytes(maxBytes), mShards{}, mUniqueStrings{0}, mStoredBytes{0}, mBytesSaved{0}, mRejected{0}
+    {
+    }
+
+    std::optional<std::string_view> StringPool::intern(std::string_view value)
+    {
+        const auto hash = std::hash<std::string_view>{}(value);
+        auto& shard = mShards[hash % shardCount];
+        std::lock_guard<std::mutex> lock{shard.mutex};
+
+        if (const auto existing = shard.index.find(value); existing != shard.index.end())
+        {
+            mBytesSaved.fetch_add(value.size(), std::memory_order_relaxed);
+            return *existing;
+        }
+
+        auto stored = mStoredBytes.load(std::memory_order_relaxed);
+        do
+        {
+            if (stored + value.size() > mMaxBytes)
+            {
+                mRejected.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+        } while (!mStoredBytes.compare_exchange_weak(stored, stored + value.size(), std::memory_order_relaxed));
+
+        // Deque elements keep their address, so do views to their characters
+        const std::string_view interned{shard.storage.emplace_back(value)};
+        shard.index.insert(interned);
+        mUniqueStrings.fetch_add(1, std::memory_order_relaxed);
+        return interned;
+    }
+
+    StringPool::Statistics StringPool::statistics() const
+    {
+        return {mUniqueStrings.load(std::memory_order_relaxed),
+                mStoredBytes.load(std::memory_order_relaxed),
+                mBytesSaved.load(std::memory_order_relaxed),
+                mRejected.load(std::memory_order_relaxed)};
+    }
+
+    std::size_t StringPool::maxBytes() const
+    {
+        return mMaxBytes;
+    }
+}
@@ -26,50 +26,142 @@
 
 #include "TCP.h"
 #include "InfluxDBException.h"
+#include <array>
 #include <string>
 
 namespace influxdb::transports
 {
     namespace ba = boost::asio;
 
+    namespace
+    {
+        using Queue = internal::SendQueue<ba::ip::tcp::socket>;
+
+        ba::ip::tcp::endpoint resolve(ba::io_context& context, const std::string& hostname, int port)
+        {
+            ba::ip::tcp::resolver resolver(context);
+            ba::ip::tcp::resolver::query query(hostname, std::to_string(port));
+            ba::ip::tcp::resolver::iterator resolverIterator = resolver.resolve(query);
+            return *resolverIterator;
+        }
+
+        void writeLine(ba::ip::tcp::socket& socket, const std::string& message, Queue::Completion completion)
+        {
+            static const char newline{'\n'};
+            const std::array<ba::const_buffer, 2> buffers{ba::buffer(message, message.size()), ba::buffer(&newline, 1)};
+
+            ba::async_write(socket, buffers, [&socket, completion = std::move(completion)](const boost::system::error_code& error, std::size_t bytes)
+                            {
+                                if (error)
+                                {
+                                    boost::system::error_code ignored;
+                                    socket.close(ignored);
+                                }
+                                completion(error, bytes);
+                            });
+        }
+
+        void connectAndWriteLine(ba::ip::tcp::socket& socket, const ba::ip::tcp::endpoint& endpoint, const std::string& message, Queue::Completion completion)
+        {
+            if (socket.is_open())
+            {
+                writeLine(socket, message, std::move(completion));
+                return;
+            }
+
+            socket.async_connect(endpoint, [&socket, &message, completion = std::move(completion)](const boost::system::error_code& error) mutable
+                                 {
+                                     if (error)
+                                     {
+                                         boost::system::error_code ignored;
+                                         socket.close(ignored);
+                                         completion(error, 0);
+                                         return;
+                                     }
+                                     writeLine(socket, message, std::move(completion));
+                                 });
+        }
+    }
+
     TCP::TCP(const std::string& hostname, int port)
-        : mSocket(mIoService)
+        : mIoService(std::make_unique<ba::io_service>()), mSocket(*mIoService), mEndpoint(resolve(*mIoService, hostname, port)), mCounters(std::make_shared<internal::TransportCounters>()), mQueue()
     {
-        ba::ip::tcp::resolver resolver(mIoService);
-        ba::ip::tcp::resolver::query query(hostname, std::to_string(port));
-        ba::ip::tcp::resolver::iterator resolverIterator = resolver.resolve(query);
-        ba::ip::tcp::resolver::iterator end;
-        mEndpoint = *resolverIterator;
         mSocket.open(mEndpoint.protocol());
         reconnect();
     }
 
+    TCP::TCP(ba::io_context& context, const std::string& hostname, int port)
+        : mIoService(), mSocket(ba::make_strand(context)), mEndpoint(resolve(context, hostname, port)), mCounters(std::make_shared<internal::TransportCounters>()), mQueue()
+    {
+        // Connects asynchronously on the first message
+        mQueue = std::make_shared<Queue>(
+            std::move(mSocket),
+            [endpoint = mEndpoint](ba::ip::tcp::socket& socket, const std::string& message, Queue::Completion completion)
+            { connectAndWriteLine(socket, endpoint, message, std::move(completion)); },
+            mCounters);
+    }
+
     bool TCP::is_connected() const
     {
-        return mSocket.is_open();
+        return mQueue != nullptr || mSocket.is_open();
     }
 
     void TCP::reconnect()
     {
+        if (mQueue != nullptr)
+        {
+            return;
+        }
         mSocket.connect(mEndpoint);
         mSocket.wait(ba::ip::tcp::socket::wait_write);
     }
 
     void TCP::send(std::string&& message)
     {
+        if (mQueue != nullptr)
+        {
+            mQueue->push(std::make_shared<const std::string>(std::move(message)));
+            return;
+        }
+        transmit(message);
+    }
+
+    void TCP::sendShared(const std::shared_ptr<const std::string>& message)
+    {
+        if (mQueue != nullptr)
+        {
+            mQueue->push(message);
+            return;
+        }
+        transmit(*message);
+    }
+
+    void TCP::transmit(const std::string& message)
+    {
+        static const char newline{'\n'};
+        const std::array<ba::const_buffer, 2> buffers{ba::buffer(message, message.size()), ba::buffer(&newline, 1)};
+        const std::size_t size = message.size() + 1;
+
         try
         {
-            message.append("\n");
-            const size_t written = mSocket.write_some(ba::buffer(message, message.size()));
-            if (written != message.size())
+            const size_t written = mSocket.write_some(buffers);
+            if (written != size)
             {
+                mCounters->networkError();
                 throw InfluxDBException("Error while transmitting data");
             }
         }
         catch (const boost::system::system_error& e)
         {
+            mCounters->networkError();
             throw InfluxDBException(e.what());
         }
+        mCounters->sent(size);
+    }
+
+    Transport::Statistics TCP::stats() const
+    {
+        return mCounters->snapshot();
     }
 
 } // namespace influxdb::transports
@@ -27,40 +27,66 @@
 #ifndef INFLUXDATA_TRANSPORTS_TCP_H
 #define INFLUXDATA_TRANSPORTS_TCP_H
 
+#include "SendQueue.h"
 #include "Transport.h"
+#include "TransportCounters.h"
 
-#include <boost/asio.hpp>
 #include <chrono>
+#include <memory>
 #include <string>
+#include <utility>
+#include <boost/asio.hpp>
 
 namespace influxdb::transports
 {
 
     /// \brief TCP transport
+    /// Sends synchronously on its own io_service, or asynchronously on an io_context
+    /// run by the application.
     class TCP : public Transport
     {
     public:
         /// Constructor
         TCP(const std::string& hostname, int port);
 
+        /// Constructor sending asynchronously on context
+        /// Sends throw only if the queue is full, other errors are counted in stats(). The
+        /// connection is established with the first message, closed on errors and established
+        /// again for the next message.
+        TCP(boost::asio::io_context& context, const std::string& hostname, int port);
+
         /// Sends blob via TCP
         void send(std::string&& message) override;
 
-        /// check if socket is connected
+        /// Sends blob via TCP without copying it
+        void sendShared(const std::shared_ptr<const std::string>& message) override;
+
+        /// Returns counters of messages sent
+        Statistics stats() const override;
+
+        /// check if socket is connected, always true if sending asynchronously
         bool is_connected() const;
 
-        /// reconnect socket
+        /// reconnect socket, does nothing if sending asynchronously
         void reconnect();
 
     private:
-        /// Boost Asio I/O functionality
-        boost::asio::io_service mIoService;
+        void transmit(const std::string& message);
+
+        /// Boost Asio I/O functionality, nullptr if sending on an io_context
+        std::unique_ptr<boost::asio::io_service> mIoService;
 
         /// TCP socket
         boost::asio::ip::tcp::socket mSocket;
 
         /// TCP endpoint
         boost::asio::ip::tcp::endpoint mEndpoint;
+
+        /// Counters of messages sent, shared with mQueue
+        std::shared_ptr<internal::TransportCounters> mCounters;
+
+        /// Messages sent asynchronously, nullptr if sending synchronously
+        std::shared_ptr<internal::SendQueue<boost::asio::ip::tcp::socket>> mQueue;
     };
 
 } // namespace influxdb::transports
@@ -0,0 +1,76 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Transport.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace influxdb::internal
+{
+    /// Counters of a transport, updated by the sending thread and readable from any
+    class TransportCounters
+    {
+    public:
+        void sent(std::size_t bytes) noexcept
+        {
+            mMessages.fetch_add(1, std::memory_order_relaxed);
+            mBytes.fetch_add(bytes, std::memory_order_relaxed);
+        }
+
+        void networkError() noexcept
+        {
+            mNetworkErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void serverError() noexcept
+        {
+            mServerErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void split(std::uint64_t parts) noexcept
+        {
+            mSplits.fetch_add(1, std::memory_order_relaxed);
+            mResent.fetch_add(parts, std::memory_order_relaxed);
+        }
+
+        Transport::Statistics snapshot() const noexcept
+        {
+            return Transport::Statistics{mMessages.load(std::memory_order_relaxed),
+                                         mBytes.load(std::memory_order_relaxed),
+                                         mNetworkErrors.load(std::memory_order_relaxed),
+                                         mServerErrors.load(std::memory_order_relaxed),
+                                         mSplits.load(std::memory_order_relaxed),
+                                         mResent.load(std::memory_order_relaxed)};
+        }
+
+    private:
+        std::atomic<std::uint64_t> mMessages{0};
+        std::atomic<std::uint64_t> mBytes{0};
+        std::atomic<std::uint64_t> mNetworkErrors{0};
+        std::atomic<std::uint64_t> mServerErrors{0};
+        std::atomic<std::uint64_t> mSplits{0};
+        std::atomic<std::uint64_t> mResent{0};
+    };
+}
@@ -31,17 +31,61 @@
 
 namespace influxdb::transports
 {
+    namespace
+    {
+        boost::asio::ip::udp::endpoint resolve(boost::asio::io_context& context, const std::string& hostname, int port)
+        {
+            boost::asio::ip::udp::resolver resolver(context);
+            boost::asio::ip::udp::resolver::query query(boost::asio::ip::udp::v4(), hostname, std::to_string(port));
+            boost::asio::ip::udp::resolver::iterator resolverInerator = resolver.resolve(query);
+            return *resolverInerator;
+        }
+    }
 
     UDP::UDP(const std::string& hostname, int port)
-        : mSocket(mIoService, boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), 0))
+        : mIoService(std::make_unique<boost::asio::io_service>()),
+          mSocket(*mIoService, boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), 0)),
+          mEndpoint(resolve(*mIoService, hostname, port)),
+          mCounters(std::make_shared<internal::TransportCounters>()),
+          mQueue()
+    {
+    }
+
+    UDP::UDP(boost::asio::io_context& context, const std::string& hostname, int port)
+        : mIoService(),
+          mSocket(boost::asio::make_strand(context), boost::asio::ip::udp::endpoint(boost::asio::ip::udp::v4(), 0)),
+          mEndpoint(resolve(context, hostname, port)),
+          mCounters(std::make_shared<internal::TransportCounters>()),
+          mQueue()
     {
-        boost::asio::ip::udp::resolver resolver(mIoService);
-        boost::asio::ip::udp::resolver::query query(boost::asio::ip::udp::v4(), hostname, std::to_string(port));
-        boost::asio::ip::udp::resolver::iterator resolverInerator = resolver.resolve(query);
-        mEndpoint = *resolverInerator;
+        mQueue = std::make_shared<internal::SendQueue<boost::asio::ip::udp::socket>>(
+            std::move(mSocket),
+            [endpoint = mEndpoint](auto& socket, const std::string& message, auto completion)
+            { socket.async_send_to(boost::asio::buffer(message, message.size()), endpoint, std::move(completion)); },
+            mCounters);
     }
 
     void UDP::send(std::string&& message)
+    {
+        if (mQueue != nullptr)
+        {
+            mQueue->push(std::make_shared<const std::string>(std::move(message)));
+            return;
+        }
+        transmit(message);
+    }
+
+    void UDP::sendShared(const std::shared_ptr<const std::string>& message)
+    {
+        if (mQueue != nullptr)
+        {
+            mQueue->push(message);
+            return;
+        }
+        transmit(*message);
+    }
+
+    void UDP::transmit(const std::string& message)
     {
         try
         {
@@ -49,8 +93,15 @@ namespace influxdb::transports
         }
         catch (const boost::system::system_error& e)
         {
+            mCounters->networkError();
             throw InfluxDBException(e.what());
         }
+        mCounters->sent(message.size());
+    }
+
+    Transport::Statistics UDP::stats() const
+    {
+        return mCounters->snapshot();
     }
 
 } // namespace influxdb::transports
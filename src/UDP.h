@@ -28,34 +28,58 @@
 #ifndef INFLUXDATA_TRANSPORTS_UDP_H
 #define INFLUXDATA_TRANSPORTS_UDP_H
 
+#include "SendQueue.h"
 #include "Transport.h"
+#include "TransportCounters.h"
 
-#include <boost/asio.hpp>
 #include <chrono>
+#include <memory>
 #include <string>
+#include <utility>
+#include <boost/asio.hpp>
 
 namespace influxdb::transports
 {
 
     /// \brief UDP transport
+    /// Sends synchronously on its own io_service, or asynchronously on an io_context
+    /// run by the application.
     class UDP : public Transport
     {
     public:
         /// Constructor
         UDP(const std::string& hostname, int port);
 
+        /// Constructor sending asynchronously on context
+        /// Sends throw only if the queue is full, other errors are counted in stats().
+        UDP(boost::asio::io_context& context, const std::string& hostname, int port);
+
         /// Sends blob via UDP
         void send(std::string&& message) override;
 
+        /// Sends blob via UDP without copying it
+        void sendShared(const std::shared_ptr<const std::string>& message) override;
+
+        /// Returns counters of messages sent
+        Statistics stats() const override;
+
     private:
-        /// Boost Asio I/O functionality
-        boost::asio::io_service mIoService;
+        void transmit(const std::string& message);
+
+        /// Boost Asio I/O functionality, nullptr if sending on an io_context
+        std::unique_ptr<boost::asio::io_service> mIoService;
 
         /// UDP socket
         boost::asio::ip::udp::socket mSocket;
 
         /// UDP endpoint
         boost::asio::ip::udp::endpoint mEndpoint;
+
+        /// Counters of messages sent, shared with mQueue
+        std::shared_ptr<internal::TransportCounters> mCounters;
+
+        /// Messages sent asynchronously, nullptr if sending synchronously
+        std::shared_ptr<internal::SendQueue<boost::asio::ip::udp::socket>> mQueue;
     };
 
 } // namespace influxdb::transports
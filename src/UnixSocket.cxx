@@ -34,12 +34,43 @@ namespace influxdb::transports
 #if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
 
     UnixSocket::UnixSocket(const std::string& socketPath)
-        : mSocket(mIoService), mEndpoint(socketPath)
+        : mIoService(std::make_unique<boost::asio::io_service>()), mSocket(*mIoService), mEndpoint(socketPath), mCounters(std::make_shared<internal::TransportCounters>()), mQueue()
     {
         mSocket.open();
     }
 
+    UnixSocket::UnixSocket(boost::asio::io_context& context, const std::string& socketPath)
+        : mIoService(), mSocket(boost::asio::make_strand(context)), mEndpoint(socketPath), mCounters(std::make_shared<internal::TransportCounters>()), mQueue()
+    {
+        mSocket.open();
+        mQueue = std::make_shared<internal::SendQueue<boost::asio::local::datagram_protocol::socket>>(
+            std::move(mSocket),
+            [endpoint = mEndpoint](auto& socket, const std::string& message, auto completion)
+            { socket.async_send_to(boost::asio::buffer(message, message.size()), endpoint, std::move(completion)); },
+            mCounters);
+    }
+
     void UnixSocket::send(std::string&& message)
+    {
+        if (mQueue != nullptr)
+        {
+            mQueue->push(std::make_shared<const std::string>(std::move(message)));
+            return;
+        }
+        transmit(message);
+    }
+
+    void UnixSocket::sendShared(const std::shared_ptr<const std::string>& message)
+    {
+        if (mQueue != nullptr)
+        {
+            mQueue->push(message);
+            return;
+        }
+        transmit(*message);
+    }
+
+    void UnixSocket::transmit(const std::string& message)
     {
         try
         {
@@ -47,8 +78,10 @@ namespace influxdb::transports
         }
         catch (const boost::system::system_error& e)
         {
+            mCounters->networkError();
             throw InfluxDBException(e.what());
         }
+        mCounters->sent(message.size());
     }
 
 #else
@@ -58,11 +91,31 @@ namespace influxdb::transports
         throw InfluxDBException{"Unix socket not supported on this system"};
     }
 
-    void UnixSocket::send(std::string&&)
+    UnixSocket::UnixSocket(boost::asio::io_context&, const std::string&)
+    {
+        throw InfluxDBException{"Unix socket not supported on this system"};
+    }
+
+    void UnixSocket::send(std::string&& message)
+    {
+        transmit(message);
+    }
+
+    void UnixSocket::sendShared(const std::shared_ptr<const std::string>& message)
+    {
+        transmit(*message);
+    }
+
+    void UnixSocket::transmit(const std::string&)
     {
         throw InfluxDBException{"Unix socket not supported on this system"};
     }
 
 #endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
 
+    Transport::Statistics UnixSocket::stats() const
+    {
+        return mCounters->snapshot();
+    }
+
 } // namespace influxdb::transports
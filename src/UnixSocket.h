@@ -28,10 +28,14 @@
 #ifndef INFLUXDATA_TRANSPORTS_UNIX_H
 #define INFLUXDATA_TRANSPORTS_UNIX_H
 
+#include "SendQueue.h"
 #include "Transport.h"
+#include "TransportCounters.h"
 
-#include <boost/asio.hpp>
+#include <memory>
 #include <string>
+#include <utility>
+#include <boost/asio.hpp>
 
 namespace influxdb::transports
 {
@@ -42,12 +46,24 @@ namespace influxdb::transports
     public:
         explicit UnixSocket(const std::string& socketPath);
 
+        /// Constructor sending asynchronously on context
+        /// Sends throw only if the queue is full, other errors are counted in stats().
+        UnixSocket(boost::asio::io_context& context, const std::string& socketPath);
+
         /// \param message   r-value string formated
         void send(std::string&& message) override;
 
+        /// Sends message without copying it
+        void sendShared(const std::shared_ptr<const std::string>& message) override;
+
+        /// Returns counters of messages sent
+        Statistics stats() const override;
+
     private:
-        /// Boost Asio I/O functionality
-        boost::asio::io_service mIoService;
+        void transmit(const std::string& message);
+
+        /// Boost Asio I/O functionality, nullptr if sending on an io_context
+        std::unique_ptr<boost::asio::io_service> mIoService;
 #if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
         /// Unix socket
         boost::asio::local::datagram_protocol::socket mSocket;
@@ -55,6 +71,14 @@ namespace influxdb::transports
         /// Unix endpoint
         boost::asio::local::datagram_protocol::endpoint mEndpoint;
 #endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+
+        /// Counters of messages sent, shared with mQueue
+        std::shared_ptr<internal::TransportCounters> mCounters;
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+        /// Messages sent asynchronously, nullptr if sending synchronously
+        std::shared_ptr<internal::SendQueue<boost::asio::local::datagram_protocol::socket>> mQueue;
+#endif // defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
     };
 
 } // namespace influxdb::transports
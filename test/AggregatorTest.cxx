@@ -0,0 +1,179 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Aggregator.h"
+#include "InfluxDBException.h"
+#include "mock/TransportMock.h"
+#include <thread>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/trompeloeil.hpp>
+
+namespace influxdb::test
+{
+    using namespace std::chrono_literals;
+
+    namespace
+    {
+        constexpr std::chrono::time_point<std::chrono::system_clock> windowStart{std::chrono::seconds{1000}};
+
+        Point sample(const std::string& measurement, double value, std::chrono::milliseconds offset)
+        {
+            return Point{measurement}.addTag("host", "a").addField("value", value).setTimestamp(windowStart + offset);
+        }
+    }
+
+    TEST_CASE("Aggregator throws on invalid window", "[AggregatorTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        CHECK_THROWS_AS(Aggregator(db, 0ms), InfluxDBException);
+    }
+
+    TEST_CASE("Aggregator combines samples of a series per window", "[AggregatorTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        Aggregator aggregator{db, 10s};
+
+        aggregator.write(sample("cpu", 2.0, 0ms));
+        aggregator.write(sample("cpu", 6.0, 5s));
+        aggregator.write(sample("cpu", 4.0, 9999ms));
+        CHECK(aggregator.seriesCount() == 1);
+
+        REQUIRE_CALL(*mock, send("cpu,host=a value_count=3i,value_sum=12.000000000000000000,value_min=2.000000000000000000,"
+                                 "value_max=6.000000000000000000,value_last=4.000000000000000000 1000000000000"));
+        aggregator.flush();
+        CHECK(aggregator.seriesCount() == 0);
+    }
+
+    TEST_CASE("Aggregator keys series on measurement and tag set", "[AggregatorTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        Aggregator aggregator{db, 10s, Aggregator::Aggregates{true, false, false, false, false, false, false}};
+
+        aggregator.write(Point{"cpu"}.addTag("a", "1").addTag("b", "2").addField("v", 1).setTimestamp(windowStart));
+        aggregator.write(Point{"cpu"}.addTag("b", "2").addTag("a", "1").addField("v", 1).setTimestamp(windowStart));
+        aggregator.write(Point{"cpu"}.addTag("a", "1").addField("v", 1).setTimestamp(windowStart));
+        aggregator.write(Point{"mem"}.addTag("a", "1").addField("v", 1).setTimestamp(windowStart));
+        CHECK(aggregator.seriesCount() == 3);
+
+        ALLOW_CALL(*mock, send(trompeloeil::_));
+        aggregator.flushAll();
+        CHECK(aggregator.seriesCount() == 0);
+        CHECK(aggregator.statistics().samples == 4);
+        CHECK(aggregator.statistics().points == 3);
+    }
+
+    TEST_CASE("Aggregator writes window once a later window starts", "[AggregatorTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        Aggregator aggregator{db, 10s, Aggregator::Aggregates{true, true, false, false, false, false, false}};
+
+        aggregator.write(sample("cpu", 1.0, 0ms));
+        aggregator.write(sample("cpu", 2.0, 1s));
+
+        REQUIRE_CALL(*mock, send("cpu,host=a value_count=2i,value_sum=3.000000000000000000 1000000000000"));
+        aggregator.write(sample("cpu", 5.0, 10s));
+
+        REQUIRE_CALL(*mock, send("cpu,host=a value_count=1i,value_sum=5.000000000000000000 1010000000000"));
+        aggregator.flushAll();
+    }
+
+    TEST_CASE("Aggregator writes mean and standard deviation", "[AggregatorTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        Aggregator aggregator{db, 10s, Aggregator::Aggregates{false, false, false, false, false, true, true}};
+
+        for (const double value : {1.0, 3.0, 5.0})
+        {
+            aggregator.write(sample("cpu", value, 0ms));
+        }
+
+        REQUIRE_CALL(*mock, send("cpu,host=a value_mean=3.000000000000000000,value_stddev=2.000000000000000000 1000000000000"));
+        aggregator.flushAll();
+    }
+
+    TEST_CASE("Aggregator keeps last value of non-numeric fields", "[AggregatorTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        Aggregator aggregator{db, 10s, Aggregator::Aggregates{true, false, false, false, true, false, false}};
+
+        aggregator.write(Point{"svc"}.addField("state", "starting").addField("up", false).addField("n", 1).setTimestamp(windowStart));
+        aggregator.write(Point{"svc"}.addField("state", "running").addField("up", true).addField("n", 2).setTimestamp(windowStart));
+
+        REQUIRE_CALL(*mock, send("svc state=\"running\",up=true,n_count=2i,n_last=2i 1000000000000"));
+        aggregator.flushAll();
+    }
+
+    TEST_CASE("Aggregator passes late samples through", "[AggregatorTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        Aggregator aggregator{db, 10s, Aggregator::Aggregates{true, false, false, false, false, false, false}};
+
+        aggregator.write(sample("cpu", 1.0, 10s));
+
+        REQUIRE_CALL(*mock, send("cpu,host=a value=3.000000000000000000 1000000000000"));
+        aggregator.write(sample("cpu", 3.0, 0ms));
+        CHECK(aggregator.statistics().late == 1);
+
+        REQUIRE_CALL(*mock, send("cpu,host=a value_count=1i 1010000000000"));
+        aggregator.flushAll();
+    }
+
+    TEST_CASE("Aggregator passes samples of flushed windows through", "[AggregatorTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        Aggregator aggregator{db, 10s, Aggregator::Aggregates{true, false, false, false, false, false, false}};
+
+        aggregator.write(sample("cpu", 1.0, 0ms));
+        {
+            REQUIRE_CALL(*mock, send("cpu,host=a value_count=1i 1000000000000"));
+            aggregator.flush();
+        }
+
+        REQUIRE_CALL(*mock, send("cpu,host=a value=5.000000000000000000 1000000000000"));
+        aggregator.write(sample("cpu", 5.0, 0ms));
+        CHECK(aggregator.statistics().late == 1);
+        CHECK(aggregator.seriesCount() == 0);
+        aggregator.flush();
+    }
+
+    TEST_CASE("Aggregator writes ended windows on write", "[AggregatorTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        Aggregator aggregator{db, 20ms, Aggregator::Aggregates{true, false, false, false, false, false, false}};
+
+        aggregator.write(Point{"cpu"}.addField("v", 1));
+        std::this_thread::sleep_for(50ms);
+
+        REQUIRE_CALL(*mock, send(trompeloeil::_));
+        aggregator.write(Point{"mem"}.addField("v", 1));
+        CHECK(aggregator.seriesCount() == 1);
+    }
+}
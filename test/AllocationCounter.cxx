@@ -0,0 +1,96 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+#ifdef ALLOCATION_COUNTER_ALL_THREADS
+#include <atomic>
+#endif
+
+namespace
+{
+#ifdef ALLOCATION_COUNTER_ALL_THREADS
+    // All threads, so allocations of background threads of the client count
+    std::atomic<std::size_t> allocations{0};
+#else
+    // Per thread, so allocations of other threads (e.g. a mock server) don't count
+    thread_local std::size_t allocations{0};
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size); ptr != nullptr)
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    ++allocations;
+
+    const auto align = static_cast<std::size_t>(alignment);
+    if (void* ptr = std::aligned_alloc(align, (size + align - 1) / align * align); ptr != nullptr)
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, [[maybe_unused]] std::size_t size) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, [[maybe_unused]] std::align_val_t alignment) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, [[maybe_unused]] std::size_t size, [[maybe_unused]] std::align_val_t alignment) noexcept
+{
+    std::free(ptr);
+}
+
+namespace influxdb::test
+{
+    AllocationCounter::AllocationCounter()
+        : mStart(::allocations)
+    {
+    }
+
+    std::size_t AllocationCounter::allocations() const
+    {
+        return ::allocations - mStart;
+    }
+}
@@ -0,0 +1,156 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AllocationCounter.h"
+#include "InfluxDB.h"
+#include "StringPool.h"
+#include "Transport.h"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+
+namespace influxdb::test
+{
+    namespace
+    {
+        constexpr std::chrono::time_point<std::chrono::system_clock> ignoreTimestamp(std::chrono::milliseconds(4567));
+
+        class NullTransport : public Transport
+        {
+        public:
+            std::size_t messages{0};
+
+            void send([[maybe_unused]] std::string&& message) override
+            {
+                ++messages;
+            }
+        };
+
+        Point makePoint()
+        {
+            return Point{"cpu"}
+                .addTag("host", "server01")
+                .addTag("region", "eu-central")
+                .addField("usage", 0.64)
+                .addField("processes", 61)
+                .setTimestamp(ignoreTimestamp);
+        }
+
+        std::vector<Point> makePoints(std::size_t count)
+        {
+            std::vector<Point> points;
+            points.reserve(count);
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                points.push_back(makePoint());
+            }
+            return points;
+        }
+    }
+
+    TEST_CASE("Point with inline tags and fields doesn't allocate", "[AllocationTest]")
+    {
+        const AllocationCounter counter;
+        const Point point = makePoint();
+        const auto allocations = counter.allocations();
+
+        CHECK(allocations == 0);
+    }
+
+    TEST_CASE("Point beyond inline capacity allocates once per container", "[AllocationTest]")
+    {
+        const AllocationCounter counter;
+        Point point{"cpu"};
+
+        for (const char* name : {"t0", "t1", "t2", "t3", "t4"})
+        {
+            point.addTag(name, "v");
+            point.addField(name, 1);
+        }
+        const auto allocations = counter.allocations();
+
+        CHECK(allocations <= 2);
+    }
+
+    TEST_CASE("Point with interned tags from a buffer resource doesn't allocate", "[AllocationTest]")
+    {
+        StringPool pool;
+        pool.intern("a-tag-key-beyond-small-string-size");
+        pool.intern("a-tag-value-beyond-small-string-size");
+        std::array<std::byte, 4096> buffer;
+        std::pmr::monotonic_buffer_resource resource{buffer.data(), buffer.size(), std::pmr::null_memory_resource()};
+
+        const AllocationCounter counter;
+        Point point{"cpu", &resource};
+        point.addTag("a-tag-key-beyond-small-string-size", "a-tag-value-beyond-small-string-size", pool)
+            .addField("a-field-beyond-small-string-size", 0.64)
+            .setTimestamp(ignoreTimestamp);
+        const auto allocations = counter.allocations();
+
+        CHECK(allocations == 0);
+    }
+
+    TEST_CASE("Batched writes don't allocate in steady state", "[AllocationTest]")
+    {
+        constexpr std::size_t batchSize{100};
+        InfluxDB db{std::make_unique<NullTransport>()};
+        db.batchOf(batchSize);
+
+        // Reaches the batch capacity
+        db.write(makePoints(batchSize));
+        auto points = makePoints(batchSize - 1);
+
+        const AllocationCounter counter;
+        for (auto& point : points)
+        {
+            db.write(std::move(point));
+        }
+        const auto allocations = counter.allocations();
+
+        CHECK(allocations == 0);
+    }
+
+    TEST_CASE("Flushing a batch allocates within budget", "[AllocationTest]")
+    {
+        constexpr std::size_t batchSize{100};
+        // Formatting allocates temporary strings per tag set, field set and line
+        constexpr std::size_t allocationsPerPoint{12};
+        auto transport = std::make_unique<NullTransport>();
+        const auto& sent = *transport;
+        InfluxDB db{std::move(transport)};
+        db.batchOf(batchSize);
+        db.write(makePoints(batchSize));
+        db.write(makePoints(batchSize - 1));
+        Point point = makePoint();
+
+        const AllocationCounter counter;
+        db.write(std::move(point));
+        const auto allocations = counter.allocations();
+
+        CHECK(sent.messages == 2);
+        CHECK(allocations <= batchSize * allocationsPerPoint);
+    }
+}
@@ -0,0 +1,218 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "AsyncInfluxDB.h"
+#include "AsyncInfluxDBFactory.h"
+#include "InfluxDBException.h"
+#include "MockHttpServer.h"
+#include <exception>
+#include <optional>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/io_context.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace influxdb::test
+{
+    namespace
+    {
+        constexpr std::chrono::time_point<std::chrono::system_clock> ignoreTimestamp(std::chrono::milliseconds(4567));
+
+        class RecordingTransport : public AsyncTransport
+        {
+        public:
+            explicit RecordingTransport(std::vector<std::string>& messages)
+                : mMessages(messages)
+            {
+            }
+
+            boost::asio::awaitable<void> sendAsync(std::string message) override
+            {
+                mMessages.push_back(std::move(message));
+                co_return;
+            }
+
+        private:
+            std::vector<std::string>& mMessages;
+        };
+
+        /// Runs operation to completion, rethrowing its exception
+        template <class T>
+        T run(boost::asio::io_context& context, boost::asio::awaitable<T> operation)
+        {
+            std::exception_ptr error;
+            std::optional<T> result;
+            boost::asio::co_spawn(context, std::move(operation), [&error, &result](std::exception_ptr e, T value)
+                                  {
+                                      error = e;
+                                      result = std::move(value);
+                                  });
+            context.restart();
+            context.run();
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+            return std::move(*result);
+        }
+
+        void run(boost::asio::io_context& context, boost::asio::awaitable<void> operation)
+        {
+            std::exception_ptr error;
+            boost::asio::co_spawn(context, std::move(operation), [&error](std::exception_ptr e)
+                                  { error = e; });
+            context.restart();
+            context.run();
+
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        Point pointOf(int value)
+        {
+            return Point{"cpu"}.addField("value", value).setTimestamp(ignoreTimestamp);
+        }
+    }
+
+    TEST_CASE("Async write without batching sends each point", "[AsyncInfluxDBTest]")
+    {
+        boost::asio::io_context context;
+        std::vector<std::string> messages;
+        AsyncInfluxDB db{std::make_unique<RecordingTransport>(messages)};
+        db.addGlobalTag("host", "a b");
+
+        run(context, db.writeAsync(pointOf(1)));
+        run(context, db.writeAsync(std::vector<Point>{pointOf(2), pointOf(3)}));
+
+        REQUIRE(messages.size() == 2);
+        CHECK(messages[0] == "cpu,host=a\\ b value=1i 4567000000");
+        CHECK(messages[1] == "cpu,host=a\\ b value=2i 4567000000\ncpu,host=a\\ b value=3i 4567000000");
+    }
+
+    TEST_CASE("Async write sends full batches and flush the rest", "[AsyncInfluxDBTest]")
+    {
+        boost::asio::io_context context;
+        std::vector<std::string> messages;
+        AsyncInfluxDB db{std::make_unique<RecordingTransport>(messages)};
+        db.batchOf(2);
+
+        run(context, db.writeAsync(std::vector<Point>{pointOf(1), pointOf(2), pointOf(3)}));
+        CHECK(messages.size() == 1);
+        CHECK(db.batchSize() == 1);
+
+        run(context, db.flushBatchAsync());
+        REQUIRE(messages.size() == 2);
+        CHECK(messages[1] == "cpu value=3i 4567000000");
+        CHECK(db.batchSize() == 0);
+
+        run(context, db.flushBatchAsync());
+        CHECK(messages.size() == 2);
+    }
+
+    TEST_CASE("Async client requires transport", "[AsyncInfluxDBTest]")
+    {
+        CHECK_THROWS_AS(AsyncInfluxDB{nullptr}, InfluxDBException);
+    }
+
+    TEST_CASE("Async factory accepts http only", "[AsyncInfluxDBTest]")
+    {
+        boost::asio::io_context context;
+        CHECK_THROWS_AS(AsyncInfluxDBFactory::Get(context.get_executor(), "udp://localhost:8089"), InfluxDBException);
+        CHECK_THROWS_AS(AsyncInfluxDBFactory::Get(context.get_executor(), "localhost:8086?db=test"), InfluxDBException);
+        CHECK_THROWS_AS(AsyncInfluxDBFactory::Get(context.get_executor(), "http://localhost:8086"), InfluxDBException);
+        CHECK(AsyncInfluxDBFactory::Get(context.get_executor(), "http://localhost:8086?db=test") != nullptr);
+    }
+
+    TEST_CASE("Async writes are in flight concurrently over http", "[AsyncInfluxDBTest]")
+    {
+        MockHttpServer server;
+        server.setFaults(MockHttpServer::Faults{std::chrono::milliseconds{20}});
+        boost::asio::io_context context;
+        auto db = AsyncInfluxDBFactory::Get(context.get_executor(), server.url() + "/?db=test db");
+        std::size_t completed{0};
+
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int value = 0; value < 64; ++value)
+        {
+            boost::asio::co_spawn(context, db->writeAsync(pointOf(value)), [&completed](std::exception_ptr e)
+                                  {
+                                      if (!e)
+                                      {
+                                          ++completed;
+                                      }
+                                  });
+        }
+        context.run();
+
+        // 8 connections with 20ms latency each take 8 rounds, serial writes would take 64
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds{640});
+        CHECK(completed == 64);
+        CHECK(server.statistics().writes == 64);
+        CHECK(server.statistics().lines == 64);
+        CHECK(server.requests().front().target == "/write?db=test%20db");
+    }
+
+    TEST_CASE("Async query parses points over http", "[AsyncInfluxDBTest]")
+    {
+        MockHttpServer server;
+        server.setQueryResponse(R"({"results":[{"statement_id":0,"series":[{"name":"cpu","columns":["time","value"],)"
+                                R"("values":[["1970-01-01T00:00:04.567Z",1.5],["1970-01-01T00:00:04.568Z",2.5]]}]}]})");
+        boost::asio::io_context context;
+        auto db = AsyncInfluxDBFactory::Get(context.get_executor(), "http://user:pass@" + server.url().substr(7) + "?db=test");
+
+        const auto points = run(context, db->queryAsync("SELECT * FROM cpu"));
+
+        REQUIRE(points.size() == 2);
+        CHECK(points[0].getName() == "cpu");
+        CHECK(points[1].getTimestamp() == std::chrono::system_clock::time_point{std::chrono::milliseconds{4568}});
+        const auto request = server.requests().front();
+        CHECK(request.target == "/query?db=test&q=SELECT%20%2A%20FROM%20cpu");
+        CHECK(request.headers.at("authorization") == "Basic dXNlcjpwYXNz");
+    }
+
+    TEST_CASE("Async write throws on errors", "[AsyncInfluxDBTest]")
+    {
+        boost::asio::io_context context;
+
+        SECTION("Server error")
+        {
+            MockHttpServer server{[](const auto&)
+                                  { return MockHttpServer::Response{500, "", {}}; }};
+            auto db = AsyncInfluxDBFactory::Get(context.get_executor(), server.url() + "?db=test");
+            CHECK_THROWS_AS(run(context, db->writeAsync(pointOf(1))), InfluxDBException);
+        }
+
+        SECTION("Connection refused")
+        {
+            int port{0};
+            {
+                const MockHttpServer server;
+                port = server.port();
+            }
+            auto db = AsyncInfluxDBFactory::Get(context.get_executor(), "http://127.0.0.1:" + std::to_string(port) + "?db=test");
+            CHECK_THROWS_AS(run(context, db->writeAsync(pointOf(1))), InfluxDBException);
+        }
+    }
+}
@@ -0,0 +1,101 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Escape.h"
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+namespace influxdb::test
+{
+    using namespace Catch::Matchers;
+    using internal::EscapeContext;
+    using internal::escape;
+    using internal::findEscapable;
+    using internal::unescape;
+
+    TEST_CASE("Clean strings are not changed", "[EscapeTest]")
+    {
+        CHECK_THAT(escape("", EscapeContext::Key), Equals(""));
+        CHECK_THAT(escape("host", EscapeContext::Measurement), Equals("host"));
+        CHECK_THAT(escape("server01.example.com", EscapeContext::Key), Equals("server01.example.com"));
+        CHECK_THAT(escape("a,b c=d", EscapeContext::StringValue), Equals("a,b c=d"));
+    }
+
+    TEST_CASE("Measurement escapes comma and space", "[EscapeTest]")
+    {
+        CHECK_THAT(escape("cpu load,total=1", EscapeContext::Measurement), Equals(R"(cpu\ load\,total=1)"));
+    }
+
+    TEST_CASE("Key escapes comma, equals sign and space", "[EscapeTest]")
+    {
+        CHECK_THAT(escape("a,b=c d", EscapeContext::Key), Equals(R"(a\,b\=c\ d)"));
+        CHECK_THAT(escape(",,", EscapeContext::Key), Equals(R"(\,\,)"));
+    }
+
+    TEST_CASE("String value escapes double quote and backslash", "[EscapeTest]")
+    {
+        CHECK_THAT(escape(R"(say "hi" \o/)", EscapeContext::StringValue), Equals(R"(say \"hi\" \\o/)"));
+    }
+
+    TEST_CASE("Special characters are found at every position of long strings", "[EscapeTest]")
+    {
+        for (std::size_t length : {15u, 16u, 17u, 31u, 32u, 33u, 64u, 100u})
+        {
+            for (std::size_t position = 0; position < length; ++position)
+            {
+                std::string value(length, 'x');
+                value[position] = '=';
+                CHECK(findEscapable(value, EscapeContext::Key) == position);
+
+                std::string expected(length, 'x');
+                expected.replace(position, 1, R"(\=)");
+                CHECK(escape(value, EscapeContext::Key) == expected);
+            }
+            CHECK(findEscapable(std::string(length, 'x'), EscapeContext::Key) == std::string::npos);
+        }
+    }
+
+    TEST_CASE("Find starts at position", "[EscapeTest]")
+    {
+        const std::string value{"a b c d e f g h i j k l m n o p q"};
+        CHECK(findEscapable(value, EscapeContext::Key, 0) == 1);
+        CHECK(findEscapable(value, EscapeContext::Key, 2) == 3);
+        CHECK(findEscapable(value, EscapeContext::Key, 32) == std::string::npos);
+    }
+
+    TEST_CASE("Unescape restores escaped strings", "[EscapeTest]")
+    {
+        for (const auto context : {EscapeContext::Measurement, EscapeContext::Key, EscapeContext::StringValue})
+        {
+            const std::string value{R"(a,b=c d "e" \f\)"};
+            CHECK(unescape(escape(value, context), context) == value);
+        }
+    }
+
+    TEST_CASE("Unescape keeps backslashes not followed by a special character", "[EscapeTest]")
+    {
+        CHECK_THAT(unescape(R"(a\)", EscapeContext::Key), Equals(R"(a\)"));
+        CHECK_THAT(unescape(R"(a"b)", EscapeContext::Key), Equals(R"(a"b)"));
+        CHECK_THAT(unescape(R"(a\,b)", EscapeContext::StringValue), Equals(R"(a\,b)"));
+    }
+}
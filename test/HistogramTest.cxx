@@ -0,0 +1,182 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Histogram.h"
+#include "InfluxDBException.h"
+#include <cmath>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_floating_point.hpp>
+
+namespace influxdb::test
+{
+    using Catch::Matchers::WithinRel;
+
+    TEST_CASE("Histogram throws on invalid parameters", "[HistogramTest]")
+    {
+        CHECK_THROWS_AS(Histogram(0.0), InfluxDBException);
+        CHECK_THROWS_AS(Histogram(1.0), InfluxDBException);
+        CHECK_THROWS_AS(Histogram(0.01, 10.0, 1.0), InfluxDBException);
+        CHECK_THROWS_AS(Histogram(0.01, 0.0, 1.0), InfluxDBException);
+    }
+
+    TEST_CASE("Histogram of no values is empty", "[HistogramTest]")
+    {
+        Histogram histogram;
+        const auto snapshot = histogram.snapshot();
+        CHECK(snapshot.count() == 0);
+        CHECK(snapshot.quantile(0.5) == 0.0);
+        CHECK(snapshot.min() == 0.0);
+        CHECK(snapshot.max() == 0.0);
+        CHECK(snapshot.mean() == 0.0);
+    }
+
+    TEST_CASE("Histogram tracks count, sum, min and max exactly", "[HistogramTest]")
+    {
+        Histogram histogram;
+        histogram.record(3.0);
+        histogram.record(1.5);
+        histogram.record(7.25);
+        histogram.record(std::nan(""));
+
+        const auto snapshot = histogram.snapshot();
+        CHECK(snapshot.count() == 3);
+        CHECK(snapshot.sum() == 11.75);
+        CHECK(snapshot.min() == 1.5);
+        CHECK(snapshot.max() == 7.25);
+    }
+
+    TEST_CASE("Histogram quantiles are within relative accuracy", "[HistogramTest]")
+    {
+        constexpr double accuracy{0.01};
+        Histogram histogram{accuracy};
+
+        for (int i = 1; i <= 10000; ++i)
+        {
+            histogram.record(static_cast<double>(i));
+        }
+
+        const auto snapshot = histogram.snapshot();
+        CHECK_THAT(snapshot.quantile(0.5), WithinRel(5000.0, accuracy));
+        CHECK_THAT(snapshot.quantile(0.9), WithinRel(9000.0, accuracy));
+        CHECK_THAT(snapshot.quantile(0.99), WithinRel(9900.0, accuracy));
+        CHECK(snapshot.quantile(0.0) == 1.0);
+        CHECK(snapshot.quantile(1.0) == 10000.0);
+    }
+
+    TEST_CASE("Histogram counts values below the minimum as zero", "[HistogramTest]")
+    {
+        Histogram histogram{0.01, 1.0, 1000.0};
+        histogram.record(0.0);
+        histogram.record(0.5);
+        histogram.record(-3.0);
+        histogram.record(100.0);
+        histogram.record(1e9);
+
+        const auto snapshot = histogram.snapshot();
+        CHECK(snapshot.count() == 5);
+        CHECK_THAT(snapshot.quantile(0.75), WithinRel(100.0, 0.01));
+        CHECK(snapshot.quantile(0.5) == 0.0);
+        CHECK(snapshot.countAtMost(0.0) == 3);
+        CHECK(snapshot.countAtMost(200.0) == 4);
+        CHECK(snapshot.quantile(1.0) == 1e9);
+    }
+
+    TEST_CASE("Histogram collect resets the values", "[HistogramTest]")
+    {
+        Histogram histogram;
+        histogram.record(4.0);
+        histogram.record(8.0);
+
+        CHECK(histogram.collect().count() == 2);
+
+        const auto snapshot = histogram.collect();
+        CHECK(snapshot.count() == 0);
+        CHECK(snapshot.sum() == 0.0);
+    }
+
+    TEST_CASE("Histogram snapshots merge", "[HistogramTest]")
+    {
+        Histogram first;
+        Histogram second;
+
+        for (int i = 1; i <= 500; ++i)
+        {
+            first.record(static_cast<double>(i));
+            second.record(static_cast<double>(i + 500));
+        }
+
+        auto merged = first.snapshot();
+        merged.merge(second.snapshot());
+        CHECK(merged.count() == 1000);
+        CHECK(merged.min() == 1.0);
+        CHECK(merged.max() == 1000.0);
+        CHECK_THAT(merged.quantile(0.5), WithinRel(500.0, Histogram::defaultRelativeAccuracy));
+
+        Histogram other{0.05};
+        CHECK_THROWS_AS(merged.merge(other.snapshot()), InfluxDBException);
+    }
+
+    TEST_CASE("Histogram records concurrently", "[HistogramTest]")
+    {
+        Histogram histogram;
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&histogram]
+                                 {
+                                     for (int i = 0; i < 10000; ++i)
+                                     {
+                                         histogram.record(2.0);
+                                     } });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        const auto snapshot = histogram.collect();
+        CHECK(snapshot.count() == 40000);
+        CHECK(snapshot.sum() == 80000.0);
+    }
+
+    TEST_CASE("Histogram adds percentile and bucket fields to point", "[HistogramTest]")
+    {
+        Histogram histogram;
+        histogram.record(1.0);
+        histogram.record(1.0);
+        histogram.record(4.0);
+
+        const auto point = histogram.collect().addFields(Point{"latency"}, {50.0, 100.0}, {2.0, 10.0});
+        CHECK(point.getFields() == "count=3i,sum=6.000000000000000000,min=1.000000000000000000,max=4.000000000000000000,"
+                                   "mean=2.000000000000000000,p50=1.000000000000000000,p100=4.000000000000000000,le_2=2i,le_10=3i");
+    }
+
+    TEST_CASE("Histogram adds only count and sum fields if empty", "[HistogramTest]")
+    {
+        Histogram histogram;
+        const auto point = histogram.collect().addFields(Point{"latency"});
+        CHECK(point.getFields() == "count=0i,sum=0.000000000000000000");
+    }
+}
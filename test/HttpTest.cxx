@@ -25,6 +25,9 @@
 #include "mock/CprMock.h"
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/trompeloeil.hpp>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace influxdb::test
 {
@@ -49,6 +52,16 @@ namespace influxdb::test
         return response;
     }
 
+    cpr::Response respondUpTo(std::size_t maxBodySize, const std::string& body, std::vector<std::string>& accepted)
+    {
+        if (body.size() > maxBodySize)
+        {
+            return createResponse(cpr::ErrorCode::OK, 413);
+        }
+        accepted.push_back(body);
+        return createResponse(cpr::ErrorCode::OK, cpr::status::HTTP_NO_CONTENT);
+    }
+
     HTTP createHttp()
     {
         ALLOW_CALL(sessionMock, SetTimeout(_));
@@ -115,6 +128,22 @@ namespace influxdb::test
         http.send("content");
     }
 
+    TEST_CASE("Send shared posts payload", "[HttpTest]")
+    {
+        auto http = createHttp();
+        const auto data = std::make_shared<const std::string>("content");
+
+        REQUIRE_CALL(sessionMock, Post()).RETURN(createResponse(cpr::ErrorCode::OK, cpr::status::HTTP_OK));
+        ALLOW_CALL(sessionMock, SetUrl(_));
+        ALLOW_CALL(sessionMock, SetHeader(_));
+        REQUIRE_CALL(sessionMock, SetBody(_)).WITH(_1.str() == "content");
+        ALLOW_CALL(sessionMock, SetParameters(_));
+
+        http.sendShared(data);
+        CHECK(*data == "content");
+        CHECK(http.stats().messages == 1);
+    }
+
     TEST_CASE("Send throws on unsuccessful response", "[HttpTest]")
     {
         auto http = createHttp();
@@ -128,6 +157,134 @@ namespace influxdb::test
         REQUIRE_THROWS_AS(http.send("content"), InfluxDBException);
     }
 
+    TEST_CASE("Send counts messages and errors", "[HttpTest]")
+    {
+        auto http = createHttp();
+
+        ALLOW_CALL(sessionMock, SetUrl(_));
+        ALLOW_CALL(sessionMock, SetHeader(_));
+        ALLOW_CALL(sessionMock, SetBody(_));
+        ALLOW_CALL(sessionMock, SetParameters(_));
+
+        {
+            REQUIRE_CALL(sessionMock, Post()).RETURN(createResponse(cpr::ErrorCode::OK, cpr::status::HTTP_OK));
+            http.send("content");
+        }
+        {
+            REQUIRE_CALL(sessionMock, Post()).RETURN(createResponse(cpr::ErrorCode::INTERNAL_ERROR, cpr::status::HTTP_OK));
+            REQUIRE_THROWS_AS(http.send("content"), InfluxDBException);
+        }
+        {
+            REQUIRE_CALL(sessionMock, Post()).RETURN(createResponse(cpr::ErrorCode::OK, cpr::status::HTTP_BAD_REQUEST));
+            REQUIRE_THROWS_AS(http.send("content"), InfluxDBException);
+        }
+
+        const auto stats = http.stats();
+        CHECK(stats.messages == 1);
+        CHECK(stats.bytes == 7);
+        CHECK(stats.networkErrors == 1);
+        CHECK(stats.serverErrors == 1);
+    }
+
+    TEST_CASE("Send splits payload rejected as too large", "[HttpTest]")
+    {
+        auto http = createHttp();
+        std::vector<std::string> bodies;
+        std::vector<std::string> accepted;
+
+        ALLOW_CALL(sessionMock, SetUrl(_));
+        ALLOW_CALL(sessionMock, SetHeader(_));
+        ALLOW_CALL(sessionMock, SetParameters(_));
+        ALLOW_CALL(sessionMock, SetBody(_)).LR_SIDE_EFFECT(bodies.push_back(_1.str()));
+        ALLOW_CALL(sessionMock, Post()).LR_RETURN(respondUpTo(8, bodies.back(), accepted));
+
+        http.send("a=1\nb=2\nc=3\nd=4");
+
+        CHECK(bodies.size() == 3);
+        CHECK(accepted == std::vector<std::string>{"a=1\nb=2", "c=3\nd=4"});
+        const auto stats = http.stats();
+        CHECK(stats.messages == 2);
+        CHECK(stats.bytes == 14);
+        CHECK(stats.serverErrors == 0);
+        CHECK(stats.splits == 1);
+        CHECK(stats.resent == 2);
+    }
+
+    TEST_CASE("Send learns accepted payload size", "[HttpTest]")
+    {
+        auto http = createHttp();
+        std::vector<std::string> bodies;
+        std::vector<std::string> accepted;
+        std::string data;
+
+        for (int i = 0; i < 400; ++i)
+        {
+            data += "m,host=h" + std::to_string(i) + " value=" + std::to_string(i) + "i\n";
+        }
+        data.pop_back();
+
+        ALLOW_CALL(sessionMock, SetUrl(_));
+        ALLOW_CALL(sessionMock, SetHeader(_));
+        ALLOW_CALL(sessionMock, SetParameters(_));
+        ALLOW_CALL(sessionMock, SetBody(_)).LR_SIDE_EFFECT(bodies.push_back(_1.str()));
+        ALLOW_CALL(sessionMock, Post()).LR_RETURN(respondUpTo(4000, bodies.back(), accepted));
+
+        for (int i = 0; i < 5; ++i)
+        {
+            http.send(std::string{data});
+        }
+        bodies.clear();
+        accepted.clear();
+        http.send(std::string{data});
+
+        CHECK(bodies == accepted);
+        std::string delivered;
+
+        for (const auto& body : accepted)
+        {
+            delivered += (delivered.empty() ? "" : "\n") + body;
+        }
+        CHECK(delivered == data);
+        CHECK(http.stats().serverErrors == 0);
+    }
+
+    TEST_CASE("Send throws on single line rejected as too large", "[HttpTest]")
+    {
+        auto http = createHttp();
+
+        ALLOW_CALL(sessionMock, SetUrl(_));
+        ALLOW_CALL(sessionMock, SetHeader(_));
+        ALLOW_CALL(sessionMock, SetBody(_));
+        ALLOW_CALL(sessionMock, SetParameters(_));
+        REQUIRE_CALL(sessionMock, Post()).RETURN(createResponse(cpr::ErrorCode::OK, 413));
+
+        REQUIRE_THROWS_AS(http.send("content"), InfluxDBException);
+        CHECK(http.stats().serverErrors == 1);
+        CHECK(http.stats().splits == 0);
+    }
+
+    TEST_CASE("Send throws on failure of split payload", "[HttpTest]")
+    {
+        auto http = createHttp();
+        std::vector<std::string> bodies;
+        std::vector<std::string> accepted;
+
+        ALLOW_CALL(sessionMock, SetUrl(_));
+        ALLOW_CALL(sessionMock, SetHeader(_));
+        ALLOW_CALL(sessionMock, SetParameters(_));
+        ALLOW_CALL(sessionMock, SetBody(_)).LR_SIDE_EFFECT(bodies.push_back(_1.str()));
+        ALLOW_CALL(sessionMock, Post()).LR_WITH(bodies.back() != "c=3\nd=4").LR_RETURN(respondUpTo(8, bodies.back(), accepted));
+        ALLOW_CALL(sessionMock, Post()).LR_WITH(bodies.back() == "c=3\nd=4").RETURN(createResponse(cpr::ErrorCode::OK, cpr::status::HTTP_BAD_GATEWAY));
+
+        REQUIRE_THROWS_AS(http.send("a=1\nb=2\nc=3\nd=4"), InfluxDBException);
+        CHECK(accepted == std::vector<std::string>{"a=1\nb=2"});
+        const auto stats = http.stats();
+        CHECK(stats.messages == 1);
+        CHECK(stats.serverErrors == 1);
+        CHECK(stats.splits == 1);
+        CHECK(stats.resent == 2);
+    }
+
     TEST_CASE("Query sets parameters", "[HttpTest]")
     {
         auto http = createHttp();
@@ -57,4 +57,28 @@ namespace influxdb::test
     {
         CHECK_THROWS_AS(InfluxDBFactory::Get("http://localhost:8086"), InfluxDBException);
     }
+
+    TEST_CASE("Creates a shard per url", "[InfluxDBFactoryTest]")
+    {
+        const auto db = InfluxDBFactory::GetSharded({"http://localhost:8086?db=test", "http://localhost:8087?db=test", "http://localhost:8086?db=test"});
+        CHECK(db->shardCount() == 3);
+    }
+
+    TEST_CASE("Throws on sharding without or with invalid urls", "[InfluxDBFactoryTest]")
+    {
+        CHECK_THROWS_AS(InfluxDBFactory::GetSharded({}), InfluxDBException);
+        CHECK_THROWS_AS(InfluxDBFactory::GetSharded({"http://localhost:8086?db=test", "httpX://localhost:8086?db=test"}), InfluxDBException);
+    }
+
+    TEST_CASE("Creates a replica per url", "[InfluxDBFactoryTest]")
+    {
+        const auto db = InfluxDBFactory::GetReplicated({"http://localhost:8086?db=test", "http://localhost:8087?db=test"});
+        CHECK(db->replicaCount() == 2);
+    }
+
+    TEST_CASE("Throws on replication without or with invalid urls", "[InfluxDBFactoryTest]")
+    {
+        CHECK_THROWS_AS(InfluxDBFactory::GetReplicated({}), InfluxDBException);
+        CHECK_THROWS_AS(InfluxDBFactory::GetReplicated({"http://localhost:8086?db=test", "httpX://localhost:8086?db=test"}), InfluxDBException);
+    }
 }
@@ -23,6 +23,9 @@
 #include "InfluxDB.h"
 #include "InfluxDBException.h"
 #include "mock/TransportMock.h"
+#include <memory_resource>
+#include <string>
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/trompeloeil.hpp>
 
@@ -31,6 +34,76 @@ namespace influxdb::test
     namespace
     {
         constexpr std::chrono::time_point<std::chrono::system_clock> ignoreTimestamp(std::chrono::milliseconds(4567));
+
+        class CountingResource : public std::pmr::memory_resource
+        {
+        public:
+            std::size_t outstandingBytes{0};
+
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override
+            {
+                outstandingBytes += bytes;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+            {
+                outstandingBytes -= bytes;
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
+
+        class RecordingObserver : public Observer
+        {
+        public:
+            std::vector<std::string> events{};
+
+            void onWrite(const Point& point) override
+            {
+                events.push_back("write " + point.getName());
+            }
+
+            void onBatchSealed(std::size_t points) override
+            {
+                events.push_back("sealed " + std::to_string(points));
+            }
+
+            void onSerializeStart(std::size_t points) override
+            {
+                events.push_back("serialize " + std::to_string(points));
+            }
+
+            void onSerializeEnd(std::size_t bytes) override
+            {
+                events.push_back("serialized " + std::to_string(bytes));
+            }
+
+            void onSendStart(std::size_t bytes) override
+            {
+                events.push_back("send " + std::to_string(bytes));
+            }
+
+            void onSendEnd(std::size_t bytes, const std::exception* error) override
+            {
+                events.push_back("sent " + std::to_string(bytes) + (error != nullptr ? " " + std::string{error->what()} : ""));
+            }
+
+            void onQueryStart(const std::string& query) override
+            {
+                events.push_back("query " + query);
+            }
+
+            void onQueryEnd(const std::string& query, const std::exception* error) override
+            {
+                events.push_back("queried " + query + (error != nullptr ? " " + std::string{error->what()} : ""));
+            }
+        };
     }
 
     TEST_CASE("Ctor throws on nullptr transport", "[InfluxDBTest]")
@@ -77,6 +150,16 @@ namespace influxdb::test
         db.write(Point{"p5"}.addField("f4", 55).setTimestamp(ignoreTimestamp));
     }
 
+    TEST_CASE("Global tags are escaped", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        REQUIRE_CALL(*mock, send(R"(p,a\ b=c\,d f=1i 4567000000)"));
+
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.addGlobalTag("a b", "c,d");
+        db.write(Point{"p"}.addField("f", 1).setTimestamp(ignoreTimestamp));
+    }
+
     TEST_CASE("Write with batch enabled adds point to batch if size not reached", "[InfluxDBTest]")
     {
         using trompeloeil::_;
@@ -125,6 +208,129 @@ namespace influxdb::test
         db.flushBatch();
     }
 
+    TEST_CASE("Batch coalescing merges points of same series and timestamp", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        REQUIRE_CALL(*mock, send("cpu,host=a user=1i,system=5i,idle=3i 4567000000\n"
+                                 "cpu,host=b user=4i 4567000000\n"
+                                 "cpu,host=a user=6i 5567000000"));
+
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(300);
+        db.setBatchCoalescing(true);
+        db.write(Point{"cpu"}.addTag("host", "a").addField("user", 1).addField("system", 2).setTimestamp(ignoreTimestamp));
+        db.write(Point{"cpu"}.addTag("host", "b").addField("user", 4).setTimestamp(ignoreTimestamp));
+        db.write(Point{"cpu"}.addTag("host", "a").addField("idle", 3).addField("system", 5).setTimestamp(ignoreTimestamp));
+        db.write(Point{"cpu"}.addTag("host", "a").addField("user", 6).setTimestamp(ignoreTimestamp + std::chrono::seconds{1}));
+        db.flushBatch();
+    }
+
+    TEST_CASE("Batch coalescing keeps escaped values and global tags", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        REQUIRE_CALL(*mock, send("m\\ 1,g=1,t=a\\,b s=\"x, y=z\",v=2i 4567000000\n"
+                                 "n,g=1 4567000000"));
+
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(300);
+        db.setBatchCoalescing(true);
+        db.addGlobalTag("g", "1");
+        db.write(Point{"m 1"}.addTag("t", "a,b").addField("s", "x, y=z").setTimestamp(ignoreTimestamp));
+        db.write(Point{"m 1"}.addTag("t", "a,b").addField("v", 2).setTimestamp(ignoreTimestamp));
+        db.write(Point{"n"}.setTimestamp(ignoreTimestamp));
+        db.flushBatch();
+    }
+
+    TEST_CASE("Batch coalescing merges points with tags in different order", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        REQUIRE_CALL(*mock, send("cpu,host=a,region=eu user=1i,idle=3i 4567000000\n"
+                                 "cpu,region=eu user=2i 4567000000"));
+
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(300);
+        db.setBatchCoalescing(true);
+        db.write(Point{"cpu"}.addTag("host", "a").addTag("region", "eu").addField("user", 1).setTimestamp(ignoreTimestamp));
+        db.write(Point{"cpu"}.addTag("region", "eu").addField("user", 2).setTimestamp(ignoreTimestamp));
+        db.write(Point{"cpu"}.addTag("region", "eu").addTag("host", "a").addField("idle", 3).setTimestamp(ignoreTimestamp));
+        db.flushBatch();
+    }
+
+    TEST_CASE("Load shedding samples series after failed send", "[InfluxDBTest]")
+    {
+        using trompeloeil::_;
+
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.setLoadShedding(std::chrono::milliseconds{100});
+
+        {
+            REQUIRE_CALL(*mock, send(_)).THROW(std::runtime_error{"Intentional"});
+            CHECK_THROWS(db.write(Point{"p"}.addField("f0", 0).setTimestamp(ignoreTimestamp)));
+        }
+
+        REQUIRE_CALL(*mock, send("p f0=1i,sample_rate=2i 4567000000"));
+        REQUIRE_CALL(*mock, send("q f0=1i,sample_rate=2i 4567000000"));
+        db.write(Point{"p"}.addField("f0", 1).setTimestamp(ignoreTimestamp));
+        db.write(Point{"p"}.addField("f0", 2).setTimestamp(ignoreTimestamp));
+        db.write(Point{"q"}.addField("f0", 1).setTimestamp(ignoreTimestamp));
+    }
+
+    TEST_CASE("Stats count points, lines, bytes and sends", "[InfluxDBTest]")
+    {
+        using trompeloeil::_;
+
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+
+        {
+            REQUIRE_CALL(*mock, send("p f0=1i 4567000000\np f0=2i 4567000000"));
+            db.write({Point{"p"}.addField("f0", 1).setTimestamp(ignoreTimestamp),
+                      Point{"p"}.addField("f0", 2).setTimestamp(ignoreTimestamp)});
+        }
+        {
+            REQUIRE_CALL(*mock, send(_)).THROW(std::runtime_error{"Intentional"});
+            CHECK_THROWS(db.write(Point{"p"}.addField("f0", 3).setTimestamp(ignoreTimestamp)));
+        }
+
+        const auto stats = db.stats();
+        CHECK(stats.points == 3);
+        CHECK(stats.lines == 2);
+        CHECK(stats.bytes == 37);
+        CHECK(stats.batches == 0);
+        CHECK(stats.failedSends == 1);
+        CHECK(stats.dropped == 0);
+        CHECK(stats.sendLatency.count() == 2);
+        CHECK(stats.serializeTime.count() > 0);
+        CHECK(stats.transport.messages == 0);
+    }
+
+    TEST_CASE("Stats count batches and dropped points", "[InfluxDBTest]")
+    {
+        using trompeloeil::_;
+
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(2);
+        db.setDiscardFailedBatches(true);
+
+        {
+            REQUIRE_CALL(*mock, send(_));
+            db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+            db.write(Point{"y"}.setTimestamp(ignoreTimestamp));
+        }
+        {
+            REQUIRE_CALL(*mock, send(_)).THROW(std::runtime_error{"Intentional"});
+            db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+            CHECK_THROWS(db.write(Point{"y"}.setTimestamp(ignoreTimestamp)));
+        }
+
+        const auto stats = db.stats();
+        CHECK(stats.batches == 1);
+        CHECK(stats.lines == 2);
+        CHECK(stats.dropped == 2);
+    }
+
     TEST_CASE("Destructs cleanly with pending batches", "[InfluxDBTest]")
     {
         using trompeloeil::_;
@@ -139,6 +345,176 @@ namespace influxdb::test
         }
     }
 
+    TEST_CASE("Failed flush discards batch if enabled", "[InfluxDBTest]")
+    {
+        using trompeloeil::_;
+
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.setDiscardFailedBatches(true);
+        std::vector<std::string> dropped;
+        db.setDropCallback([&dropped](const Point& point)
+                           { dropped.push_back(point.getName()); });
+        db.batchOf(2);
+        db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+
+        REQUIRE_CALL(*mock, send(_)).THROW(std::runtime_error{"Intentional"});
+        CHECK_THROWS(db.write(Point{"y"}.setTimestamp(ignoreTimestamp)));
+        CHECK(db.batchSize() == 0);
+        CHECK(dropped == std::vector<std::string>{"x", "y"});
+        CHECK(db.bufferStatistics().dropped == 2);
+        CHECK(db.bufferStatistics().failedFlushes == 1);
+    }
+
+    TEST_CASE("Failed flush keeps batch by default", "[InfluxDBTest]")
+    {
+        using trompeloeil::_;
+
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(2);
+        db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+
+        {
+            REQUIRE_CALL(*mock, send(_)).THROW(std::runtime_error{"Intentional"});
+            CHECK_THROWS(db.write(Point{"y"}.setTimestamp(ignoreTimestamp)));
+        }
+        CHECK(db.batchSize() == 2);
+        CHECK(db.bufferStatistics().dropped == 0);
+
+        REQUIRE_CALL(*mock, send("x 4567000000\ny 4567000000"));
+        db.flushBatch();
+        CHECK(db.batchSize() == 0);
+    }
+
+    TEST_CASE("Buffer limit keeps failed batch for retry", "[InfluxDBTest]")
+    {
+        using trompeloeil::_;
+
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(2);
+        db.setBufferLimit(10, 1000, InfluxDB::OverflowPolicy::FailFast);
+
+        {
+            REQUIRE_CALL(*mock, send(_)).THROW(std::runtime_error{"Intentional"});
+            db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+            db.write(Point{"y"}.setTimestamp(ignoreTimestamp));
+        }
+        CHECK(db.batchSize() == 2);
+        db.write(Point{"z"}.setTimestamp(ignoreTimestamp));
+
+        REQUIRE_CALL(*mock, send("x 4567000000\ny 4567000000\nz 4567000000\nw 4567000000"));
+        db.write(Point{"w"}.setTimestamp(ignoreTimestamp));
+        CHECK(db.batchSize() == 0);
+        CHECK(db.bufferStatistics().failedFlushes == 1);
+    }
+
+    TEST_CASE("Buffer limit fails fast if full", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(10);
+        db.setBufferLimit(2, 1000, InfluxDB::OverflowPolicy::FailFast);
+        db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+        db.write(Point{"y"}.setTimestamp(ignoreTimestamp));
+
+        CHECK_THROWS_AS(db.write(Point{"z"}.setTimestamp(ignoreTimestamp)), InfluxDBException);
+        CHECK(db.batchSize() == 2);
+        CHECK(db.bufferStatistics().rejected == 1);
+    }
+
+    TEST_CASE("Buffer limit drops newest if full", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        std::vector<std::string> dropped;
+        db.setDropCallback([&dropped](const Point& point)
+                           { dropped.push_back(point.getName()); });
+        db.batchOf(10);
+        db.setBufferLimit(2, 1000, InfluxDB::OverflowPolicy::DropNewest);
+        db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+        db.write(Point{"y"}.setTimestamp(ignoreTimestamp));
+        db.write(Point{"z"}.setTimestamp(ignoreTimestamp));
+
+        CHECK(dropped == std::vector<std::string>{"z"});
+        CHECK(db.bufferStatistics().dropped == 1);
+
+        REQUIRE_CALL(*mock, send("x 4567000000\ny 4567000000"));
+        db.flushBatch();
+    }
+
+    TEST_CASE("Buffer limit drops oldest if full", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        std::vector<std::string> dropped;
+        db.setDropCallback([&dropped](const Point& point)
+                           { dropped.push_back(point.getName()); });
+        db.batchOf(10);
+        db.setBufferLimit(2, 1000, InfluxDB::OverflowPolicy::DropOldest);
+        db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+        db.write(Point{"y"}.setTimestamp(ignoreTimestamp));
+        db.write(Point{"z"}.setTimestamp(ignoreTimestamp));
+
+        CHECK(dropped == std::vector<std::string>{"x"});
+
+        REQUIRE_CALL(*mock, send("y 4567000000\nz 4567000000"));
+        db.flushBatch();
+    }
+
+    TEST_CASE("Buffer limit applies to bytes", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(10);
+        db.setBufferLimit(10, 100, InfluxDB::OverflowPolicy::DropOldest);
+        db.write(Point{"x"}.addField("value", std::string(40, 'a')).setTimestamp(ignoreTimestamp));
+        db.write(Point{"y"}.addField("value", std::string(40, 'b')).setTimestamp(ignoreTimestamp));
+
+        CHECK(db.batchSize() == 1);
+        CHECK(db.bufferStatistics().dropped == 1);
+    }
+
+    TEST_CASE("Buffer limit blocks until flush makes room", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(10);
+        db.setBufferLimit(1, 1000, InfluxDB::OverflowPolicy::Block);
+        db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+
+        REQUIRE_CALL(*mock, send("x 4567000000"));
+        db.write(Point{"y"}.setTimestamp(ignoreTimestamp));
+        CHECK(db.batchSize() == 1);
+        CHECK(db.bufferStatistics().blocked == 1);
+    }
+
+    TEST_CASE("Buffer limit throws if blocking times out", "[InfluxDBTest]")
+    {
+        using trompeloeil::_;
+
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(10);
+        db.setBufferLimit(1, 1000, InfluxDB::OverflowPolicy::Block, std::chrono::milliseconds{30});
+        db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+
+        ALLOW_CALL(*mock, send(_)).THROW(std::runtime_error{"Intentional"});
+        CHECK_THROWS_AS(db.write(Point{"y"}.setTimestamp(ignoreTimestamp)), InfluxDBException);
+        CHECK(db.batchSize() == 1);
+        CHECK(db.bufferStatistics().rejected == 1);
+        CHECK(db.bufferStatistics().failedFlushes >= 2);
+    }
+
+    TEST_CASE("Buffer limit throws on zero limits", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        CHECK_THROWS_AS(db.setBufferLimit(0, 1000, InfluxDB::OverflowPolicy::FailFast), InfluxDBException);
+        CHECK_THROWS_AS(db.setBufferLimit(10, 0, InfluxDB::OverflowPolicy::FailFast), InfluxDBException);
+    }
+
     TEST_CASE("Flush batch does nothing if batch disabled", "[InfluxDBTest]")
     {
         auto mock = std::make_shared<TransportMock>();
@@ -164,6 +540,51 @@ namespace influxdb::test
         CHECK(db.batchSize() == 0);
     }
 
+    TEST_CASE("Batch memory resource keeps pending points", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        CountingResource resource;
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.batchOf(10);
+        db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+        db.setBatchMemoryResource(&resource);
+        CHECK(db.batchSize() == 1);
+        CHECK(resource.outstandingBytes > 0);
+
+        REQUIRE_CALL(*mock, send("x 4567000000"));
+        db.flushBatch();
+    }
+
+    TEST_CASE("Flush batch releases batch memory resource", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        CountingResource resource;
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.setBatchMemoryResource(&resource);
+        db.batchOf(10);
+        db.write(Point{"x", &resource}.addTag("long-tag-name", "long-tag-value-exceeding-small-strings").setTimestamp(ignoreTimestamp));
+        db.write(Point{"y", &resource}.setTimestamp(ignoreTimestamp));
+        CHECK(resource.outstandingBytes > 0);
+
+        REQUIRE_CALL(*mock, send("x,long-tag-name=long-tag-value-exceeding-small-strings 4567000000\ny 4567000000"));
+        db.flushBatch();
+        CHECK(resource.outstandingBytes == 0);
+    }
+
+    TEST_CASE("Clear batch releases batch memory resource", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        CountingResource resource;
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.setBatchMemoryResource(&resource);
+        db.batchOf(10);
+        db.write(Point{"x", &resource}.setTimestamp(ignoreTimestamp));
+
+        db.clearBatch();
+        CHECK(db.batchSize() == 0);
+        CHECK(resource.outstandingBytes == 0);
+    }
+
     TEST_CASE("Create database throws if unsupported by transport", "[InfluxDBTest]")
     {
         auto mock = std::make_shared<TransportMock>();
@@ -192,4 +613,55 @@ namespace influxdb::test
         const auto result = db.execute("show databases");
         CHECK(result == response);
     }
+
+    TEST_CASE("Observer is notified of batched writes", "[InfluxDBTest]")
+    {
+        using trompeloeil::_;
+
+        auto mock = std::make_shared<TransportMock>();
+        RecordingObserver observer;
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.setObserver(&observer);
+        db.batchOf(2);
+
+        REQUIRE_CALL(*mock, send(_));
+        db.write(Point{"x"}.setTimestamp(ignoreTimestamp));
+        db.write(Point{"y"}.setTimestamp(ignoreTimestamp));
+
+        CHECK(observer.events == std::vector<std::string>{"write x", "write y", "sealed 2", "serialize 2", "serialized 25", "send 25", "sent 25"});
+    }
+
+    TEST_CASE("Observer is notified of failed sends", "[InfluxDBTest]")
+    {
+        using trompeloeil::_;
+
+        auto mock = std::make_shared<TransportMock>();
+        RecordingObserver observer;
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.setObserver(&observer);
+
+        REQUIRE_CALL(*mock, send(_)).THROW(std::runtime_error{"Intentional"});
+        CHECK_THROWS(db.write(Point{"x"}.setTimestamp(ignoreTimestamp)));
+
+        CHECK(observer.events == std::vector<std::string>{"write x", "serialize 1", "serialized 12", "send 12", "sent 12 Intentional"});
+    }
+
+    TEST_CASE("Observer is notified of queries", "[InfluxDBTest]")
+    {
+        auto mock = std::make_shared<TransportMock>();
+        RecordingObserver observer;
+        InfluxDB db{std::make_unique<TransportAdapter>(mock)};
+        db.setObserver(&observer);
+
+        {
+            REQUIRE_CALL(*mock, execute("show databases")).RETURN("");
+            db.execute("show databases");
+        }
+        {
+            REQUIRE_CALL(*mock, execute("drop all")).THROW(InfluxDBException{"Intentional"});
+            CHECK_THROWS(db.execute("drop all"));
+        }
+
+        CHECK(observer.events == std::vector<std::string>{"query show databases", "queried show databases", "query drop all", "queried drop all Intentional"});
+    }
 }
@@ -0,0 +1,199 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LineProtocolParser.h"
+#include "InfluxDBException.h"
+#include "LineProtocol.h"
+#include <string>
+#include <utility>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+namespace influxdb::test
+{
+    using namespace Catch::Matchers;
+    using Pairs = std::vector<std::pair<std::string_view, std::string_view>>;
+
+    namespace
+    {
+        Pairs tagsOf(const PointView& view)
+        {
+            Pairs tags;
+            view.forEachTag([&tags](auto key, auto value)
+                            { tags.emplace_back(key, value); });
+            return tags;
+        }
+
+        Pairs fieldsOf(const PointView& view)
+        {
+            Pairs fields;
+            view.forEachField([&fields](auto key, auto value)
+                              { fields.emplace_back(key, value); });
+            return fields;
+        }
+    }
+
+    TEST_CASE("Parse line with tags, fields and timestamp", "[LineProtocolParserTest]")
+    {
+        const std::string input{"cpu,host=server01,region=eu usage=0.5,count=3i 1572830915000000000"};
+        const auto view = LineProtocolParser::parseLine(input);
+
+        CHECK(view.measurement() == "cpu");
+        CHECK(view.tags() == "host=server01,region=eu");
+        CHECK(view.fields() == "usage=0.5,count=3i");
+        CHECK(view.timestamp() == 1572830915000000000);
+        CHECK(view.line() == input);
+        CHECK(tagsOf(view) == Pairs{{"host", "server01"}, {"region", "eu"}});
+        CHECK(fieldsOf(view) == Pairs{{"usage", "0.5"}, {"count", "3i"}});
+    }
+
+    TEST_CASE("Views refer to the input", "[LineProtocolParserTest]")
+    {
+        const std::string input{"cpu value=1"};
+        const auto view = LineProtocolParser::parseLine(input);
+
+        CHECK(view.measurement().data() == input.data());
+        CHECK(view.fields().data() == input.data() + 4);
+    }
+
+    TEST_CASE("Parse line without tags and timestamp", "[LineProtocolParserTest]")
+    {
+        const auto view = LineProtocolParser::parseLine("cpu value=1");
+
+        CHECK(view.measurement() == "cpu");
+        CHECK(view.tags().empty());
+        CHECK(view.fields() == "value=1");
+        CHECK(view.timestamp() == std::nullopt);
+    }
+
+    TEST_CASE("Parse escaped characters and string fields", "[LineProtocolParserTest]")
+    {
+        const auto view = LineProtocolParser::parseLine(R"(c\ p\,u,ho\=st=a\ b,x=y s="a, b=c \"d\"",v=1 10)");
+
+        CHECK(view.measurement() == R"(c\ p\,u)");
+        CHECK(tagsOf(view) == Pairs{{R"(ho\=st)", R"(a\ b)"}, {"x", "y"}});
+        CHECK(fieldsOf(view) == Pairs{{"s", R"("a, b=c \"d\"")"}, {"v", "1"}});
+        CHECK(view.timestamp() == 10);
+    }
+
+    TEST_CASE("Parser iterates over lines", "[LineProtocolParserTest]")
+    {
+        LineProtocolParser parser{"# comment\ncpu value=1\r\n\nmem value=2\ndisk value=3"};
+
+        CHECK(parser.next()->measurement() == "cpu");
+        CHECK(parser.lineNumber() == 2);
+        CHECK(parser.next()->measurement() == "mem");
+        CHECK(parser.lineNumber() == 4);
+        const auto last = parser.next();
+        CHECK(last->measurement() == "disk");
+        CHECK(last->fields() == "value=3");
+        CHECK(parser.next() == std::nullopt);
+        CHECK(parser.next() == std::nullopt);
+    }
+
+    TEST_CASE("Parser reports malformed line and continues", "[LineProtocolParserTest]")
+    {
+        LineProtocolParser parser{"cpu value=1\ncpu\nmem value=2\n"};
+
+        CHECK(parser.next()->measurement() == "cpu");
+        CHECK_THROWS_WITH(parser.next(), "Line 2: missing fields");
+        CHECK(parser.next()->measurement() == "mem");
+        CHECK(parser.next() == std::nullopt);
+    }
+
+    TEST_CASE("Malformed lines are rejected", "[LineProtocolParserTest]")
+    {
+        for (const std::string_view line : {" value=1",
+                                            "cpu",
+                                            "cpu,host value=1",
+                                            "cpu,=a value=1",
+                                            "cpu,host= value=1",
+                                            "cpu,host=a",
+                                            "cpu ",
+                                            "cpu value",
+                                            "cpu =1",
+                                            "cpu value=",
+                                            "cpu value=abc",
+                                            "cpu value=1.2.3",
+                                            "cpu value=1e",
+                                            "cpu value=1.5i",
+                                            "cpu value=-1u",
+                                            "cpu value=99999999999999999999i",
+                                            "cpu value=\"abc",
+                                            "cpu value=\"abc\"x",
+                                            "cpu value=abc\"",
+                                            "cpu value=1,",
+                                            "cpu value=1 abc",
+                                            "cpu value=1 ",
+                                            "cpu value=1 10 20"})
+        {
+            CAPTURE(line);
+            CHECK_THROWS_AS(LineProtocolParser::parseLine(line), InfluxDBException);
+        }
+    }
+
+    TEST_CASE("Valid field values are accepted", "[LineProtocolParserTest]")
+    {
+        for (const std::string_view line : {"cpu value=1",
+                                            "cpu value=-1.5",
+                                            "cpu value=.5",
+                                            "cpu value=1.",
+                                            "cpu value=1e10",
+                                            "cpu value=-1.5E-3",
+                                            "cpu value=-12i",
+                                            "cpu value=12u",
+                                            "cpu value=t",
+                                            "cpu value=FALSE",
+                                            "cpu value=\"\"",
+                                            "cpu value=\"a b\" -10"})
+        {
+            CAPTURE(line);
+            CHECK_NOTHROW(LineProtocolParser::parseLine(line));
+        }
+    }
+
+    TEST_CASE("Point view converts to point", "[LineProtocolParserTest]")
+    {
+        const std::string input{R"(c\ pu,ho\=st=a\,b f=1.5,i=-3i,u=4u,b=true,s="x \"y\" \\z" 1572830915000000000)"};
+        const auto point = LineProtocolParser::parseLine(input).toPoint();
+
+        CHECK(point.getName() == "c pu");
+        CHECK(point.getTimestamp().time_since_epoch() == std::chrono::nanoseconds{1572830915000000000});
+
+        const LineProtocol formatter;
+        CHECK_THAT(formatter.format(point), Equals(R"(c\ pu,ho\=st=a\,b f=1.500000000000000000,i=-3i,u=4u,b=true,s="x \"y\" \\z" 1572830915000000000)"));
+    }
+
+    TEST_CASE("Long lines use vectorized search", "[LineProtocolParserTest]")
+    {
+        const std::string tagValue(100, 'v');
+        const std::string input{"measurement_with_a_long_name,host=" + tagValue + ",region=eu field_with_long_name=\"" + std::string(70, 's') + "\",other=1i 1"};
+        const auto view = LineProtocolParser::parseLine(input);
+
+        CHECK(view.measurement() == "measurement_with_a_long_name");
+        CHECK(tagsOf(view) == Pairs{{"host", tagValue}, {"region", "eu"}});
+        CHECK(fieldsOf(view).size() == 2);
+        CHECK(fieldsOf(view)[1] == std::pair<std::string_view, std::string_view>{"other", "1i"});
+        CHECK(view.timestamp() == 1);
+    }
+}
@@ -139,4 +139,30 @@ namespace influxdb::test
         const LineProtocol lineProtocol{"a=0,b=1,c=2"};
         CHECK_THAT(lineProtocol.format(point), Equals(R"(p1,a=0,b=1,c=2,pointtag=3 n=1i 54000000)"));
     }
+
+    TEST_CASE("Escapes measurement", "[LineProtocolTest]")
+    {
+        const auto point = Point{"cpu load,avg"}.addField("n", 0).setTimestamp(ignoreTimestamp);
+        const LineProtocol lineProtocol;
+        CHECK_THAT(lineProtocol.format(point), Equals(R"(cpu\ load\,avg n=0i 54000000)"));
+    }
+
+    TEST_CASE("Escapes tags", "[LineProtocolTest]")
+    {
+        const auto point = Point{"p0"}
+                               .addField("n", 0)
+                               .addTag("tag key", "a,b=c")
+                               .setTimestamp(ignoreTimestamp);
+        const LineProtocol lineProtocol;
+        CHECK_THAT(lineProtocol.format(point), Equals(R"(p0,tag\ key=a\,b\=c n=0i 54000000)"));
+    }
+
+    TEST_CASE("Escapes fields", "[LineProtocolTest]")
+    {
+        const auto point = Point{"p0"}
+                               .addField("field key=", R"(say "hi" \o/)")
+                               .setTimestamp(ignoreTimestamp);
+        const LineProtocol lineProtocol;
+        CHECK_THAT(lineProtocol.format(point), Equals(R"(p0 field\ key\=="say \"hi\" \\o/" 54000000)"));
+    }
 }
@@ -0,0 +1,183 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LoadShedder.h"
+#include "InfluxDBException.h"
+#include <catch2/catch_test_macros.hpp>
+
+namespace influxdb::test
+{
+    using namespace std::chrono_literals;
+
+    namespace
+    {
+        Point sample(const std::string& host)
+        {
+            return Point{"cpu"}.addTag("host", host).addField("value", 1);
+        }
+
+        void succeed(LoadShedder& shedder, int times)
+        {
+            for (int i = 0; i < times; ++i)
+            {
+                shedder.update(1ms, false);
+            }
+        }
+
+        void fail(LoadShedder& shedder, int times)
+        {
+            for (int i = 0; i < times; ++i)
+            {
+                shedder.update(0ms, true);
+            }
+        }
+    }
+
+    TEST_CASE("Load shedder throws on invalid parameters", "[LoadShedderTest]")
+    {
+        CHECK_THROWS_AS(LoadShedder(0ms), InfluxDBException);
+        CHECK_THROWS_AS(LoadShedder(100ms, 0), InfluxDBException);
+    }
+
+    TEST_CASE("Load shedder keeps all points while healthy", "[LoadShedderTest]")
+    {
+        LoadShedder shedder{100ms};
+        shedder.update(10ms, false);
+
+        auto point = sample("a");
+        CHECK(shedder.admit(point));
+        CHECK(point.getFields() == "value=1i");
+        CHECK(shedder.samplingFactor() == 1);
+    }
+
+    TEST_CASE("Load shedder doubles sampling factor on failures up to maximum", "[LoadShedderTest]")
+    {
+        LoadShedder shedder{100ms, 8};
+
+        fail(shedder, 2);
+        CHECK(shedder.samplingFactor() == 4);
+
+        fail(shedder, 3);
+        CHECK(shedder.samplingFactor() == 8);
+    }
+
+    TEST_CASE("Load shedder raises sampling factor on slow sends", "[LoadShedderTest]")
+    {
+        LoadShedder shedder{100ms};
+        shedder.update(200ms, false);
+        CHECK(shedder.samplingFactor() == 1);
+
+        shedder.update(1s, false);
+        CHECK(shedder.samplingFactor() == 2);
+    }
+
+    TEST_CASE("Load shedder keeps one of n points per series", "[LoadShedderTest]")
+    {
+        LoadShedder shedder{100ms};
+        fail(shedder, 2);
+
+        int keptA{0};
+        int keptB{0};
+        for (int i = 0; i < 8; ++i)
+        {
+            auto a = sample("a");
+            keptA += shedder.admit(a) ? 1 : 0;
+
+            if (i == 0)
+            {
+                CHECK(a.getFields() == "value=1i,sample_rate=4i");
+            }
+
+            auto b = sample("b");
+            keptB += shedder.admit(b) ? 1 : 0;
+        }
+
+        CHECK(keptA == 2);
+        CHECK(keptB == 2);
+        CHECK(shedder.dropped() == 12);
+    }
+
+    TEST_CASE("Load shedder recovers when pressure drops", "[LoadShedderTest]")
+    {
+        LoadShedder shedder{100ms};
+        fail(shedder, 3);
+        CHECK(shedder.samplingFactor() == 8);
+
+        succeed(shedder, 9);
+        CHECK(shedder.samplingFactor() == 8);
+
+        succeed(shedder, 1);
+        CHECK(shedder.samplingFactor() == 4);
+
+        shedder.update(400ms, false);
+        succeed(shedder, 9);
+        CHECK(shedder.samplingFactor() == 4);
+
+        succeed(shedder, 20);
+        CHECK(shedder.samplingFactor() == 1);
+
+        auto point = sample("a");
+        CHECK(shedder.admit(point));
+        CHECK(point.getFields() == "value=1i");
+    }
+
+    TEST_CASE("Load shedder marks points with configured field", "[LoadShedderTest]")
+    {
+        LoadShedder shedder{100ms, 8, "weight"};
+        fail(shedder, 1);
+
+        auto point = sample("a");
+        CHECK(shedder.admit(point));
+        CHECK(point.getFields() == "value=1i,weight=2i");
+    }
+
+    TEST_CASE("Load shedder keeps existing marker field", "[LoadShedderTest]")
+    {
+        LoadShedder shedder{100ms};
+        fail(shedder, 1);
+
+        auto point = sample("a").addField("sample_rate", 10);
+        CHECK(shedder.admit(point));
+        CHECK(point.getFields() == "value=1i,sample_rate=10i");
+    }
+
+    TEST_CASE("Load shedder leaves points unmarked without field name", "[LoadShedderTest]")
+    {
+        LoadShedder shedder{100ms, 8, ""};
+        fail(shedder, 1);
+
+        auto point = sample("a");
+        CHECK(shedder.admit(point));
+        CHECK(point.getFields() == "value=1i");
+    }
+
+    TEST_CASE("Load shedder samples series independent of tag order", "[LoadShedderTest]")
+    {
+        LoadShedder shedder{100ms};
+        fail(shedder, 1);
+
+        auto first = Point{"cpu"}.addTag("host", "a").addTag("dc", "x").addField("value", 1);
+        auto second = Point{"cpu"}.addTag("dc", "x").addTag("host", "a").addField("value", 1);
+        CHECK(shedder.admit(first));
+        CHECK_FALSE(shedder.admit(second));
+    }
+}
@@ -0,0 +1,198 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LoadGenerator.h"
+#include "MockHttpServer.h"
+#include "InfluxDBException.h"
+#include "LineProtocol.h"
+#include <set>
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+namespace influxdb::test
+{
+    using namespace Catch::Matchers;
+    using namespace std::chrono_literals;
+    using loadgen::LoadGenerator;
+    using loadgen::Workload;
+
+    namespace
+    {
+        std::string formatted(const Point& point)
+        {
+            return LineProtocol{}.format(point);
+        }
+
+        std::string seriesOf(const Point& point)
+        {
+            const auto line = formatted(point);
+            return line.substr(0, line.find(' '));
+        }
+    }
+
+    TEST_CASE("Workload cycles through distinct series", "[LoadgenTest]")
+    {
+        Workload::Configuration configuration;
+        configuration.series = 25;
+        configuration.tags = 2;
+        configuration.tagCardinality = 5;
+        configuration.fields = 2;
+        Workload workload{configuration};
+        std::set<std::string> series;
+
+        for (std::size_t i = 0; i < configuration.series; ++i)
+        {
+            series.insert(seriesOf(workload.next()));
+        }
+
+        CHECK(series.size() == 25);
+        CHECK(series.count("loadgen,tag0=value0,tag1=value0") == 1);
+        CHECK(series.count("loadgen,tag0=value4,tag1=value4") == 1);
+        CHECK(seriesOf(workload.next()) == "loadgen,tag0=value0,tag1=value0");
+    }
+
+    TEST_CASE("Workload advances timestamps each round", "[LoadgenTest]")
+    {
+        Workload::Configuration configuration;
+        configuration.series = 2;
+        configuration.interval = 1s;
+        Workload workload{configuration};
+
+        CHECK(workload.next().getTimestamp() == configuration.start);
+        CHECK(workload.next().getTimestamp() == configuration.start);
+        CHECK(workload.next().getTimestamp() == configuration.start + 1s);
+    }
+
+    TEST_CASE("Workload shuffles timestamps within window", "[LoadgenTest]")
+    {
+        Workload::Configuration configuration;
+        configuration.series = 1;
+        configuration.interval = 1s;
+        configuration.shuffleWindow = 10;
+        Workload workload{configuration};
+        bool outOfOrder{false};
+        auto previous = configuration.start;
+
+        for (int round = 0; round < 100; ++round)
+        {
+            const auto timestamp = workload.next().getTimestamp();
+            CHECK(timestamp <= configuration.start + std::chrono::seconds{round});
+            CHECK(timestamp > configuration.start + std::chrono::seconds{round - 10});
+            outOfOrder = outOfOrder || timestamp < previous;
+            previous = timestamp;
+        }
+        CHECK(outOfOrder);
+    }
+
+    TEST_CASE("Workload generates field types", "[LoadgenTest]")
+    {
+        Workload::Configuration configuration;
+        configuration.series = 1;
+        configuration.fields = 1;
+
+        configuration.fieldType = Workload::FieldType::Integer;
+        CHECK_THAT(formatted(Workload{configuration}.next()), Matches(R"(\S+ field0=\d+i \d+)"));
+
+        configuration.fieldType = Workload::FieldType::Boolean;
+        CHECK_THAT(formatted(Workload{configuration}.next()), Matches(R"(\S+ field0=(true|false) \d+)"));
+
+        configuration.fieldType = Workload::FieldType::String;
+        CHECK_THAT(formatted(Workload{configuration}.next()), Matches(R"(\S+ field0="value\d+" \d+)"));
+    }
+
+    TEST_CASE("Workload generates devops cpu data", "[LoadgenTest]")
+    {
+        Workload::Configuration configuration;
+        configuration.series = 4;
+        configuration.devops = true;
+        const auto line = formatted(Workload{configuration}.next());
+
+        CHECK_THAT(line, StartsWith("cpu,hostname=host_0,region="));
+        CHECK_THAT(line, ContainsSubstring(",service_environment="));
+        CHECK_THAT(line, ContainsSubstring(" usage_user="));
+        CHECK_THAT(line, ContainsSubstring(",usage_guest_nice="));
+    }
+
+    TEST_CASE("Workload splits series between workers", "[LoadgenTest]")
+    {
+        Workload::Configuration configuration;
+        configuration.series = 10;
+
+        CHECK(Workload{configuration, 0, 3}.series() == 4);
+        CHECK(Workload{configuration, 2, 3}.series() == 3);
+        CHECK(seriesOf(Workload{configuration, 1, 3}.next()) == "loadgen,tag0=value1,tag1=value0,tag2=value0");
+        CHECK_THROWS_AS((Workload{configuration, 3, 3}), InfluxDBException);
+    }
+
+    TEST_CASE("Load generator writes points from all threads", "[LoadgenTest]")
+    {
+        MockHttpServer server;
+        server.setRecordRequests(false);
+        LoadGenerator::Configuration configuration;
+        configuration.url = server.url() + "?db=test";
+        configuration.threads = 3;
+        configuration.batchSize = 100;
+        configuration.points = 1000;
+        configuration.workload.series = 30;
+
+        const auto report = LoadGenerator{configuration}.run();
+
+        CHECK(report.points == 1000);
+        CHECK(report.errors == 0);
+        CHECK(report.bytes == server.statistics().bytes);
+        CHECK(server.statistics().lines == 1000);
+        CHECK(report.writeLatency.count() == 1000);
+        CHECK(report.sendLatency.count() == server.statistics().writes);
+    }
+
+    TEST_CASE("Load generator limits rate", "[LoadgenTest]")
+    {
+        MockHttpServer server;
+        LoadGenerator::Configuration configuration;
+        configuration.url = server.url() + "?db=test";
+        configuration.threads = 2;
+        configuration.rate = 1000.0;
+        configuration.points = 200;
+
+        const auto report = LoadGenerator{configuration}.run();
+
+        CHECK(report.points == 200);
+        CHECK(report.elapsed >= 99ms);
+    }
+
+    TEST_CASE("Load generator counts errors", "[LoadgenTest]")
+    {
+        MockHttpServer server{[](const MockHttpServer::Request&)
+                              { return MockHttpServer::Response{500, "", {}}; }};
+        LoadGenerator::Configuration configuration;
+        configuration.url = server.url() + "?db=test";
+        configuration.batchSize = 10;
+        configuration.points = 100;
+
+        const auto report = LoadGenerator{configuration}.run();
+
+        CHECK(report.points == 100);
+        CHECK(report.errors == 10);
+        CHECK(report.bytes == 0);
+    }
+}
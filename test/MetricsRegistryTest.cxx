@@ -0,0 +1,158 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MetricsRegistry.h"
+#include "InfluxDBException.h"
+#include "mock/RecordingTransport.h"
+#include <thread>
+#include <catch2/catch_test_macros.hpp>
+
+namespace influxdb::test
+{
+    using namespace std::chrono_literals;
+
+    namespace
+    {
+        /// Client recording the lines it sends
+        struct RecordingDb
+        {
+            Recorder recorder{};
+            InfluxDB db{std::make_unique<RecordingTransport>(recorder)};
+
+            std::vector<std::string> take()
+            {
+                return recorder.take();
+            }
+        };
+    }
+
+    TEST_CASE("Metrics registry throws on invalid interval", "[MetricsRegistryTest]")
+    {
+        RecordingDb recorder;
+        CHECK_THROWS_AS(MetricsRegistry(recorder.db, 0ms), InfluxDBException);
+    }
+
+    TEST_CASE("Counter sums increments of all threads", "[MetricsRegistryTest]")
+    {
+        Counter counter;
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < 8; ++t)
+        {
+            threads.emplace_back([&counter]
+                                 {
+                                     for (int i = 0; i < 10000; ++i)
+                                     {
+                                         counter.increment();
+                                     } });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        counter.increment(5);
+        CHECK(counter.value() == 80005);
+    }
+
+    TEST_CASE("Gauge holds last value", "[MetricsRegistryTest]")
+    {
+        Gauge gauge;
+        gauge.set(3.5);
+        gauge.add(-1.0);
+        CHECK(gauge.value() == 2.5);
+    }
+
+    TEST_CASE("Metrics registry returns same metric for same name and tags", "[MetricsRegistryTest]")
+    {
+        RecordingDb recorder;
+        MetricsRegistry registry{recorder.db, 1h};
+
+        auto& counter = registry.counter("requests", {{"route", "/a"}, {"method", "GET"}});
+        CHECK(&counter == &registry.counter("requests", {{"method", "GET"}, {"route", "/a"}}));
+        CHECK(&counter != &registry.counter("requests", {{"method", "PUT"}, {"route", "/a"}}));
+        CHECK(&counter != &registry.counter("requests"));
+    }
+
+    TEST_CASE("Metrics registry writes snapshot of all metrics", "[MetricsRegistryTest]")
+    {
+        RecordingDb recorder;
+        MetricsRegistry registry{recorder.db, 1h};
+
+        registry.counter("requests", {{"route", "/a"}}).increment(3);
+        registry.gauge("queue").set(1.5);
+        registry.histogram("latency").record(2.0);
+        registry.flush();
+
+        CHECK(recorder.take() == std::vector<std::string>{"requests,route=/a value=3i",
+                                                          "queue value=1.500000000000000000",
+                                                          "latency count=1i,sum=2.000000000000000000,min=2.000000000000000000,max=2.000000000000000000,"
+                                                          "mean=2.000000000000000000,p50=2.000000000000000000,p90=2.000000000000000000,"
+                                                          "p95=2.000000000000000000,p99=2.000000000000000000,p99_9=2.000000000000000000"});
+        CHECK(registry.statistics().flushes == 1);
+        CHECK(registry.statistics().points == 3);
+
+        registry.counter("requests", {{"route", "/a"}}).increment();
+        registry.flush();
+
+        CHECK(recorder.take() == std::vector<std::string>{"requests,route=/a value=4i",
+                                                          "queue value=1.500000000000000000",
+                                                          "latency count=0i,sum=0.000000000000000000"});
+    }
+
+    TEST_CASE("Metrics registry writes nothing without metrics", "[MetricsRegistryTest]")
+    {
+        RecordingDb recorder;
+        MetricsRegistry registry{recorder.db, 1h};
+        registry.flush();
+
+        CHECK(recorder.take().empty());
+        CHECK(registry.statistics().flushes == 0);
+    }
+
+    TEST_CASE("Metrics registry writes periodically and on destruction", "[MetricsRegistryTest]")
+    {
+        RecordingDb recorder;
+        {
+            MetricsRegistry registry{recorder.db, 10ms};
+            registry.counter("ticks").increment();
+            std::this_thread::sleep_for(50ms);
+
+            CHECK(registry.statistics().flushes >= 2);
+        }
+
+        const auto lines = recorder.take();
+        REQUIRE_FALSE(lines.empty());
+        CHECK(lines.back() == "ticks value=1i");
+    }
+
+    TEST_CASE("Metrics registry counts failed snapshots", "[MetricsRegistryTest]")
+    {
+        Recorder recorder;
+        InfluxDB db{std::make_unique<RecordingTransport>(recorder, 0, true)};
+        MetricsRegistry registry{db, 1h};
+
+        registry.gauge("queue").set(1.0);
+        CHECK_THROWS_AS(registry.flush(), InfluxDBException);
+        CHECK(registry.statistics().failures == 1);
+    }
+}
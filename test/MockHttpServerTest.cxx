@@ -0,0 +1,275 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MockHttpServer.h"
+#include <array>
+#include <chrono>
+#include <string>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+#ifdef MOCK_HTTP_SERVER_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace influxdb::test
+{
+    using namespace Catch::Matchers;
+    using namespace std::chrono_literals;
+
+    namespace
+    {
+        /// Sends a raw request on a new connection, returns everything received until closed
+        std::string roundTrip(const MockHttpServer& server, const std::string& request)
+        {
+            const int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            address.sin_port = htons(static_cast<std::uint16_t>(server.port()));
+            REQUIRE(::connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+            REQUIRE(::send(fd, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+
+            std::string response;
+            std::array<char, 4096> buffer;
+            ssize_t length;
+
+            while ((length = ::recv(fd, buffer.data(), buffer.size(), 0)) > 0)
+            {
+                response.append(buffer.data(), static_cast<std::size_t>(length));
+            }
+            ::close(fd);
+            return response;
+        }
+
+        std::string get(const MockHttpServer& server, const std::string& target, const std::string& headers = "")
+        {
+            return roundTrip(server, "GET " + target + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n" + headers + "\r\n");
+        }
+
+        std::string post(const MockHttpServer& server, const std::string& target, const std::string& body, const std::string& headers = "")
+        {
+            return roundTrip(server, "POST " + target + " HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n" + headers
+                                        + "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body);
+        }
+
+        std::size_t occurrences(const std::string& text, const std::string& pattern)
+        {
+            std::size_t count{0};
+
+            for (auto position = text.find(pattern); position != std::string::npos; position = text.find(pattern, position + 1))
+            {
+                ++count;
+            }
+            return count;
+        }
+    }
+
+    TEST_CASE("Write is accepted and counted", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        const std::string body{"cpu value=1 1\n\nmem value=2 2\nnet value=3 3"};
+
+        CHECK_THAT(post(server, "/write?db=test", body), StartsWith("HTTP/1.1 204 No Content\r\n"));
+
+        const auto statistics = server.statistics();
+        CHECK(statistics.requests == 1);
+        CHECK(statistics.writes == 1);
+        CHECK(statistics.bytes == body.size());
+        CHECK(statistics.lines == 3);
+        REQUIRE(server.requests().size() == 1);
+        CHECK(server.requests().front().body == body);
+    }
+
+    TEST_CASE("Ping answers with version", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+
+        const auto response = get(server, "/ping");
+        CHECK_THAT(response, StartsWith("HTTP/1.1 204 No Content\r\n"));
+        CHECK_THAT(response, ContainsSubstring("X-Influxdb-Version: mock\r\n"));
+        CHECK(server.statistics().writes == 0);
+    }
+
+    TEST_CASE("Unknown paths are not found", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        CHECK_THAT(get(server, "/unknown"), StartsWith("HTTP/1.1 404 Not Found\r\n"));
+    }
+
+    TEST_CASE("Query answers with canned response", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        CHECK_THAT(get(server, "/query?db=test&q=show+databases"), EndsWith(R"({"results":[{"statement_id":0}]})"));
+
+        server.setQueryResponse(R"({"results":[{"statement_id":0,"series":[]}]})");
+        CHECK_THAT(get(server, "/query?db=test&q=show+databases"), EndsWith(R"({"results":[{"statement_id":0,"series":[]}]})"));
+    }
+
+    TEST_CASE("Query answers with generated rows", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        server.setGeneratedQueryRows(3);
+
+        const auto response = get(server, "/query?db=test&q=select+*+from+mock");
+        CHECK_THAT(response, EndsWith(R"("values":[["2023-01-01T00:00:00.000000000Z",0],["2023-01-01T00:00:00.000000001Z",1],)"
+                                      R"(["2023-01-01T00:00:00.000000002Z",2]]}]}]})"));
+    }
+
+    TEST_CASE("Query answers chunked if requested", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        server.setGeneratedQueryRows(5);
+
+        const auto response = get(server, "/query?db=test&q=select+*+from+mock&chunked=true&chunk_size=2");
+        CHECK_THAT(response, ContainsSubstring("Transfer-Encoding: chunked\r\n"));
+        CHECK(occurrences(response, R"({"results")") == 3);
+        CHECK(occurrences(response, R"("partial":true)") == 2);
+        CHECK_THAT(response, EndsWith("\r\n0\r\n\r\n"));
+    }
+
+    TEST_CASE("Handler replaces default behaviour", "[MockHttpServerTest]")
+    {
+        MockHttpServer server{[](const MockHttpServer::Request&)
+                              { return MockHttpServer::Response{400, "invalid", {}}; }};
+
+        const auto response = post(server, "/write?db=test", "cpu value=1");
+        CHECK_THAT(response, StartsWith("HTTP/1.1 400 Bad Request\r\n"));
+        CHECK_THAT(response, EndsWith("invalid"));
+        CHECK(server.statistics().lines == 1);
+    }
+
+    TEST_CASE("Faults inject errors", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        MockHttpServer::Faults faults;
+
+        SECTION("Error")
+        {
+            faults.errorRate = 1.0;
+            faults.errorStatus = 500;
+            server.setFaults(faults);
+            CHECK_THAT(post(server, "/write?db=test", "cpu value=1"), StartsWith("HTTP/1.1 500 Internal Server Error\r\n"));
+        }
+
+        SECTION("Throttled")
+        {
+            faults.throttleRate = 1.0;
+            faults.retryAfterSeconds = 3;
+            server.setFaults(faults);
+
+            const auto response = post(server, "/write?db=test", "cpu value=1");
+            CHECK_THAT(response, StartsWith("HTTP/1.1 429 Too Many Requests\r\n"));
+            CHECK_THAT(response, ContainsSubstring("Retry-After: 3\r\n"));
+        }
+
+        SECTION("Unavailable")
+        {
+            faults.unavailableRate = 1.0;
+            server.setFaults(faults);
+
+            const auto response = get(server, "/ping");
+            CHECK_THAT(response, StartsWith("HTTP/1.1 503 Service Unavailable\r\n"));
+            CHECK_THAT(response, ContainsSubstring("Retry-After: 1\r\n"));
+        }
+
+        SECTION("Reset")
+        {
+            faults.resetRate = 1.0;
+            server.setFaults(faults);
+            CHECK(post(server, "/write?db=test", "cpu value=1").empty());
+            CHECK(server.statistics().writes == 1);
+        }
+
+        SECTION("Fraction of requests")
+        {
+            faults.errorRate = 0.5;
+            server.setFaults(faults);
+            std::size_t errors{0};
+
+            for (int i = 0; i < 100; ++i)
+            {
+                errors += occurrences(get(server, "/ping"), " 500 ");
+            }
+            CHECK(errors > 25);
+            CHECK(errors < 75);
+        }
+    }
+
+    TEST_CASE("Faults inject latency", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        MockHttpServer::Faults faults;
+        faults.latency = 50ms;
+        server.setFaults(faults);
+
+        const auto start = std::chrono::steady_clock::now();
+        CHECK_THAT(get(server, "/ping"), StartsWith("HTTP/1.1 204"));
+        CHECK(std::chrono::steady_clock::now() - start >= 50ms);
+    }
+
+    TEST_CASE("Requests are not recorded if disabled", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        server.setRecordRequests(false);
+
+        post(server, "/write?db=test", "cpu value=1");
+        CHECK(server.requests().empty());
+        CHECK(server.statistics().lines == 1);
+    }
+
+#ifdef MOCK_HTTP_SERVER_WITH_ZLIB
+    TEST_CASE("Gzip bodies are decoded", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        const std::string body{"cpu value=1\nmem value=2\n"};
+        std::string compressed(compressBound(static_cast<uLong>(body.size())) + 32, '\0');
+        z_stream stream{};
+        deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(body.data()));
+        stream.avail_in = static_cast<uInt>(body.size());
+        stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+        stream.avail_out = static_cast<uInt>(compressed.size());
+        REQUIRE(deflate(&stream, Z_FINISH) == Z_STREAM_END);
+        compressed.resize(stream.total_out);
+        deflateEnd(&stream);
+
+        CHECK_THAT(post(server, "/write?db=test", compressed, "Content-Encoding: gzip\r\n"), StartsWith("HTTP/1.1 204"));
+        CHECK(server.statistics().bytes == body.size());
+        CHECK(server.statistics().lines == 2);
+        CHECK_THAT(post(server, "/write?db=test", "not gzip", "Content-Encoding: gzip\r\n"), StartsWith("HTTP/1.1 415"));
+    }
+
+    TEST_CASE("Query responses are compressed if accepted", "[MockHttpServerTest]")
+    {
+        MockHttpServer server;
+        const auto response = get(server, "/query?db=test&q=show+databases", "Accept-Encoding: gzip, deflate\r\n");
+
+        CHECK_THAT(response, ContainsSubstring("Content-Encoding: gzip\r\n"));
+        CHECK_THAT(response, !ContainsSubstring("statement_id"));
+    }
+#endif
+}
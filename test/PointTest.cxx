@@ -22,6 +22,10 @@
 
 #include "Point.h"
 #include <limits>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_all.hpp>
 
@@ -32,12 +36,36 @@ namespace influxdb::test
     namespace
     {
         constexpr std::chrono::time_point<std::chrono::system_clock> ignoreTimestamp(std::chrono::milliseconds(1230));
+
+        class CountingResource : public std::pmr::memory_resource
+        {
+        public:
+            std::size_t allocatedBytes{0};
+
+        private:
+            void* do_allocate(std::size_t bytes, std::size_t alignment) override
+            {
+                allocatedBytes += bytes;
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            }
+
+            void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+            {
+                std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+            }
+
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+            {
+                return this == &other;
+            }
+        };
     }
 
     TEST_CASE("Empty measurement", "[PointTest]")
     {
         const Point point{"test"};
         CHECK_THAT(point.getName(), Equals("test"));
+        CHECK(point.getNameView() == "test");
         CHECK_THAT(point.getFields(), Equals(""));
         CHECK_THAT(point.getTags(), Equals(""));
     }
@@ -138,6 +166,30 @@ namespace influxdb::test
         CHECK_THAT(point.getTags(), Equals("tag_0=value_0,tag_1=value_1,tag_2=value_2"));
     }
 
+    TEST_CASE("Measurement with more tags and fields than stored inline", "[PointTest]")
+    {
+        Point point{"test"};
+        for (int i = 0; i < 6; ++i)
+        {
+            point.addTag("t" + std::to_string(i), "v" + std::to_string(i)).addField("f" + std::to_string(i), i);
+        }
+        const auto copy = point;
+        CHECK_THAT(copy.getTags(), Equals("t0=v0,t1=v1,t2=v2,t3=v3,t4=v4,t5=v5"));
+        CHECK_THAT(copy.getFields(), Equals("f0=0i,f1=1i,f2=2i,f3=3i,f4=4i,f5=5i"));
+    }
+
+    TEST_CASE("Tags are escaped", "[PointTest]")
+    {
+        const auto point = Point{"test"}.addTag("tag name", "v=1,2");
+        CHECK_THAT(point.getTags(), Equals(R"(tag\ name=v\=1\,2)"));
+    }
+
+    TEST_CASE("Fields are escaped", "[PointTest]")
+    {
+        const auto point = Point{"test"}.addField("a,b", R"(quote " and backslash \)");
+        CHECK_THAT(point.getFields(), Equals(R"(a\,b="quote \" and backslash \\")"));
+    }
+
     TEST_CASE("Empty tag value is not added", "[PointTest]")
     {
         const auto point = Point{"test"}.addTag("tag", "");
@@ -150,6 +202,72 @@ namespace influxdb::test
         CHECK_THAT(point.getTags(), Equals(""));
     }
 
+    TEST_CASE("Measurement with interned tags", "[PointTest]")
+    {
+        StringPool pool;
+        const auto point = Point{"test"}
+                               .addTag("host", "localhost", pool)
+                               .addTag("region", "eu", pool);
+        CHECK_THAT(point.getTags(), Equals("host=localhost,region=eu"));
+        CHECK(pool.statistics().uniqueStrings == 4);
+    }
+
+    TEST_CASE("Interned tags are shared between points", "[PointTest]")
+    {
+        StringPool pool;
+        const auto point0 = Point{"test"}.addTag("host", "localhost", pool);
+        const auto point1 = Point{"test"}.addTag("host", "localhost", pool);
+        CHECK_THAT(point1.getTags(), Equals("host=localhost"));
+        CHECK(pool.statistics().uniqueStrings == 2);
+        CHECK(pool.statistics().bytesSaved == 13);
+    }
+
+    TEST_CASE("Tags are copied if pool is full", "[PointTest]")
+    {
+        StringPool pool{0};
+        const auto point = Point{"test"}.addTag("host", "localhost", pool);
+        CHECK_THAT(point.getTags(), Equals("host=localhost"));
+        CHECK(pool.statistics().rejected == 2);
+    }
+
+    TEST_CASE("Empty interned tag is not added", "[PointTest]")
+    {
+        StringPool pool;
+        const auto point = Point{"test"}.addTag("tag", "", pool);
+        CHECK_THAT(point.getTags(), Equals(""));
+        CHECK(pool.statistics().uniqueStrings == 0);
+    }
+
+    TEST_CASE("Point allocates from memory resource", "[PointTest]")
+    {
+        CountingResource resource;
+        const std::string longValue(64, 'x');
+        const std::string measurement{"measurement-name-exceeding-small-string-storage"};
+        Point point{measurement, &resource};
+        point.addTag("tag", longValue).addField("field", longValue);
+        const auto stringBytes = resource.allocatedBytes;
+        CHECK(stringBytes >= measurement.size() + 2 * longValue.size());
+
+        for (int i = 0; i < 5; ++i)
+        {
+            point.addField("f" + std::to_string(i), i);
+        }
+        CHECK(resource.allocatedBytes > stringBytes);
+        CHECK_THAT(point.getTags(), Equals("tag=" + longValue));
+    }
+
+    TEST_CASE("Copy of point uses default memory resource", "[PointTest]")
+    {
+        CountingResource resource;
+        const std::string longValue(64, 'x');
+        const auto point = Point{"test", &resource}.addTag("tag", longValue);
+        const auto allocated = resource.allocatedBytes;
+
+        const Point copy{point};
+        CHECK(resource.allocatedBytes == allocated);
+        CHECK_THAT(copy.getTags(), Equals("tag=" + longValue));
+    }
+
     TEST_CASE("Measurement with specific time stamp", "[PointTest]")
     {
         const std::chrono::time_point<std::chrono::system_clock> timeStamp{std::chrono::milliseconds{1572830915}};
@@ -187,6 +305,32 @@ namespace influxdb::test
         CHECK_THAT(point3.getFields(), Equals("float_field=0.00000"));
     }
 
+    TEST_CASE("Tags are visited in insertion order", "[PointTest]")
+    {
+        StringPool pool;
+        const auto point = Point{"test"}.addTag("a", "1").addTag("b", "2", pool).addTag("c,d", "3 4");
+        std::vector<std::pair<std::string, std::string>> tags;
+        point.forEachTag([&tags](std::string_view key, std::string_view value)
+                         { tags.emplace_back(key, value); });
+
+        CHECK(tags == std::vector<std::pair<std::string, std::string>>{{"a", "1"}, {"b", "2"}, {"c,d", "3 4"}});
+    }
+
+    TEST_CASE("Fields are visited with their type", "[PointTest]")
+    {
+        const auto point = Point{"test"}.addField("i", 3).addField("d", 1.5).addField("s", "str").addField("b", true).addField("u", 7ull);
+        std::vector<std::pair<std::string, Point::FieldView>> fields;
+        point.forEachField([&fields](std::string_view name, const Point::FieldView& value)
+                           { fields.emplace_back(name, value); });
+
+        REQUIRE(fields.size() == 5);
+        CHECK(fields[0] == std::pair<std::string, Point::FieldView>{"i", 3});
+        CHECK(fields[1] == std::pair<std::string, Point::FieldView>{"d", 1.5});
+        CHECK(fields[2] == std::pair<std::string, Point::FieldView>{"s", std::string_view{"str"}});
+        CHECK(fields[3] == std::pair<std::string, Point::FieldView>{"b", true});
+        CHECK(fields[4] == std::pair<std::string, Point::FieldView>{"u", 7ull});
+    }
+
     TEST_CASE("Line protocol of empty measurement", "[PointTest]")
     {
         const auto point = Point{"test"}.setTimestamp(ignoreTimestamp);
@@ -0,0 +1,283 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Relay.h"
+#include "MockHttpServer.h"
+#include "InfluxDBException.h"
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+namespace influxdb::test
+{
+    using namespace Catch::Matchers;
+    using relay::Relay;
+    using namespace std::chrono_literals;
+
+    namespace
+    {
+        constexpr auto timeout{5s};
+
+        Relay::Configuration configurationFor(const MockHttpServer& server, const std::string& listen)
+        {
+            Relay::Configuration configuration;
+            configuration.listen = {listen};
+            configuration.target = server.url() + "?db=test";
+            configuration.flushInterval = 20ms;
+            configuration.retryDelay = 1ms;
+            return configuration;
+        }
+
+        /// Connects a socket of type to an endpoint as returned by Relay::endpoints()
+        int connectTo(const std::string& endpoint, int type)
+        {
+            const auto schemeEnd = endpoint.find("://");
+            const std::string address = endpoint.substr(schemeEnd + 3);
+
+            if (endpoint.compare(0, schemeEnd, "unix") == 0)
+            {
+                const int fd = ::socket(AF_UNIX, type, 0);
+                sockaddr_un unixAddress{};
+                unixAddress.sun_family = AF_UNIX;
+                address.copy(unixAddress.sun_path, address.size());
+                REQUIRE(::connect(fd, reinterpret_cast<sockaddr*>(&unixAddress), sizeof(unixAddress)) == 0);
+                return fd;
+            }
+
+            const auto portSeparator = address.rfind(':');
+            addrinfo hints{};
+            hints.ai_socktype = type;
+            addrinfo* result{nullptr};
+            REQUIRE(::getaddrinfo(address.substr(0, portSeparator).c_str(), address.substr(portSeparator + 1).c_str(), &hints, &result) == 0);
+            const int fd = ::socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+            REQUIRE(::connect(fd, result->ai_addr, result->ai_addrlen) == 0);
+            ::freeaddrinfo(result);
+            return fd;
+        }
+
+        void sendAll(int fd, const std::string& data)
+        {
+            REQUIRE(::send(fd, data.data(), data.size(), 0) == static_cast<ssize_t>(data.size()));
+        }
+
+        std::string joinedBodies(const std::vector<MockHttpServer::Request>& requests)
+        {
+            std::string bodies;
+
+            for (const auto& request : requests)
+            {
+                bodies += request.body;
+            }
+            return bodies;
+        }
+
+        bool receivedBytes(const MockHttpServer& server, std::size_t bytes)
+        {
+            return server.waitFor([bytes](const auto& requests)
+                                  { return joinedBodies(requests).size() >= bytes; },
+                                  timeout);
+        }
+    }
+
+    TEST_CASE("Relay forwards UDP datagrams", "[RelayTest]")
+    {
+        MockHttpServer server;
+        auto configuration = configurationFor(server, "udp://127.0.0.1:0");
+        configuration.receiveThreads = 2;
+        Relay relay{configuration};
+        relay.start();
+
+        const int fd = connectTo(relay.endpoints().front(), SOCK_DGRAM);
+        sendAll(fd, "cpu value=1\n");
+        sendAll(fd, "cpu value=2\nmem value=3");
+        ::close(fd);
+
+        const std::string expected{"cpu value=1\ncpu value=2\nmem value=3\n"};
+        REQUIRE(receivedBytes(server, expected.size()));
+        relay.stop();
+
+        const auto requests = server.requests();
+        CHECK(joinedBodies(requests) == expected);
+        CHECK(requests.front().method == "POST");
+        CHECK_THAT(requests.front().target, StartsWith("/write?db=test"));
+
+        const auto statistics = relay.statistics();
+        CHECK(statistics.receivedPackets == 2);
+        CHECK(statistics.receivedLines == 3);
+        CHECK(statistics.receivedBytes == expected.size());
+        CHECK(statistics.forwardedLines == 3);
+        CHECK(statistics.forwardedBytes == expected.size());
+        CHECK(statistics.forwardedBatches == requests.size());
+    }
+
+    TEST_CASE("Relay forwards lines split across TCP reads", "[RelayTest]")
+    {
+        MockHttpServer server;
+        Relay relay{configurationFor(server, "tcp://127.0.0.1:0")};
+        relay.start();
+
+        const int fd = connectTo(relay.endpoints().front(), SOCK_STREAM);
+        sendAll(fd, "cpu val");
+        std::this_thread::sleep_for(50ms);
+        sendAll(fd, "ue=1\nmem value=2\ndisk value=3");
+        ::close(fd);
+
+        const std::string expected{"cpu value=1\nmem value=2\ndisk value=3\n"};
+        REQUIRE(receivedBytes(server, expected.size()));
+        relay.stop();
+
+        CHECK(joinedBodies(server.requests()) == expected);
+        CHECK(relay.statistics().forwardedLines == 3);
+    }
+
+    TEST_CASE("Relay forwards lines from unix socket", "[RelayTest]")
+    {
+        MockHttpServer server;
+        const std::string path{"/tmp/influxdb-cxx-relay-test-" + std::to_string(::getpid()) + ".sock"};
+        Relay relay{configurationFor(server, "unix://" + path)};
+        relay.start();
+        CHECK(relay.endpoints() == std::vector<std::string>{"unix://" + path});
+
+        const int fd = connectTo(relay.endpoints().front(), SOCK_STREAM);
+        sendAll(fd, "cpu value=1\n");
+        ::close(fd);
+
+        REQUIRE(receivedBytes(server, 12));
+        CHECK(joinedBodies(server.requests()) == "cpu value=1\n");
+    }
+
+    TEST_CASE("Relay seals batches by size", "[RelayTest]")
+    {
+        MockHttpServer server;
+        auto configuration = configurationFor(server, "tcp://127.0.0.1:0");
+        configuration.batchBytes = 24;
+        configuration.flushInterval = 10s;
+        configuration.connections = 1;
+        Relay relay{configuration};
+        relay.start();
+
+        const int fd = connectTo(relay.endpoints().front(), SOCK_STREAM);
+
+        for (int i = 0; i < 4; ++i)
+        {
+            sendAll(fd, "cpu value=" + std::to_string(i) + "\n");
+            std::this_thread::sleep_for(10ms);
+        }
+        ::close(fd);
+
+        REQUIRE(server.waitFor([](const auto& requests)
+                               { return requests.size() == 2; },
+                               timeout));
+        const auto requests = server.requests();
+        CHECK(requests[0].body == "cpu value=0\ncpu value=1\n");
+        CHECK(requests[1].body == "cpu value=2\ncpu value=3\n");
+    }
+
+    TEST_CASE("Relay retries failed sends", "[RelayTest]")
+    {
+        int failures{2};
+        MockHttpServer server{[&failures](const MockHttpServer::Request&)
+                              { return MockHttpServer::Response{failures-- > 0 ? 503 : 204, "", {}}; }};
+        Relay relay{configurationFor(server, "tcp://127.0.0.1:0")};
+        relay.start();
+
+        const int fd = connectTo(relay.endpoints().front(), SOCK_STREAM);
+        sendAll(fd, "cpu value=1\n");
+        ::close(fd);
+
+        REQUIRE(server.waitFor([](const auto& requests)
+                               { return requests.size() == 3; },
+                               timeout));
+        relay.stop();
+
+        for (const auto& request : server.requests())
+        {
+            CHECK(request.body == "cpu value=1\n");
+        }
+
+        const auto statistics = relay.statistics();
+        CHECK(statistics.retries == 2);
+        CHECK(statistics.forwardedBatches == 1);
+        CHECK(statistics.failedBatches == 0);
+    }
+
+    TEST_CASE("Relay gives up after configured retries", "[RelayTest]")
+    {
+        MockHttpServer server{[](const MockHttpServer::Request&)
+                              { return MockHttpServer::Response{500, "", {}}; }};
+        auto configuration = configurationFor(server, "tcp://127.0.0.1:0");
+        configuration.retries = 1;
+        Relay relay{configuration};
+        relay.start();
+
+        const int fd = connectTo(relay.endpoints().front(), SOCK_STREAM);
+        sendAll(fd, "cpu value=1\n");
+        ::close(fd);
+
+        REQUIRE(server.waitFor([](const auto& requests)
+                               { return requests.size() == 2; },
+                               timeout));
+        relay.stop();
+
+        const auto statistics = relay.statistics();
+        CHECK(statistics.retries == 1);
+        CHECK(statistics.forwardedBatches == 0);
+        CHECK(statistics.failedBatches == 1);
+    }
+
+    TEST_CASE("Relay forwards pending lines on stop", "[RelayTest]")
+    {
+        MockHttpServer server;
+        auto configuration = configurationFor(server, "udp://127.0.0.1:0");
+        configuration.flushInterval = 1h;
+        Relay relay{configuration};
+        relay.start();
+
+        const int fd = connectTo(relay.endpoints().front(), SOCK_DGRAM);
+        sendAll(fd, "cpu value=1\n");
+        ::close(fd);
+
+        while (relay.statistics().receivedLines == 0)
+        {
+            std::this_thread::sleep_for(1ms);
+        }
+        CHECK(server.requests().empty());
+
+        relay.stop();
+        CHECK(joinedBodies(server.requests()) == "cpu value=1\n");
+    }
+
+    TEST_CASE("Relay rejects invalid listen addresses", "[RelayTest]")
+    {
+        MockHttpServer server;
+        CHECK_THROWS_AS(Relay{configurationFor(server, "127.0.0.1:8089")}, InfluxDBException);
+        CHECK_THROWS_AS(Relay{configurationFor(server, "udp://127.0.0.1")}, InfluxDBException);
+        CHECK_THROWS_AS(Relay{configurationFor(server, "http://127.0.0.1:8089")}, InfluxDBException);
+    }
+}
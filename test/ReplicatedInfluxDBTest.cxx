@@ -0,0 +1,151 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ReplicatedInfluxDB.h"
+#include "InfluxDBException.h"
+#include "mock/RecordingTransport.h"
+#include <catch2/catch_test_macros.hpp>
+
+namespace influxdb::test
+{
+    using namespace std::chrono_literals;
+
+    namespace
+    {
+        constexpr std::chrono::time_point<std::chrono::system_clock> ignoreTimestamp(std::chrono::milliseconds(4567));
+
+        std::vector<std::unique_ptr<Transport>> transportsOf(Recorder& first, Recorder& second)
+        {
+            std::vector<std::unique_ptr<Transport>> transports;
+            transports.push_back(std::make_unique<RecordingTransport>(first));
+            transports.push_back(std::make_unique<RecordingTransport>(second));
+            return transports;
+        }
+
+        Point pointOf(int value)
+        {
+            return Point{"cpu"}.addField("value", value).setTimestamp(ignoreTimestamp);
+        }
+    }
+
+    TEST_CASE("Replicated client requires transports", "[ReplicatedInfluxDBTest]")
+    {
+        Recorder first;
+        Recorder second;
+        CHECK_THROWS_AS(ReplicatedInfluxDB({}), InfluxDBException);
+        CHECK_THROWS_AS(ReplicatedInfluxDB(transportsOf(first, second), 0), InfluxDBException);
+        CHECK_THROWS_AS(ReplicatedInfluxDB(transportsOf(first, second), 10, 0), InfluxDBException);
+    }
+
+    TEST_CASE("Replicated client serializes a batch once for all replicas", "[ReplicatedInfluxDBTest]")
+    {
+        Recorder first;
+        Recorder second;
+        ReplicatedInfluxDB db{transportsOf(first, second), 2};
+
+        db.write(pointOf(1));
+        db.write(pointOf(2));
+        db.write(pointOf(3));
+        db.flushBatch();
+
+        REQUIRE(first.messages.size() == 2);
+        REQUIRE(second.messages.size() == 2);
+        CHECK(*first.messages[0] == "cpu value=1i 4567000000\ncpu value=2i 4567000000");
+        CHECK(*first.messages[1] == "cpu value=3i 4567000000");
+        CHECK(first.messages[0] == second.messages[0]);
+        CHECK(first.messages[1] == second.messages[1]);
+        CHECK(db.statistics(0).sent == 2);
+        CHECK(db.statistics(1).sent == 2);
+    }
+
+    TEST_CASE("Replicated client isn't stalled by a slow replica", "[ReplicatedInfluxDBTest]")
+    {
+        Recorder healthy;
+        Recorder slow;
+        slow.setBlocked(true);
+        ReplicatedInfluxDB db{transportsOf(healthy, slow), 1, 2};
+
+        db.write(pointOf(0));
+        {
+            std::unique_lock lock{slow.mutex};
+            REQUIRE(slow.changed.wait_for(lock, 5s, [&slow]
+                                          { return slow.attempts == 1; }));
+        }
+
+        // Waits for the healthy replica each time, so only the slow one drops batches
+        for (int value = 1; value < 10; ++value)
+        {
+            db.write(pointOf(value));
+            REQUIRE(healthy.waitForMessages(static_cast<std::size_t>(value) + 1));
+        }
+        CHECK(db.statistics(1).queued == 2);
+        CHECK(db.statistics(1).dropped == 7);
+
+        slow.setBlocked(false);
+        db.flushBatch();
+
+        CHECK(healthy.messages.size() == 10);
+        CHECK(db.statistics(0).dropped == 0);
+        REQUIRE(slow.messages.size() == 3);
+        CHECK(*slow.messages[0] == "cpu value=0i 4567000000");
+        CHECK(*slow.messages[1] == "cpu value=8i 4567000000");
+        CHECK(*slow.messages[2] == "cpu value=9i 4567000000");
+        CHECK(db.statistics(1).sent == 3);
+    }
+
+    TEST_CASE("Replicated client retries failed sends", "[ReplicatedInfluxDBTest]")
+    {
+        Recorder first;
+        Recorder second;
+        second.failures = 2;
+        ReplicatedInfluxDB db{transportsOf(first, second), 10, 4, 2, 1ms};
+
+        db.write(pointOf(1));
+        db.flushBatch();
+
+        CHECK(second.messages.size() == 1);
+        CHECK(db.statistics(1).retries == 2);
+        CHECK(db.statistics(1).sent == 1);
+
+        second.failures = 3;
+        db.write(pointOf(2));
+        db.flushBatch();
+
+        CHECK(second.messages.size() == 1);
+        CHECK(db.statistics(1).failed == 1);
+        CHECK(first.messages.size() == 2);
+        CHECK(db.statistics(0).retries == 0);
+    }
+
+    TEST_CASE("Replicated client sends pending points on destruction", "[ReplicatedInfluxDBTest]")
+    {
+        Recorder first;
+        Recorder second;
+        {
+            ReplicatedInfluxDB db{transportsOf(first, second)};
+            db.write(std::vector<Point>{pointOf(1), pointOf(2)});
+        }
+
+        REQUIRE(first.messages.size() == 1);
+        CHECK(first.messages[0] == second.messages[0]);
+    }
+}
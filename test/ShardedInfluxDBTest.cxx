@@ -0,0 +1,238 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "ShardedInfluxDB.h"
+#include "InfluxDBException.h"
+#include "mock/RecordingTransport.h"
+#include <limits>
+#include <map>
+#include <set>
+#include <catch2/catch_test_macros.hpp>
+
+namespace influxdb::test
+{
+    using namespace std::chrono_literals;
+
+    namespace
+    {
+        constexpr std::chrono::time_point<std::chrono::system_clock> ignoreTimestamp(std::chrono::milliseconds(4567));
+
+        std::vector<std::unique_ptr<Transport>> transportsOf(Recorder& recorder, std::size_t count, std::size_t failing = std::numeric_limits<std::size_t>::max())
+        {
+            std::vector<std::unique_ptr<Transport>> transports;
+
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                transports.push_back(std::make_unique<RecordingTransport>(recorder, i, i == failing));
+            }
+            return transports;
+        }
+
+        Point pointOf(std::size_t series, int value = 1)
+        {
+            return Point{"cpu"}.addTag("host", "host" + std::to_string(series)).addField("value", value).setTimestamp(ignoreTimestamp);
+        }
+    }
+
+    TEST_CASE("Sharded client requires transports", "[ShardedInfluxDBTest]")
+    {
+        Recorder recorder;
+        CHECK_THROWS_AS(ShardedInfluxDB({}), InfluxDBException);
+        CHECK_THROWS_AS(ShardedInfluxDB(transportsOf(recorder, 2), 0), InfluxDBException);
+    }
+
+    TEST_CASE("Sharded client routes series independent of tag order", "[ShardedInfluxDBTest]")
+    {
+        Recorder recorder;
+        const ShardedInfluxDB db{transportsOf(recorder, 8)};
+
+        for (std::size_t series = 0; series < 100; ++series)
+        {
+            const auto host = "host" + std::to_string(series);
+            CHECK(db.shardOf(Point{"cpu"}.addTag("host", host).addTag("dc", "eu")) == db.shardOf(Point{"cpu"}.addTag("dc", "eu").addTag("host", host)));
+        }
+    }
+
+    TEST_CASE("Sharded client writes each series to one shard", "[ShardedInfluxDBTest]")
+    {
+        Recorder recorder;
+        ShardedInfluxDB db{transportsOf(recorder, 4), 7};
+
+        for (int value = 0; value < 3; ++value)
+        {
+            for (std::size_t series = 0; series < 100; ++series)
+            {
+                db.write(pointOf(series, value));
+            }
+        }
+        db.flushBatch();
+
+        std::map<std::string, std::set<std::size_t>> shardsOfSeries;
+        std::size_t lines{0};
+
+        for (const auto& [shard, shardLines] : recorder.lines)
+        {
+            for (const auto& line : shardLines)
+            {
+                shardsOfSeries[line.substr(0, line.find(' '))].insert(shard);
+            }
+            lines += shardLines.size();
+        }
+
+        CHECK(lines == 300);
+        CHECK(shardsOfSeries.size() == 100);
+        CHECK(recorder.lines.size() == 4);
+
+        for (std::size_t series = 0; series < 100; ++series)
+        {
+            const auto& shards = shardsOfSeries["cpu,host=host" + std::to_string(series)];
+            REQUIRE(shards.size() == 1);
+            CHECK(*shards.begin() == db.shardOf(pointOf(series)));
+        }
+    }
+
+    TEST_CASE("Sharded client distributes series evenly", "[ShardedInfluxDBTest]")
+    {
+        Recorder recorder;
+        const ShardedInfluxDB db{transportsOf(recorder, 4)};
+        std::vector<std::size_t> seriesPerShard(db.shardCount());
+
+        for (std::size_t series = 0; series < 4000; ++series)
+        {
+            ++seriesPerShard[db.shardOf(pointOf(series))];
+        }
+
+        for (const auto count : seriesPerShard)
+        {
+            CHECK(count > 800);
+            CHECK(count < 1200);
+        }
+    }
+
+    TEST_CASE("Sharded client moves few series to an added shard", "[ShardedInfluxDBTest]")
+    {
+        Recorder recorder;
+        const ShardedInfluxDB four{transportsOf(recorder, 4)};
+        const ShardedInfluxDB five{transportsOf(recorder, 5)};
+        std::size_t moved{0};
+
+        for (std::size_t series = 0; series < 1000; ++series)
+        {
+            const auto before = four.shardOf(pointOf(series));
+            const auto after = five.shardOf(pointOf(series));
+
+            if (before != after)
+            {
+                CHECK(after == 4);
+                ++moved;
+            }
+        }
+        CHECK(moved > 100);
+        CHECK(moved < 300);
+    }
+
+    TEST_CASE("Sharded client sends full batches without flush", "[ShardedInfluxDBTest]")
+    {
+        Recorder recorder;
+        ShardedInfluxDB db{transportsOf(recorder, 2), 5};
+
+        for (int value = 0; value < 5; ++value)
+        {
+            db.write(pointOf(0, value));
+        }
+
+        REQUIRE(recorder.waitForMessages(1));
+        std::lock_guard lock{recorder.mutex};
+        CHECK(recorder.lines[db.shardOf(pointOf(0))].size() == 5);
+    }
+
+    TEST_CASE("Sharded client sends pending points on destruction", "[ShardedInfluxDBTest]")
+    {
+        Recorder recorder;
+        {
+            ShardedInfluxDB db{transportsOf(recorder, 3)};
+            db.write(std::vector<Point>{pointOf(0), pointOf(1), pointOf(2)});
+        }
+
+        std::size_t lines{0};
+        for (const auto& [shard, shardLines] : recorder.lines)
+        {
+            lines += shardLines.size();
+        }
+        CHECK(lines == 3);
+    }
+
+    TEST_CASE("Sharded client rethrows errors of a shard on flush", "[ShardedInfluxDBTest]")
+    {
+        Recorder recorder;
+        ShardedInfluxDB db{transportsOf(recorder, 2, 1)};
+        std::size_t series{0};
+
+        while (db.shardOf(pointOf(series)) != 0)
+        {
+            ++series;
+        }
+        std::size_t failingSeries{0};
+
+        while (db.shardOf(pointOf(failingSeries)) != 1)
+        {
+            ++failingSeries;
+        }
+
+        db.write(pointOf(series));
+        db.write(pointOf(failingSeries));
+        CHECK_THROWS_AS(db.flushBatch(), InfluxDBException);
+        CHECK(recorder.lines[0].size() == 1);
+        CHECK(db.stats(1).failedSends == 1);
+
+        db.write(pointOf(series));
+        CHECK_NOTHROW(db.flushBatch());
+    }
+
+    TEST_CASE("Sharded client sends points queued after a failed batch", "[ShardedInfluxDBTest]")
+    {
+        Recorder recorder;
+        recorder.setBlocked(true);
+        ShardedInfluxDB db{transportsOf(recorder, 1), 2};
+
+        db.write(pointOf(0, 0));
+        db.write(pointOf(0, 1));
+        {
+            std::unique_lock lock{recorder.mutex};
+            REQUIRE(recorder.changed.wait_for(lock, 5s, [&recorder]
+                                              { return recorder.attempts == 1; }));
+            recorder.failures = 2;
+        }
+
+        // Taken at once by the sender, whose second batch of them fails
+        for (int value = 2; value < 6; ++value)
+        {
+            db.write(pointOf(0, value));
+        }
+        recorder.setBlocked(false);
+
+        CHECK_THROWS_AS(db.flushBatch(), InfluxDBException);
+        CHECK_NOTHROW(db.flushBatch());
+        CHECK(recorder.take() == std::vector<std::string>{"cpu,host=host0 value=4i", "cpu,host=host0 value=5i"});
+        CHECK(db.stats(0).dropped == 4);
+    }
+}
@@ -0,0 +1,191 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BoostSupport.h"
+#include "InfluxDBException.h"
+#include "SendQueue.h"
+#include <cstdio>
+#include <map>
+#include <thread>
+#include <vector>
+#include <boost/asio.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace influxdb::test
+{
+    namespace ba = boost::asio;
+
+    namespace
+    {
+        http::url urlOf(const std::string& host, int port)
+        {
+            http::url url{};
+            url.host = host;
+            url.port = port;
+            return url;
+        }
+
+        /// Runs context on threads until it is out of work
+        void runOn(ba::io_context& context, std::size_t threads)
+        {
+            std::vector<std::thread> runners;
+
+            for (std::size_t i = 0; i < threads; ++i)
+            {
+                runners.emplace_back([&context]
+                                     { context.run(); });
+            }
+            for (auto& runner : runners)
+            {
+                runner.join();
+            }
+        }
+
+        std::string receive(ba::ip::udp::socket& socket)
+        {
+            std::string datagram(256, '\0');
+            datagram.resize(socket.receive(ba::buffer(datagram)));
+            return datagram;
+        }
+    }
+
+    TEST_CASE("UDP transport sends on a shared io_context", "[SharedIoContextTest]")
+    {
+        ba::io_context receiverContext;
+        ba::ip::udp::socket receiver{receiverContext, ba::ip::udp::endpoint{ba::ip::make_address("127.0.0.1"), 0}};
+        ba::io_context context;
+        auto transport = internal::withUdpTransport(urlOf("127.0.0.1", receiver.local_endpoint().port()), &context);
+
+        transport->send("cpu value=1");
+        transport->send("cpu value=2");
+        transport->sendShared(std::make_shared<const std::string>("cpu value=3"));
+        CHECK(transport->stats().messages == 0);
+
+        runOn(context, 2);
+
+        CHECK(receive(receiver) == "cpu value=1");
+        CHECK(receive(receiver) == "cpu value=2");
+        CHECK(receive(receiver) == "cpu value=3");
+        CHECK(transport->stats().messages == 3);
+        CHECK(transport->stats().bytes == 33);
+    }
+
+    TEST_CASE("TCP transport sends lines in order on a shared io_context", "[SharedIoContextTest]")
+    {
+        ba::io_context receiverContext;
+        ba::ip::tcp::acceptor acceptor{receiverContext, ba::ip::tcp::endpoint{ba::ip::make_address("127.0.0.1"), 0}};
+        std::string received;
+        std::thread receiver{[&acceptor, &received]
+                             {
+                                 auto socket = acceptor.accept();
+                                 boost::system::error_code error;
+                                 ba::read(socket, ba::dynamic_buffer(received), error);
+                             }};
+
+        ba::io_context context;
+        auto guard = ba::make_work_guard(context);
+        std::thread runner{[&context]
+                           { runOn(context, 4); }};
+        {
+            auto transport = internal::withTcpTransport(urlOf("127.0.0.1", acceptor.local_endpoint().port()), &context);
+            std::vector<std::thread> writers;
+
+            for (const char* prefix : {"a", "b"})
+            {
+                writers.emplace_back([&transport, prefix]
+                                     {
+                                         for (int i = 0; i < 200; ++i)
+                                         {
+                                             transport->send(prefix + std::to_string(i));
+                                         }
+                                     });
+            }
+            for (auto& writer : writers)
+            {
+                writer.join();
+            }
+        }
+        guard.reset();
+        runner.join();
+        receiver.join();
+
+        std::map<char, int> next;
+        std::size_t lines{0};
+
+        for (std::size_t begin = 0, end = received.find('\n'); end != std::string::npos; begin = end + 1, end = received.find('\n', begin))
+        {
+            const auto line = received.substr(begin, end - begin);
+            CHECK(std::stoi(line.substr(1)) == next[line.front()]++);
+            ++lines;
+        }
+        CHECK(lines == 400);
+    }
+
+#if defined(BOOST_ASIO_HAS_LOCAL_SOCKETS)
+    TEST_CASE("Unix socket transport sends on a shared io_context", "[SharedIoContextTest]")
+    {
+        const std::string path{"/tmp/influxdb-cxx-SharedIoContextTest.sock"};
+        std::remove(path.c_str());
+        ba::io_context receiverContext;
+        ba::local::datagram_protocol::socket receiver{receiverContext, ba::local::datagram_protocol::endpoint{path}};
+        ba::io_context context;
+        http::url url{};
+        url.path = path;
+        auto transport = internal::withUnixSocketTransport(url, &context);
+
+        transport->send("cpu value=1");
+        runOn(context, 1);
+
+        std::string datagram(256, '\0');
+        datagram.resize(receiver.receive(ba::buffer(datagram)));
+        CHECK(datagram == "cpu value=1");
+        CHECK(transport->stats().messages == 1);
+        std::remove(path.c_str());
+    }
+#endif
+
+    TEST_CASE("Messages queued are sent after the transport is destroyed", "[SharedIoContextTest]")
+    {
+        ba::io_context receiverContext;
+        ba::ip::udp::socket receiver{receiverContext, ba::ip::udp::endpoint{ba::ip::make_address("127.0.0.1"), 0}};
+        ba::io_context context;
+
+        internal::withUdpTransport(urlOf("127.0.0.1", receiver.local_endpoint().port()), &context)->send("cpu value=1");
+        runOn(context, 1);
+
+        CHECK(receive(receiver) == "cpu value=1");
+    }
+
+    TEST_CASE("Send throws once the queue is full", "[SharedIoContextTest]")
+    {
+        ba::io_context context;
+        auto transport = internal::withUdpTransport(urlOf("127.0.0.1", 9), &context);
+
+        for (std::size_t i = 0; i < internal::SendQueue<ba::ip::udp::socket>::defaultMaxPending; ++i)
+        {
+            transport->send("cpu value=1");
+        }
+
+        CHECK_THROWS_AS(transport->send("cpu value=1"), InfluxDBException);
+        CHECK(transport->stats().networkErrors == 1);
+    }
+}
@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "SmallVector.h"
+#include <string>
+#include <catch2/catch_test_macros.hpp>
+
+namespace influxdb::test
+{
+    using detail::SmallVector;
+
+    TEST_CASE("Default constructed vector is empty and inline", "[SmallVectorTest]")
+    {
+        const SmallVector<int, 2> v;
+        CHECK(v.empty());
+        CHECK(v.size() == 0);
+        CHECK(v.capacity() == 2);
+        CHECK(v.isInline());
+    }
+
+    TEST_CASE("Elements are stored inline up to capacity", "[SmallVectorTest]")
+    {
+        SmallVector<std::string, 2> v;
+        v.emplace_back("a");
+        v.push_back("b");
+        CHECK(v.size() == 2);
+        CHECK(v.isInline());
+        CHECK(v[0] == "a");
+        CHECK(v.back() == "b");
+    }
+
+    TEST_CASE("Vector grows beyond inline capacity", "[SmallVectorTest]")
+    {
+        SmallVector<std::string, 2> v;
+        for (int i = 0; i < 5; ++i)
+        {
+            v.emplace_back(std::to_string(i));
+        }
+
+        CHECK(v.size() == 5);
+        CHECK(v.isInline() == false);
+        CHECK(v.capacity() >= 5);
+        CHECK(v[0] == "0");
+        CHECK(v[4] == "4");
+    }
+
+    TEST_CASE("Growing push of an own element copies it", "[SmallVectorTest]")
+    {
+        const std::string value(32, 'x');
+        SmallVector<std::string, 2> v;
+        v.push_back(value);
+        v.push_back("b");
+
+        v.push_back(v[0]);
+        v.push_back("d");
+        v.push_back(v[2]);
+
+        CHECK(v.size() == 5);
+        CHECK(v[2] == value);
+        CHECK(v[4] == value);
+        CHECK(v[0] == value);
+    }
+
+    TEST_CASE("Copy copies elements", "[SmallVectorTest]")
+    {
+        SmallVector<std::string, 2> inlineVector;
+        inlineVector.emplace_back("x");
+        SmallVector<std::string, 2> heapVector;
+        heapVector.emplace_back("0");
+        heapVector.emplace_back("1");
+        heapVector.emplace_back("2");
+
+        const auto inlineCopy = inlineVector;
+        const auto heapCopy = heapVector;
+        CHECK(inlineCopy.size() == 1);
+        CHECK(inlineCopy[0] == "x");
+        CHECK(heapCopy.size() == 3);
+        CHECK(heapCopy[2] == "2");
+        CHECK(heapVector.size() == 3);
+
+        inlineVector = heapCopy;
+        CHECK(inlineVector.size() == 3);
+        CHECK(inlineVector[1] == "1");
+    }
+
+    TEST_CASE("Move of inline vector moves elements", "[SmallVectorTest]")
+    {
+        SmallVector<std::string, 2> v;
+        v.emplace_back("a");
+
+        const auto moved = std::move(v);
+        CHECK(moved.size() == 1);
+        CHECK(moved.isInline());
+        CHECK(moved[0] == "a");
+    }
+
+    TEST_CASE("Move of heap vector steals storage", "[SmallVectorTest]")
+    {
+        SmallVector<std::string, 1> v;
+        v.emplace_back("a");
+        v.emplace_back("b");
+        const auto* data = &v[0];
+
+        SmallVector<std::string, 1> moved;
+        moved.emplace_back("replaced");
+        moved = std::move(v);
+        CHECK(moved.size() == 2);
+        CHECK(&moved[0] == data);
+        CHECK(moved[1] == "b");
+    }
+
+    TEST_CASE("Clear removes all elements", "[SmallVectorTest]")
+    {
+        SmallVector<int, 1> v;
+        v.push_back(1);
+        v.push_back(2);
+        v.clear();
+        CHECK(v.empty());
+        v.push_back(3);
+        CHECK(v[0] == 3);
+    }
+}
@@ -0,0 +1,118 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "StringPool.h"
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_all.hpp>
+
+namespace influxdb::test
+{
+    using namespace Catch::Matchers;
+
+    TEST_CASE("Intern returns equal string", "[StringPoolTest]")
+    {
+        StringPool pool;
+        const auto interned = pool.intern("host");
+        REQUIRE(interned.has_value());
+        CHECK_THAT(std::string{*interned}, Equals("host"));
+    }
+
+    TEST_CASE("Intern deduplicates strings", "[StringPoolTest]")
+    {
+        StringPool pool;
+        const std::string first{"region"};
+        const std::string second{"region"};
+        const auto interned0 = pool.intern(first);
+        const auto interned1 = pool.intern(second);
+
+        CHECK(interned0->data() == interned1->data());
+        CHECK(interned0->data() != first.data());
+    }
+
+    TEST_CASE("Statistics count unique strings and saved bytes", "[StringPoolTest]")
+    {
+        StringPool pool;
+        pool.intern("host");
+        pool.intern("host");
+        pool.intern("host");
+        pool.intern("service");
+
+        const auto stats = pool.statistics();
+        CHECK(stats.uniqueStrings == 2);
+        CHECK(stats.storedBytes == 11);
+        CHECK(stats.bytesSaved == 8);
+        CHECK(stats.rejected == 0);
+    }
+
+    TEST_CASE("Intern rejects strings if pool is full", "[StringPoolTest]")
+    {
+        StringPool pool{8};
+        CHECK(pool.intern("abcde").has_value());
+        CHECK(pool.intern("fghij").has_value() == false);
+        CHECK(pool.intern("abcde").has_value());
+        CHECK(pool.intern("xyz").has_value());
+
+        const auto stats = pool.statistics();
+        CHECK(stats.uniqueStrings == 2);
+        CHECK(stats.storedBytes == 8);
+        CHECK(stats.rejected == 1);
+    }
+
+    TEST_CASE("Interned strings stay valid while pool grows", "[StringPoolTest]")
+    {
+        StringPool pool;
+        const auto first = pool.intern("first");
+
+        for (int i = 0; i < 10000; ++i)
+        {
+            pool.intern("value-" + std::to_string(i));
+        }
+
+        CHECK_THAT(std::string{*first}, Equals("first"));
+        CHECK(pool.intern("first")->data() == first->data());
+    }
+
+    TEST_CASE("Intern is thread-safe", "[StringPoolTest]")
+    {
+        StringPool pool;
+        std::vector<std::thread> threads;
+
+        for (int t = 0; t < 4; ++t)
+        {
+            threads.emplace_back([&pool]
+                                 {
+                                     for (int i = 0; i < 1000; ++i)
+                                     {
+                                         pool.intern("host-" + std::to_string(i % 100));
+                                     } });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        CHECK(pool.statistics().uniqueStrings == 100);
+    }
+}
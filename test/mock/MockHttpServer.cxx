@@ -0,0 +1,681 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MockHttpServer.h"
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#ifdef MOCK_HTTP_SERVER_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace influxdb::test
+{
+    namespace
+    {
+        constexpr int pollIntervalMs{50};
+
+        bool waitReadable(int fd)
+        {
+            pollfd descriptor{fd, POLLIN, 0};
+            return ::poll(&descriptor, 1, pollIntervalMs) > 0;
+        }
+
+        std::string toLower(std::string value)
+        {
+            std::transform(value.begin(), value.end(), value.begin(), [](unsigned char c)
+                           { return static_cast<char>(std::tolower(c)); });
+            return value;
+        }
+
+        std::string reasonOf(int status)
+        {
+            switch (status)
+            {
+                case 200:
+                    return "OK";
+                case 204:
+                    return "No Content";
+                case 400:
+                    return "Bad Request";
+                case 404:
+                    return "Not Found";
+                case 413:
+                    return "Request Entity Too Large";
+                case 415:
+                    return "Unsupported Media Type";
+                case 429:
+                    return "Too Many Requests";
+                case 500:
+                    return "Internal Server Error";
+                case 503:
+                    return "Service Unavailable";
+                default:
+                    return "Status";
+            }
+        }
+
+        /// \brief Buffered reader of a connection
+        class Reader
+        {
+        public:
+            Reader(int fd, const std::atomic<bool>& running)
+                : mFd(fd), mRunning(running)
+            {
+            }
+
+            /// Reads until delimiter, false if the connection closed
+            bool readUntil(const std::string& delimiter, std::string& result)
+            {
+                std::size_t position;
+
+                while ((position = mBuffer.find(delimiter)) == std::string::npos)
+                {
+                    if (!fill())
+                    {
+                        return false;
+                    }
+                }
+                result = mBuffer.substr(0, position);
+                mBuffer.erase(0, position + delimiter.size());
+                return true;
+            }
+
+            bool read(std::size_t length, std::string& result)
+            {
+                while (mBuffer.size() < length)
+                {
+                    if (!fill())
+                    {
+                        return false;
+                    }
+                }
+                result.append(mBuffer, 0, length);
+                mBuffer.erase(0, length);
+                return true;
+            }
+
+        private:
+            bool fill()
+            {
+                while (mRunning)
+                {
+                    if (!waitReadable(mFd))
+                    {
+                        continue;
+                    }
+
+                    std::array<char, 65536> chunk;
+                    const auto length = ::recv(mFd, chunk.data(), chunk.size(), 0);
+
+                    if (length <= 0)
+                    {
+                        return false;
+                    }
+                    mBuffer.append(chunk.data(), static_cast<std::size_t>(length));
+                    return true;
+                }
+                return false;
+            }
+
+            int mFd;
+            const std::atomic<bool>& mRunning;
+            std::string mBuffer;
+        };
+
+        bool readRequest(Reader& reader, MockHttpServer::Request& request)
+        {
+            std::string head;
+
+            if (!reader.readUntil("\r\n\r\n", head))
+            {
+                return false;
+            }
+
+            const auto requestLineEnd = head.find("\r\n");
+            const std::string requestLine = head.substr(0, requestLineEnd);
+            const auto methodEnd = requestLine.find(' ');
+            const auto targetEnd = requestLine.find(' ', methodEnd + 1);
+            request.method = requestLine.substr(0, methodEnd);
+            request.target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+
+            std::size_t lineBegin = requestLineEnd == std::string::npos ? head.size() : requestLineEnd + 2;
+
+            while (lineBegin < head.size())
+            {
+                const auto lineEnd = std::min(head.find("\r\n", lineBegin), head.size());
+                const std::string line = head.substr(lineBegin, lineEnd - lineBegin);
+
+                if (const auto colon = line.find(':'); colon != std::string::npos)
+                {
+                    const auto valueBegin = line.find_first_not_of(' ', colon + 1);
+                    request.headers[toLower(line.substr(0, colon))] = valueBegin == std::string::npos ? "" : line.substr(valueBegin);
+                }
+                lineBegin = lineEnd + 2;
+            }
+
+            if (const auto length = request.headers.find("content-length"); length != request.headers.end())
+            {
+                return reader.read(std::stoul(length->second), request.body);
+            }
+
+            if (const auto encoding = request.headers.find("transfer-encoding"); encoding != request.headers.end() && toLower(encoding->second) == "chunked")
+            {
+                while (true)
+                {
+                    std::string size;
+
+                    if (!reader.readUntil("\r\n", size))
+                    {
+                        return false;
+                    }
+
+                    const auto chunkSize = std::stoul(size, nullptr, 16);
+                    std::string terminator;
+
+                    if (chunkSize == 0)
+                    {
+                        return reader.readUntil("\r\n", terminator);
+                    }
+                    if (!reader.read(chunkSize, request.body) || !reader.readUntil("\r\n", terminator))
+                    {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool writeAll(int fd, const std::string& data)
+        {
+            std::size_t written{0};
+
+            while (written < data.size())
+            {
+                const auto length = ::send(fd, data.data() + written, data.size() - written, MSG_NOSIGNAL);
+
+                if (length <= 0)
+                {
+                    return false;
+                }
+                written += static_cast<std::size_t>(length);
+            }
+            return true;
+        }
+
+        std::string_view pathOf(std::string_view target)
+        {
+            return target.substr(0, target.find('?'));
+        }
+
+        /// Value of a query parameter, not url decoded
+        std::string parameterOf(std::string_view target, std::string_view name)
+        {
+            const auto queryBegin = target.find('?');
+
+            if (queryBegin == std::string_view::npos)
+            {
+                return "";
+            }
+
+            auto query = target.substr(queryBegin + 1);
+
+            while (!query.empty())
+            {
+                const auto end = std::min(query.find('&'), query.size());
+                const auto parameter = query.substr(0, end);
+
+                if (const auto equals = parameter.find('='); parameter.substr(0, equals) == name)
+                {
+                    return equals == std::string_view::npos ? "" : std::string{parameter.substr(equals + 1)};
+                }
+                query.remove_prefix(std::min(end + 1, query.size()));
+            }
+            return "";
+        }
+
+        std::uint64_t countLines(std::string_view body)
+        {
+            std::uint64_t lines{0};
+
+            while (!body.empty())
+            {
+                const auto end = std::min(body.find('\n'), body.size());
+
+                if (body.find_first_not_of(" \t\r", 0) < end)
+                {
+                    ++lines;
+                }
+                body.remove_prefix(std::min(end + 1, body.size()));
+            }
+            return lines;
+        }
+
+        /// Series of rows with consecutive timestamps, split into chunks of chunkSize rows
+        std::vector<std::string> generateRows(std::size_t rows, std::size_t chunkSize)
+        {
+            std::vector<std::string> chunks;
+            std::size_t row{0};
+
+            do
+            {
+                const auto begin = row;
+                const auto end = std::min(row + std::max<std::size_t>(chunkSize, 1), rows);
+                std::string json = R"({"results":[{"statement_id":0,"series":[{"name":"mock","columns":["time","value"],"values":[)";
+
+                for (; row < end; ++row)
+                {
+                    std::array<char, 64> value;
+                    const auto length = std::snprintf(value.data(), value.size(), R"(%s["2023-01-01T00:00:00.%09zuZ",%zu])", row == begin ? "" : ",", row, row);
+                    json.append(value.data(), static_cast<std::size_t>(length));
+                }
+                json += "]}]";
+                json += row < rows ? R"(,"partial":true}]})" : "}]}";
+                chunks.push_back(std::move(json));
+            } while (row < rows);
+
+            return chunks;
+        }
+
+#ifdef MOCK_HTTP_SERVER_WITH_ZLIB
+        constexpr int gzipWindowBits{15 + 16};
+
+        bool gunzip(const std::string& data, std::string& result)
+        {
+            z_stream stream{};
+
+            if (inflateInit2(&stream, gzipWindowBits) != Z_OK)
+            {
+                return false;
+            }
+
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+            stream.avail_in = static_cast<uInt>(data.size());
+            std::array<char, 65536> buffer;
+            int status{Z_OK};
+
+            while (status == Z_OK)
+            {
+                stream.next_out = reinterpret_cast<Bytef*>(buffer.data());
+                stream.avail_out = static_cast<uInt>(buffer.size());
+                status = inflate(&stream, Z_NO_FLUSH);
+                result.append(buffer.data(), buffer.size() - stream.avail_out);
+
+                if (status == Z_BUF_ERROR && stream.avail_in == 0)
+                {
+                    break;
+                }
+            }
+            inflateEnd(&stream);
+            return status == Z_STREAM_END;
+        }
+
+        std::string gzip(const std::string& data)
+        {
+            z_stream stream{};
+            deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, gzipWindowBits, 8, Z_DEFAULT_STRATEGY);
+            std::string result(deflateBound(&stream, static_cast<uLong>(data.size())), '\0');
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+            stream.avail_in = static_cast<uInt>(data.size());
+            stream.next_out = reinterpret_cast<Bytef*>(result.data());
+            stream.avail_out = static_cast<uInt>(result.size());
+            deflate(&stream, Z_FINISH);
+            result.resize(stream.total_out);
+            deflateEnd(&stream);
+            return result;
+        }
+#endif
+    }
+
+
+    MockHttpServer::MockHttpServer()
+        : MockHttpServer(Handler{})
+    {
+    }
+
+    MockHttpServer::MockHttpServer(Handler handler)
+        : mSocket(::socket(AF_INET, SOCK_STREAM, 0)),
+          mPort(0),
+          mRunning(true),
+          mHandler(std::move(handler)),
+          mFaults(),
+          mRandom(std::mt19937::default_seed),
+          mQueryResponse(R"({"results":[{"statement_id":0}]})"),
+          mGeneratedQueryRows(0),
+          mRecordRequests(true),
+          mStatistics()
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = 0;
+        socklen_t length = sizeof(address);
+
+        if (mSocket < 0 || ::bind(mSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+            || ::listen(mSocket, SOMAXCONN) != 0 || ::getsockname(mSocket, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+        {
+            const std::string error{std::strerror(errno)};
+
+            if (mSocket >= 0)
+            {
+                ::close(mSocket);
+            }
+            throw std::runtime_error{"Mock HTTP server: " + error};
+        }
+
+        mPort = ntohs(address.sin_port);
+        mAcceptThread = std::thread{[this]
+                                    { accept(); }};
+    }
+
+    MockHttpServer::~MockHttpServer()
+    {
+        mRunning = false;
+        mAcceptThread.join();
+
+        for (auto& connection : mConnections)
+        {
+            connection.thread.join();
+        }
+        ::close(mSocket);
+    }
+
+    std::string MockHttpServer::url() const
+    {
+        return "http://127.0.0.1:" + std::to_string(mPort);
+    }
+
+    int MockHttpServer::port() const
+    {
+        return mPort;
+    }
+
+    void MockHttpServer::setHandler(Handler handler)
+    {
+        std::lock_guard lock{mMutex};
+        mHandler = std::move(handler);
+    }
+
+    void MockHttpServer::setFaults(const Faults& faults)
+    {
+        std::lock_guard lock{mMutex};
+        mFaults = faults;
+    }
+
+    void MockHttpServer::setQueryResponse(std::string json)
+    {
+        std::lock_guard lock{mMutex};
+        mQueryResponse = std::move(json);
+        mGeneratedQueryRows = 0;
+    }
+
+    void MockHttpServer::setGeneratedQueryRows(std::size_t rows)
+    {
+        std::lock_guard lock{mMutex};
+        mGeneratedQueryRows = rows;
+    }
+
+    void MockHttpServer::setRecordRequests(bool record)
+    {
+        std::lock_guard lock{mMutex};
+        mRecordRequests = record;
+    }
+
+    std::vector<MockHttpServer::Request> MockHttpServer::requests() const
+    {
+        std::lock_guard lock{mMutex};
+        return mRequests;
+    }
+
+    MockHttpServer::Statistics MockHttpServer::statistics() const
+    {
+        std::lock_guard lock{mMutex};
+        return mStatistics;
+    }
+
+    bool MockHttpServer::waitFor(const std::function<bool(const std::vector<Request>&)>& predicate, std::chrono::milliseconds timeout) const
+    {
+        std::unique_lock lock{mMutex};
+        return mReceived.wait_for(lock, timeout, [this, &predicate]
+                                  { return predicate(mRequests); });
+    }
+
+    void MockHttpServer::accept()
+    {
+        while (mRunning)
+        {
+            if (!waitReadable(mSocket))
+            {
+                continue;
+            }
+
+            const int client = ::accept(mSocket, nullptr, nullptr);
+
+            if (client < 0)
+            {
+                continue;
+            }
+
+            mConnections.remove_if([](Connection& connection)
+                                   {
+                                       if (connection.done)
+                                       {
+                                           connection.thread.join();
+                                           return true;
+                                       }
+                                       return false; });
+
+            auto& connection = mConnections.emplace_back();
+            connection.thread = std::thread{[this, &connection, client]
+                                            {
+                                                serve(client);
+                                                ::close(client);
+                                                connection.done = true; }};
+        }
+    }
+
+    void MockHttpServer::serve(int fd)
+    {
+        Reader reader{fd, mRunning};
+        Request request;
+
+        while (readRequest(reader, request))
+        {
+            const Response response = handle(request);
+
+            if (response.delay.count() > 0)
+            {
+                std::this_thread::sleep_for(response.delay);
+            }
+
+            if (response.reset)
+            {
+                const linger abort{1, 0};
+                ::setsockopt(fd, SOL_SOCKET, SO_LINGER, &abort, sizeof(abort));
+                return;
+            }
+
+            std::string data = "HTTP/1.1 " + std::to_string(response.status) + " " + reasonOf(response.status) + "\r\n";
+
+            for (const auto& [name, value] : response.headers)
+            {
+                data += name + ": " + value + "\r\n";
+            }
+
+            if (response.chunks.empty())
+            {
+                data += "Content-Length: " + std::to_string(response.body.size()) + "\r\n\r\n" + response.body;
+            }
+            else
+            {
+                data += "Transfer-Encoding: chunked\r\n\r\n";
+
+                for (const auto& chunk : response.chunks)
+                {
+                    std::array<char, 20> size;
+                    std::snprintf(size.data(), size.size(), "%zx\r\n", chunk.size());
+                    data += size.data() + chunk + "\r\n";
+                }
+                data += "0\r\n\r\n";
+            }
+
+            const bool close = toLower(request.headers["connection"]) == "close";
+
+            if (!writeAll(fd, data) || close)
+            {
+                return;
+            }
+            request = Request{};
+        }
+    }
+
+    MockHttpServer::Response MockHttpServer::handle(Request& request)
+    {
+        bool decoded{true};
+
+        if (toLower(request.headers["content-encoding"]) == "gzip")
+        {
+#ifdef MOCK_HTTP_SERVER_WITH_ZLIB
+            std::string body;
+            decoded = gunzip(request.body, body);
+            request.body = std::move(body);
+#else
+            decoded = false;
+#endif
+        }
+
+        Handler handler;
+        Response response;
+        {
+            std::lock_guard lock{mMutex};
+            ++mStatistics.requests;
+
+            if (pathOf(request.target) == "/write")
+            {
+                ++mStatistics.writes;
+                mStatistics.bytes += request.body.size();
+                mStatistics.lines += countLines(request.body);
+            }
+            if (mRecordRequests)
+            {
+                mRequests.push_back(request);
+            }
+            handler = mHandler;
+
+            if (!handler)
+            {
+                response = decoded ? respondLikeInfluxDB(request) : Response{415, R"({"error":"unsupported content encoding"})", {}};
+            }
+        }
+        mReceived.notify_all();
+
+        if (handler)
+        {
+            response = handler(request);
+        }
+
+        std::lock_guard lock{mMutex};
+        injectFaults(response);
+        return response;
+    }
+
+    MockHttpServer::Response MockHttpServer::respondLikeInfluxDB(const Request& request) const
+    {
+        const auto path = pathOf(request.target);
+
+        if (path == "/write")
+        {
+            return Response{};
+        }
+        if (path == "/ping")
+        {
+            return Response{204, "", {{"X-Influxdb-Version", "mock"}}};
+        }
+        if (path != "/query")
+        {
+            return Response{404, R"({"error":"not found"})", {}};
+        }
+
+        Response response{200, "", {{"Content-Type", "application/json"}}};
+
+        if (parameterOf(request.target, "chunked") == "true")
+        {
+            const auto chunkSize = parameterOf(request.target, "chunk_size");
+            response.chunks = mGeneratedQueryRows > 0 ? generateRows(mGeneratedQueryRows, chunkSize.empty() ? 10000 : std::stoul(chunkSize))
+                                                      : std::vector<std::string>{mQueryResponse};
+
+            for (auto& chunk : response.chunks)
+            {
+                chunk += '\n';
+            }
+            return response;
+        }
+
+        response.body = mGeneratedQueryRows > 0 ? generateRows(mGeneratedQueryRows, mGeneratedQueryRows).front() : mQueryResponse;
+
+#ifdef MOCK_HTTP_SERVER_WITH_ZLIB
+        if (const auto accepted = request.headers.find("accept-encoding"); accepted != request.headers.end() && toLower(accepted->second).find("gzip") != std::string::npos)
+        {
+            response.body = gzip(response.body);
+            response.headers.emplace_back("Content-Encoding", "gzip");
+        }
+#endif
+        return response;
+    }
+
+    void MockHttpServer::injectFaults(Response& response)
+    {
+        std::uniform_real_distribution<double> draw{0.0, 1.0};
+        const double value = draw(mRandom);
+        double bound{mFaults.resetRate};
+
+        response.delay += mFaults.latency;
+
+        if (value < bound)
+        {
+            response.reset = true;
+        }
+        else if (value < (bound += mFaults.throttleRate))
+        {
+            response = Response{429, R"({"error":"too many requests"})", {{"Retry-After", std::to_string(mFaults.retryAfterSeconds)}}, {}, response.delay};
+        }
+        else if (value < (bound += mFaults.unavailableRate))
+        {
+            response = Response{503, R"({"error":"service unavailable"})", {{"Retry-After", std::to_string(mFaults.retryAfterSeconds)}}, {}, response.delay};
+        }
+        else if (value < (bound += mFaults.errorRate))
+        {
+            response = Response{mFaults.errorStatus, R"({"error":"injected"})", {}, {}, response.delay};
+        }
+    }
+}
@@ -0,0 +1,173 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace influxdb::test
+{
+    /// \brief Minimal HTTP/1.1 server on the loopback interface
+    ///
+    /// Answers like InfluxDB unless a handler is set: /write and /ping with 204, /query
+    /// with a canned or generated response, chunked if requested with chunked=true.
+    /// Gzip request bodies are decoded and query responses compressed if accepted (if
+    /// built with zlib). Faults like latency, errors and connection resets are injected
+    /// into any response. Connections are kept alive as long as the client wants.
+    class MockHttpServer
+    {
+    public:
+        struct Request
+        {
+            std::string method;
+            std::string target;
+            std::map<std::string, std::string> headers;
+            std::string body;
+        };
+
+        struct Response
+        {
+            int status{204};
+            std::string body;
+            std::vector<std::pair<std::string, std::string>> headers;
+
+            /// Sent with chunked transfer encoding instead of body if not empty
+            std::vector<std::string> chunks{};
+
+            /// Delay before responding
+            std::chrono::milliseconds delay{0};
+
+            /// Resets the connection instead of responding
+            bool reset{false};
+        };
+
+        /// Faults injected per request, drawn from a generator with fixed seed
+        struct Faults
+        {
+            /// Added to every response
+            std::chrono::milliseconds latency{0};
+
+            /// Fraction of requests answered with errorStatus
+            double errorRate{0.0};
+            int errorStatus{500};
+
+            /// Fraction of requests answered with 429 or 503 and Retry-After
+            double throttleRate{0.0};
+            double unavailableRate{0.0};
+            int retryAfterSeconds{1};
+
+            /// Fraction of requests answered by resetting the connection
+            double resetRate{0.0};
+        };
+
+        struct Statistics
+        {
+            /// Requests received
+            std::uint64_t requests;
+
+            /// Requests to /write
+            std::uint64_t writes;
+
+            /// Decoded body bytes and non-empty lines written
+            std::uint64_t bytes;
+            std::uint64_t lines;
+        };
+
+        using Handler = std::function<Response(const Request&)>;
+
+        MockHttpServer();
+        explicit MockHttpServer(Handler handler);
+        ~MockHttpServer();
+
+        MockHttpServer(const MockHttpServer&) = delete;
+        MockHttpServer& operator=(const MockHttpServer&) = delete;
+
+        /// Base URL, e.g. http://127.0.0.1:40123
+        std::string url() const;
+
+        int port() const;
+
+        /// Answers requests with handler instead of InfluxDB behaviour
+        void setHandler(Handler handler);
+
+        void setFaults(const Faults& faults);
+
+        /// Body of responses to /query
+        void setQueryResponse(std::string json);
+
+        /// Answers /query with a generated series of rows instead
+        void setGeneratedQueryRows(std::size_t rows);
+
+        /// Stops keeping requests(), e.g. for throughput tests
+        void setRecordRequests(bool record);
+
+        /// Returns all requests received so far
+        std::vector<Request> requests() const;
+
+        Statistics statistics() const;
+
+        /// Waits until predicate holds for the requests received
+        bool waitFor(const std::function<bool(const std::vector<Request>&)>& predicate, std::chrono::milliseconds timeout) const;
+
+    private:
+        struct Connection
+        {
+            std::thread thread;
+            std::atomic<bool> done{false};
+        };
+
+        void accept();
+        void serve(int fd);
+        Response handle(Request& request);
+        Response respondLikeInfluxDB(const Request& request) const;
+        void injectFaults(Response& response);
+
+        int mSocket;
+        int mPort;
+        std::atomic<bool> mRunning;
+        std::thread mAcceptThread;
+        std::list<Connection> mConnections;
+        mutable std::mutex mMutex;
+        mutable std::condition_variable mReceived;
+        Handler mHandler;
+        Faults mFaults;
+        std::mt19937 mRandom;
+        std::string mQueryResponse;
+        std::size_t mGeneratedQueryRows;
+        bool mRecordRequests;
+        std::vector<Request> mRequests;
+        Statistics mStatistics;
+    };
+}
@@ -0,0 +1,130 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "InfluxDBException.h"
+#include "Transport.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace influxdb::test
+{
+    /// Messages received by the RecordingTransports sharing it, and controls to stall or fail them
+    struct Recorder
+    {
+        std::mutex mutex{};
+        std::condition_variable changed{};
+
+        /// Messages received, and their lines without timestamp per transport index
+        std::vector<std::shared_ptr<const std::string>> messages{};
+        std::map<std::size_t, std::vector<std::string>> lines{};
+
+        /// Sends attempted, and the number of next sends failing
+        std::size_t attempts{0};
+        std::size_t failures{0};
+
+        /// Sends wait while set
+        bool blocked{false};
+
+        /// Waits up to 5 s until count messages were received
+        bool waitForMessages(std::size_t count)
+        {
+            std::unique_lock lock{mutex};
+            return changed.wait_for(lock, std::chrono::seconds{5}, [this, count]
+                                    { return messages.size() >= count; });
+        }
+
+        /// Removes and returns the lines received by the transport of index
+        std::vector<std::string> take(std::size_t index = 0)
+        {
+            std::lock_guard lock{mutex};
+            return std::exchange(lines[index], {});
+        }
+
+        void setBlocked(bool block)
+        {
+            {
+                std::lock_guard lock{mutex};
+                blocked = block;
+            }
+            changed.notify_all();
+        }
+    };
+
+
+    /// Transport recording messages to a Recorder, always failing if fail is set
+    class RecordingTransport : public Transport
+    {
+    public:
+        explicit RecordingTransport(Recorder& recorder, std::size_t index = 0, bool fail = false)
+            : mRecorder(recorder), mIndex(index), mFail(fail)
+        {
+        }
+
+        void send(std::string&& message) override
+        {
+            sendShared(std::make_shared<const std::string>(std::move(message)));
+        }
+
+        void sendShared(const std::shared_ptr<const std::string>& message) override
+        {
+            std::unique_lock lock{mRecorder.mutex};
+            ++mRecorder.attempts;
+            mRecorder.changed.notify_all();
+            mRecorder.changed.wait(lock, [this]
+                                   { return !mRecorder.blocked; });
+
+            if (mFail)
+            {
+                throw InfluxDBException{"Unavailable"};
+            }
+            if (mRecorder.failures > 0)
+            {
+                --mRecorder.failures;
+                throw InfluxDBException{"Unavailable"};
+            }
+
+            mRecorder.messages.push_back(message);
+            std::istringstream stream{*message};
+            for (std::string line; std::getline(stream, line);)
+            {
+                mRecorder.lines[mIndex].push_back(line.substr(0, line.rfind(' ')));
+            }
+            mRecorder.changed.notify_all();
+        }
+
+    private:
+        Recorder& mRecorder;
+        std::size_t mIndex;
+        bool mFail;
+    };
+
+}
@@ -0,0 +1,343 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "InfluxDBFactory.h"
+#include "InfluxDBException.h"
+#include "Histogram.h"
+#include "MockHttpServer.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <unistd.h>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+namespace
+{
+    using influxdb::test::MockHttpServer;
+    using namespace std::chrono_literals;
+
+    struct Configuration
+    {
+        std::chrono::seconds duration{3600};
+        std::chrono::seconds sampleInterval{10};
+        std::chrono::seconds warmup{60};
+        std::chrono::seconds reconnectInterval{300};
+        double rate{10000.0};
+        std::size_t batchSize{1000};
+        std::size_t series{1000};
+        MockHttpServer::Faults faults{std::chrono::milliseconds{1}, 0.01, 500, 0.0, 0.01, 1, 0.005};
+
+        /// Allowed growth of late over early samples, as fraction
+        double maxRssGrowth{0.1};
+        double maxP99Growth{1.0};
+    };
+
+    struct Sample
+    {
+        std::chrono::seconds elapsed;
+        std::size_t rss;
+        std::size_t heapInUse;
+        std::size_t heapFree;
+        double p50;
+        double p99;
+        std::uint64_t points;
+        std::uint64_t failedSends;
+        std::uint64_t dropped;
+    };
+
+    void printUsage(const char* program)
+    {
+        std::fprintf(stderr,
+                     "Usage: %s [options]\n"
+                     "\n"
+                     "  --duration S             run time (default 3600)\n"
+                     "  --sample-interval S      interval of samples (default 10)\n"
+                     "  --warmup S               samples before are not compared (default 60)\n"
+                     "  --reconnect-interval S   interval to recreate the client, 0 never (default 300)\n"
+                     "  --rate N                 points per second (default 10000)\n"
+                     "  --batch-size N           points per batch (default 1000)\n"
+                     "  --series N               distinct series (default 1000)\n"
+                     "  --latency MS             latency of the server (default 1)\n"
+                     "  --error-rate F           fraction of requests failing with 500 (default 0.01)\n"
+                     "  --unavailable-rate F     fraction of requests failing with 503 (default 0.01)\n"
+                     "  --reset-rate F           fraction of connections reset (default 0.005)\n"
+                     "  --max-rss-growth F       allowed RSS growth of late over early samples (default 0.1)\n"
+                     "  --max-p99-growth F       allowed p99 write latency growth (default 1.0)\n",
+                     program);
+    }
+
+    /// Resident set size in bytes, 0 if unknown
+    std::size_t residentSetSize()
+    {
+        std::ifstream statm{"/proc/self/statm"};
+        std::size_t size{0};
+        std::size_t resident{0};
+
+        if (!(statm >> size >> resident))
+        {
+            return 0;
+        }
+        return resident * static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    }
+
+    /// Bytes allocated and free but retained by malloc, zero if not glibc
+    std::pair<std::size_t, std::size_t> heapStatistics()
+    {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+        const auto info = ::mallinfo2();
+        return {info.uordblks + info.hblkhd, info.fordblks};
+#else
+        return {0, 0};
+#endif
+    }
+
+    influxdb::Point makePoint(std::size_t index, std::size_t series)
+    {
+        return influxdb::Point{"soak"}
+            .addTag("host", "host" + std::to_string(index % series))
+            .addTag("region", "eu-central-1")
+            .addField("value", static_cast<double>(index % 100))
+            .addField("count", static_cast<long long int>(index));
+    }
+
+    std::unique_ptr<influxdb::InfluxDB> connect(const MockHttpServer& server, const Configuration& configuration)
+    {
+        auto db = influxdb::InfluxDBFactory::Get(server.url() + "?db=soak");
+        db->batchOf(configuration.batchSize);
+        db->setBufferLimit(configuration.batchSize * 10, configuration.batchSize * 10 * 1024, influxdb::InfluxDB::OverflowPolicy::DropOldest);
+        return db;
+    }
+
+    double median(std::vector<double> values)
+    {
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2), values.end());
+        return values[values.size() / 2];
+    }
+
+    /// Compares the median of the first and last quarter of values, true if within maxGrowth
+    bool checkDrift(const char* name, const std::vector<double>& values, double maxGrowth)
+    {
+        const auto quarter = std::max<std::size_t>(values.size() / 4, 1);
+        const double early = median({values.begin(), values.begin() + static_cast<std::ptrdiff_t>(quarter)});
+        const double late = median({values.end() - static_cast<std::ptrdiff_t>(quarter), values.end()});
+        const bool passed = early <= 0.0 || late <= early * (1.0 + maxGrowth);
+
+        std::printf("%s: early %.2f, late %.2f (%+.1f%%, allowed %+.1f%%): %s\n", name, early, late,
+                    early > 0.0 ? (late / early - 1.0) * 100.0 : 0.0, maxGrowth * 100.0, passed ? "passed" : "FAILED");
+        return passed;
+    }
+
+    std::vector<Sample> run(const Configuration& configuration)
+    {
+        MockHttpServer server;
+        server.setRecordRequests(false);
+        server.setFaults(configuration.faults);
+
+        influxdb::Histogram writeLatency;
+        std::vector<Sample> samples;
+        auto db = connect(server, configuration);
+        std::uint64_t points{0};
+
+        // Of clients replaced by reconnects
+        std::uint64_t failedSends{0};
+        std::uint64_t dropped{0};
+        const auto start = std::chrono::steady_clock::now();
+        const auto end = start + configuration.duration;
+        const std::chrono::duration<double> period{1.0 / configuration.rate};
+        auto nextSample = start + configuration.sampleInterval;
+        auto nextReconnect = start + configuration.reconnectInterval;
+
+        std::printf("elapsed_s,rss_mb,heap_in_use_mb,heap_free_mb,p50_us,p99_us,points,failed_sends,dropped\n");
+
+        while (std::chrono::steady_clock::now() < end)
+        {
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(period * static_cast<double>(points)));
+
+            const auto writeStart = std::chrono::steady_clock::now();
+            try
+            {
+                db->write(makePoint(static_cast<std::size_t>(points), configuration.series));
+            }
+            catch (const std::exception&)
+            {
+                // Counted as failed send
+            }
+            const auto now = std::chrono::steady_clock::now();
+            writeLatency.record(std::chrono::duration<double, std::micro>(now - writeStart).count());
+            ++points;
+
+            if (configuration.reconnectInterval.count() > 0 && now >= nextReconnect)
+            {
+                const auto statistics = db->stats();
+                failedSends += statistics.failedSends;
+                dropped += statistics.dropped;
+                db.reset();
+                db = connect(server, configuration);
+                nextReconnect += configuration.reconnectInterval;
+            }
+
+            if (now >= nextSample)
+            {
+                const auto latency = writeLatency.collect();
+                const auto [heapInUse, heapFree] = heapStatistics();
+                const auto statistics = db->stats();
+                samples.push_back({std::chrono::duration_cast<std::chrono::seconds>(now - start), residentSetSize(), heapInUse, heapFree,
+                                   latency.quantile(0.5), latency.quantile(0.99), points,
+                                   failedSends + statistics.failedSends, dropped + statistics.dropped});
+
+                const auto& sample = samples.back();
+                std::printf("%lld,%.2f,%.2f,%.2f,%.1f,%.1f,%llu,%llu,%llu\n", static_cast<long long>(sample.elapsed.count()),
+                            static_cast<double>(sample.rss) / 1e6, static_cast<double>(sample.heapInUse) / 1e6,
+                            static_cast<double>(sample.heapFree) / 1e6, sample.p50, sample.p99,
+                            static_cast<unsigned long long>(sample.points), static_cast<unsigned long long>(sample.failedSends),
+                            static_cast<unsigned long long>(sample.dropped));
+                std::fflush(stdout);
+                nextSample += configuration.sampleInterval;
+            }
+        }
+        return samples;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Configuration configuration;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option{argv[i]};
+
+            if (option == "--help" || option == "-h")
+            {
+                printUsage(argv[0]);
+                return EXIT_SUCCESS;
+            }
+            if (i + 1 >= argc)
+            {
+                throw influxdb::InfluxDBException{"Missing value for " + option};
+            }
+
+            const std::string value{argv[++i]};
+
+            if (option == "--duration")
+            {
+                configuration.duration = std::chrono::seconds{std::stol(value)};
+            }
+            else if (option == "--sample-interval")
+            {
+                configuration.sampleInterval = std::chrono::seconds{std::stol(value)};
+            }
+            else if (option == "--warmup")
+            {
+                configuration.warmup = std::chrono::seconds{std::stol(value)};
+            }
+            else if (option == "--reconnect-interval")
+            {
+                configuration.reconnectInterval = std::chrono::seconds{std::stol(value)};
+            }
+            else if (option == "--rate")
+            {
+                configuration.rate = std::stod(value);
+            }
+            else if (option == "--batch-size")
+            {
+                configuration.batchSize = std::stoul(value);
+            }
+            else if (option == "--series")
+            {
+                configuration.series = std::stoul(value);
+            }
+            else if (option == "--latency")
+            {
+                configuration.faults.latency = std::chrono::milliseconds{std::stol(value)};
+            }
+            else if (option == "--error-rate")
+            {
+                configuration.faults.errorRate = std::stod(value);
+            }
+            else if (option == "--unavailable-rate")
+            {
+                configuration.faults.unavailableRate = std::stod(value);
+            }
+            else if (option == "--reset-rate")
+            {
+                configuration.faults.resetRate = std::stod(value);
+            }
+            else if (option == "--max-rss-growth")
+            {
+                configuration.maxRssGrowth = std::stod(value);
+            }
+            else if (option == "--max-p99-growth")
+            {
+                configuration.maxP99Growth = std::stod(value);
+            }
+            else
+            {
+                throw influxdb::InfluxDBException{"Unknown option " + option};
+            }
+        }
+
+        if (configuration.rate <= 0.0 || configuration.batchSize == 0 || configuration.series == 0 || configuration.sampleInterval.count() <= 0)
+        {
+            throw influxdb::InfluxDBException{"Rate, batch size, series and sample interval must be positive"};
+        }
+
+        const auto samples = run(configuration);
+        std::vector<double> rss;
+        std::vector<double> p99;
+
+        for (const auto& sample : samples)
+        {
+            if (sample.elapsed >= configuration.warmup)
+            {
+                rss.push_back(static_cast<double>(sample.rss) / 1e6);
+                p99.push_back(sample.p99);
+            }
+        }
+
+        if (rss.size() < 2)
+        {
+            throw influxdb::InfluxDBException{"Too few samples after warmup, increase the duration"};
+        }
+
+        const bool rssPassed = checkDrift("RSS MB", rss, configuration.maxRssGrowth);
+        const bool latencyPassed = checkDrift("p99 write latency us", p99, configuration.maxP99Growth);
+        return rssPassed && latencyPassed ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "SoakTest: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+}
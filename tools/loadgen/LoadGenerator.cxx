@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LoadGenerator.h"
+#include "InfluxDBException.h"
+#include "InfluxDBFactory.h"
+#include <atomic>
+#include <ctime>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace influxdb::loadgen
+{
+    LoadGenerator::LoadGenerator(Configuration configuration)
+        : mConfiguration(std::move(configuration))
+    {
+        if (mConfiguration.threads == 0 || mConfiguration.batchSize == 0 || mConfiguration.rate < 0.0)
+        {
+            throw InfluxDBException{"Invalid load generator configuration"};
+        }
+    }
+
+    LoadGenerator::Report LoadGenerator::run()
+    {
+        // Created up front, so an invalid URL fails before any thread starts
+        std::vector<std::unique_ptr<InfluxDB>> clients;
+        std::vector<Workload> workloads;
+
+        for (std::size_t i = 0; i < mConfiguration.threads; ++i)
+        {
+            clients.push_back(InfluxDBFactory::Get(mConfiguration.url));
+
+            if (mConfiguration.batchSize > 1)
+            {
+                clients.back()->batchOf(mConfiguration.batchSize);
+
+                // A failed batch counts as error instead of being resent with the next one
+                clients.back()->setDiscardFailedBatches(true);
+            }
+            workloads.emplace_back(mConfiguration.workload, i, mConfiguration.threads);
+        }
+
+        Histogram writeLatency;
+        std::atomic<std::uint64_t> points{0};
+        std::atomic<std::uint64_t> errors{0};
+        std::vector<std::thread> threads;
+        const auto start = std::chrono::steady_clock::now();
+        const std::clock_t cpuStart = std::clock();
+
+        for (std::size_t i = 0; i < mConfiguration.threads; ++i)
+        {
+            const std::uint64_t limit = mConfiguration.points / mConfiguration.threads + (i < mConfiguration.points % mConfiguration.threads ? 1 : 0);
+
+            threads.emplace_back([this, &client = *clients[i], &workload = workloads[i], &writeLatency, &points, &errors, start, limit]
+                                 { points += write(client, workload, writeLatency, errors, start, limit); });
+        }
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        Report report{points, 0, errors, std::chrono::steady_clock::now() - start,
+                      std::chrono::duration<double>{static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC},
+                      writeLatency.snapshot(), clients.front()->stats().sendLatency};
+
+        for (std::size_t i = 0; i < clients.size(); ++i)
+        {
+            const auto statistics = clients[i]->stats();
+            report.bytes += statistics.bytes;
+
+            if (i > 0)
+            {
+                report.sendLatency.merge(statistics.sendLatency);
+            }
+        }
+        return report;
+    }
+
+    std::uint64_t LoadGenerator::write(InfluxDB& client, Workload& workload, Histogram& writeLatency, std::atomic<std::uint64_t>& errors,
+                                       std::chrono::steady_clock::time_point start, std::uint64_t limit) const
+    {
+        const auto end = start + mConfiguration.duration;
+        const std::chrono::duration<double> period{mConfiguration.rate > 0.0 ? static_cast<double>(mConfiguration.threads) / mConfiguration.rate : 0.0};
+        std::uint64_t written{0};
+
+        while ((mConfiguration.points == 0 || written < limit) && std::chrono::steady_clock::now() < end)
+        {
+            if (period.count() > 0.0)
+            {
+                std::this_thread::sleep_until(start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(period * static_cast<double>(written)));
+            }
+
+            Point point = workload.next();
+            const auto writeStart = std::chrono::steady_clock::now();
+
+            try
+            {
+                client.write(std::move(point));
+            }
+            catch (const std::exception&)
+            {
+                ++errors;
+            }
+            writeLatency.record(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - writeStart).count());
+            ++written;
+        }
+
+        try
+        {
+            client.flushBatch();
+        }
+        catch (const std::exception&)
+        {
+            ++errors;
+        }
+        return written;
+    }
+}
@@ -0,0 +1,97 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Histogram.h"
+#include "InfluxDB.h"
+#include "Workload.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace influxdb::loadgen
+{
+    /// \brief Writes a workload from several threads and measures the client
+    ///
+    /// Each thread has its own client for the URL and writes its part of the
+    /// series, paced to its share of the rate.
+    class LoadGenerator
+    {
+    public:
+        struct Configuration
+        {
+            /// Target URL as accepted by InfluxDBFactory
+            std::string url;
+
+            std::size_t threads{1};
+
+            /// Points per batch, 1 disables batching
+            std::size_t batchSize{5000};
+
+            /// Points per second of all threads, 0 is unlimited
+            double rate{0.0};
+
+            /// Stops after duration or once points are written, whichever comes first
+            std::chrono::milliseconds duration{std::chrono::seconds{10}};
+            std::uint64_t points{0};
+
+            Workload::Configuration workload;
+        };
+
+        struct Report
+        {
+            std::uint64_t points;
+            std::uint64_t bytes;
+
+            /// Failed writes and sends
+            std::uint64_t errors;
+
+            std::chrono::duration<double> elapsed;
+
+            /// Processor time of the process
+            std::chrono::duration<double> cpuTime;
+
+            /// Latency of write() calls in microseconds
+            HistogramSnapshot writeLatency;
+
+            /// Latency of sends in milliseconds
+            HistogramSnapshot sendLatency;
+        };
+
+        /// \throw InfluxDBException   if the configuration is invalid
+        explicit LoadGenerator(Configuration configuration);
+
+        /// Runs the workload until done
+        /// \throw InfluxDBException   if the URL is invalid
+        Report run();
+
+    private:
+        /// Writes points of workload until done, returns the number written
+        std::uint64_t write(InfluxDB& client, Workload& workload, Histogram& writeLatency, std::atomic<std::uint64_t>& errors,
+                            std::chrono::steady_clock::time_point start, std::uint64_t limit) const;
+
+        const Configuration mConfiguration;
+    };
+}
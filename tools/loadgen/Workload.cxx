@@ -0,0 +1,190 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Workload.h"
+#include "InfluxDBException.h"
+#include <algorithm>
+#include <array>
+#include <iterator>
+
+namespace influxdb::loadgen
+{
+    namespace
+    {
+        constexpr std::array<const char*, 10> devopsFields{"usage_user", "usage_system", "usage_idle", "usage_nice", "usage_iowait",
+                                                           "usage_irq", "usage_softirq", "usage_steal", "usage_guest", "usage_guest_nice"};
+        constexpr std::array<const char*, 9> regions{"us-east-1", "us-west-1", "us-west-2", "eu-west-1", "eu-central-1",
+                                                     "ap-southeast-1", "ap-southeast-2", "ap-northeast-1", "sa-east-1"};
+        constexpr std::array<const char*, 3> operatingSystems{"Ubuntu16.10", "Ubuntu16.04LTS", "Ubuntu15.10"};
+        constexpr std::array<const char*, 2> architectures{"x64", "x86"};
+        constexpr std::array<const char*, 4> teams{"SF", "NYC", "LON", "CHI"};
+        constexpr std::array<const char*, 2> environments{"production", "staging"};
+
+        template <std::size_t n>
+        std::string pick(const std::array<const char*, n>& values, std::mt19937& random)
+        {
+            return values[std::uniform_int_distribution<std::size_t>{0, n - 1}(random)];
+        }
+
+        std::string number(std::mt19937& random, std::size_t max)
+        {
+            return std::to_string(std::uniform_int_distribution<std::size_t>{0, max}(random));
+        }
+    }
+
+
+    Workload::Workload(const Configuration& configuration, std::size_t part, std::size_t workers)
+        : mConfiguration(configuration),
+          mMeasurement(configuration.devops ? "cpu" : "loadgen"),
+          mFieldNames(),
+          mSeries(),
+          mRandom(configuration.seed + static_cast<std::uint32_t>(part)),
+          mNext(0),
+          mRound(0)
+    {
+        if (workers == 0 || part >= workers || configuration.series < workers || configuration.tags == 0
+            || configuration.tagCardinality == 0 || configuration.interval.count() <= 0)
+        {
+            throw InfluxDBException{"Invalid workload"};
+        }
+
+        if (configuration.devops)
+        {
+            mFieldNames.assign(devopsFields.begin(), devopsFields.end());
+        }
+        else
+        {
+            for (std::size_t i = 0; i < configuration.fields; ++i)
+            {
+                mFieldNames.push_back("field" + std::to_string(i));
+            }
+        }
+
+        for (std::size_t index = part; index < configuration.series; index += workers)
+        {
+            Series& series = mSeries.emplace_back();
+
+            if (configuration.devops)
+            {
+                const auto region = pick(regions, mRandom);
+                series.tags = {{"hostname", "host_" + std::to_string(index)},
+                               {"region", region},
+                               {"datacenter", region + static_cast<char>('a' + std::uniform_int_distribution<int>{0, 2}(mRandom))},
+                               {"rack", number(mRandom, 99)},
+                               {"os", pick(operatingSystems, mRandom)},
+                               {"arch", pick(architectures, mRandom)},
+                               {"team", pick(teams, mRandom)},
+                               {"service", number(mRandom, 19)},
+                               {"service_version", number(mRandom, 1)},
+                               {"service_environment", pick(environments, mRandom)}};
+            }
+            else
+            {
+                // Mixed radix digits of the index, so every series has distinct tags
+                std::size_t remaining{index};
+
+                for (std::size_t tag = 0; tag < configuration.tags; ++tag)
+                {
+                    const bool last = tag + 1 == configuration.tags;
+                    const auto value = last ? remaining : remaining % configuration.tagCardinality;
+                    series.tags.emplace_back("tag" + std::to_string(tag), "value" + std::to_string(value));
+                    remaining /= configuration.tagCardinality;
+                }
+            }
+
+            std::uniform_real_distribution<double> initial{0.0, 100.0};
+            std::generate_n(std::back_inserter(series.values), mFieldNames.size(), [this, &initial]
+                            { return initial(mRandom); });
+        }
+    }
+
+    Point Workload::next()
+    {
+        Series& series = mSeries[mNext];
+        Point point{mMeasurement};
+
+        for (const auto& [key, value] : series.tags)
+        {
+            point.addTag(key, value);
+        }
+
+        addFields(point, series);
+        point.setTimestamp(timestamp());
+
+        if (++mNext == mSeries.size())
+        {
+            mNext = 0;
+            ++mRound;
+        }
+        return point;
+    }
+
+    std::size_t Workload::series() const
+    {
+        return mSeries.size();
+    }
+
+    void Workload::addFields(Point& point, Series& series)
+    {
+        std::uniform_real_distribution<double> step{-1.0, 1.0};
+
+        for (std::size_t i = 0; i < mFieldNames.size(); ++i)
+        {
+            // Random walk within [0, 100], like the TSBS cpu usage
+            auto& value = series.values[i];
+            value = std::clamp(value + step(mRandom), 0.0, 100.0);
+
+            if (mConfiguration.devops)
+            {
+                point.addField(mFieldNames[i], static_cast<long long int>(value));
+                continue;
+            }
+
+            switch (mConfiguration.fieldType)
+            {
+                case FieldType::Float:
+                    point.addField(mFieldNames[i], value);
+                    break;
+                case FieldType::Integer:
+                    point.addField(mFieldNames[i], static_cast<long long int>(value));
+                    break;
+                case FieldType::Boolean:
+                    point.addField(mFieldNames[i], value >= 50.0);
+                    break;
+                case FieldType::String:
+                    point.addField(mFieldNames[i], "value" + std::to_string(static_cast<int>(value)));
+                    break;
+            }
+        }
+    }
+
+    std::chrono::system_clock::time_point Workload::timestamp()
+    {
+        auto round = mRound;
+
+        if (mConfiguration.shuffleWindow > 0)
+        {
+            round -= std::uniform_int_distribution<std::uint64_t>{0, std::min<std::uint64_t>(mRound, mConfiguration.shuffleWindow - 1)}(mRandom);
+        }
+        return mConfiguration.start + std::chrono::duration_cast<std::chrono::system_clock::duration>(mConfiguration.interval * static_cast<std::int64_t>(round));
+    }
+}
@@ -0,0 +1,104 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "Point.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace influxdb::loadgen
+{
+    /// \brief Generates the points of a write workload
+    ///
+    /// Cycles through the series of a generator in rounds; the timestamp advances by
+    /// interval with each round. A workload split over several generators assigns
+    /// each series to exactly one of them.
+    class Workload
+    {
+    public:
+        enum class FieldType
+        {
+            Float,
+            Integer,
+            Boolean,
+            String
+        };
+
+        struct Configuration
+        {
+            /// Distinct series, i.e. tag sets
+            std::size_t series{1000};
+
+            /// Tags per point and distinct values per tag; the last tag takes whatever
+            /// values are needed to reach the number of series
+            std::size_t tags{3};
+            std::size_t tagCardinality{10};
+
+            std::size_t fields{5};
+            FieldType fieldType{FieldType::Float};
+
+            /// Timestamps are drawn from the last shuffleWindow rounds instead of
+            /// being ordered if > 0
+            std::size_t shuffleWindow{0};
+
+            /// Generates the TSBS "devops cpu" use case instead, one series per host
+            bool devops{false};
+
+            std::chrono::nanoseconds interval{std::chrono::seconds{10}};
+            std::chrono::system_clock::time_point start{std::chrono::seconds{1672531200}};
+            std::uint32_t seed{1};
+        };
+
+        /// Generator part of workers, with the series that have index part modulo workers
+        /// \throw InfluxDBException   if the configuration is invalid
+        Workload(const Configuration& configuration, std::size_t part = 0, std::size_t workers = 1);
+
+        /// Next point of the current round
+        Point next();
+
+        /// Series of this generator
+        std::size_t series() const;
+
+    private:
+        struct Series
+        {
+            std::vector<std::pair<std::string, std::string>> tags;
+            std::vector<double> values;
+        };
+
+        void addFields(Point& point, Series& series);
+        std::chrono::system_clock::time_point timestamp();
+
+        Configuration mConfiguration;
+        std::string mMeasurement;
+        std::vector<std::string> mFieldNames;
+        std::vector<Series> mSeries;
+        std::mt19937 mRandom;
+        std::size_t mNext;
+        std::uint64_t mRound;
+    };
+}
@@ -0,0 +1,204 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "LoadGenerator.h"
+#include "InfluxDBException.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+namespace
+{
+    using influxdb::loadgen::LoadGenerator;
+    using influxdb::loadgen::Workload;
+
+    void printUsage(const char* program)
+    {
+        std::fprintf(stderr,
+                     "Usage: %s --url URL [options]\n"
+                     "\n"
+                     "  --url URL                http://, udp://, tcp:// or unix:// URL as accepted by InfluxDBFactory\n"
+                     "  --threads N              writing threads, each with its own client (default 1)\n"
+                     "  --batch-size N           points per batch, 1 disables batching (default 5000)\n"
+                     "  --rate N                 points per second of all threads, 0 is unlimited (default 0)\n"
+                     "  --duration S             seconds to run (default 10)\n"
+                     "  --points N               stop after N points, 0 runs for the duration (default 0)\n"
+                     "  --series N               distinct series (default 1000)\n"
+                     "  --tags N                 tags per point (default 3)\n"
+                     "  --tag-cardinality N      values per tag (default 10)\n"
+                     "  --fields N               fields per point (default 5)\n"
+                     "  --field-type TYPE        float, integer, boolean or string (default float)\n"
+                     "  --interval MS            timestamp step per round of all series (default 10000)\n"
+                     "  --shuffle-window N       timestamps out of order within N rounds, 0 is ordered (default 0)\n"
+                     "  --devops                 TSBS devops cpu data, one series per host\n"
+                     "  --seed N                 random seed (default 1)\n",
+                     program);
+    }
+
+    Workload::FieldType fieldTypeOf(const std::string& value)
+    {
+        if (value == "float")
+        {
+            return Workload::FieldType::Float;
+        }
+        if (value == "integer")
+        {
+            return Workload::FieldType::Integer;
+        }
+        if (value == "boolean")
+        {
+            return Workload::FieldType::Boolean;
+        }
+        if (value == "string")
+        {
+            return Workload::FieldType::String;
+        }
+        throw influxdb::InfluxDBException{"Unknown field type " + value};
+    }
+
+    void report(const LoadGenerator::Report& result)
+    {
+        const double seconds = result.elapsed.count();
+        const double points = static_cast<double>(result.points);
+
+        std::printf("points %llu in %.2f s: %.0f points/s, %.2f MB/s, %.3f CPU s per million points, %llu errors\n",
+                    static_cast<unsigned long long>(result.points), seconds, points / seconds,
+                    static_cast<double>(result.bytes) / seconds / 1e6,
+                    points > 0.0 ? result.cpuTime.count() * 1e6 / points : 0.0,
+                    static_cast<unsigned long long>(result.errors));
+        std::printf("write latency us: p50 %.1f, p90 %.1f, p99 %.1f, p99.9 %.1f, max %.1f\n",
+                    result.writeLatency.quantile(0.5), result.writeLatency.quantile(0.9), result.writeLatency.quantile(0.99),
+                    result.writeLatency.quantile(0.999), result.writeLatency.max());
+        std::printf("send latency ms: p50 %.2f, p90 %.2f, p99 %.2f, p99.9 %.2f, max %.2f (%llu sends)\n",
+                    result.sendLatency.quantile(0.5), result.sendLatency.quantile(0.9), result.sendLatency.quantile(0.99),
+                    result.sendLatency.quantile(0.999), result.sendLatency.max(),
+                    static_cast<unsigned long long>(result.sendLatency.count()));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    LoadGenerator::Configuration configuration;
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option{argv[i]};
+
+            if (option == "--help" || option == "-h")
+            {
+                printUsage(argv[0]);
+                return EXIT_SUCCESS;
+            }
+            if (option == "--devops")
+            {
+                configuration.workload.devops = true;
+                continue;
+            }
+            if (i + 1 >= argc)
+            {
+                throw influxdb::InfluxDBException{"Missing value for " + option};
+            }
+
+            const std::string value{argv[++i]};
+
+            if (option == "--url")
+            {
+                configuration.url = value;
+            }
+            else if (option == "--threads")
+            {
+                configuration.threads = std::stoul(value);
+            }
+            else if (option == "--batch-size")
+            {
+                configuration.batchSize = std::stoul(value);
+            }
+            else if (option == "--rate")
+            {
+                configuration.rate = std::stod(value);
+            }
+            else if (option == "--duration")
+            {
+                configuration.duration = std::chrono::seconds{std::stol(value)};
+            }
+            else if (option == "--points")
+            {
+                configuration.points = std::stoull(value);
+            }
+            else if (option == "--series")
+            {
+                configuration.workload.series = std::stoul(value);
+            }
+            else if (option == "--tags")
+            {
+                configuration.workload.tags = std::stoul(value);
+            }
+            else if (option == "--tag-cardinality")
+            {
+                configuration.workload.tagCardinality = std::stoul(value);
+            }
+            else if (option == "--fields")
+            {
+                configuration.workload.fields = std::stoul(value);
+            }
+            else if (option == "--field-type")
+            {
+                configuration.workload.fieldType = fieldTypeOf(value);
+            }
+            else if (option == "--interval")
+            {
+                configuration.workload.interval = std::chrono::milliseconds{std::stol(value)};
+            }
+            else if (option == "--shuffle-window")
+            {
+                configuration.workload.shuffleWindow = std::stoul(value);
+            }
+            else if (option == "--seed")
+            {
+                configuration.workload.seed = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else
+            {
+                throw influxdb::InfluxDBException{"Unknown option " + option};
+            }
+        }
+
+        if (configuration.url.empty())
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        LoadGenerator generator{configuration};
+        report(generator.run());
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "influxdb-cxx-loadgen: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "BatchQueue.h"
+
+namespace influxdb::relay
+{
+    BatchQueue::BatchQueue(std::size_t batchBytes, std::size_t maxBatches, std::chrono::milliseconds flushInterval)
+        : mBatchBytes(batchBytes), mMaxBatches(maxBatches), mFlushInterval(flushInterval), mDropped(0), mClosed(false)
+    {
+    }
+
+    void BatchQueue::append(std::string_view lines)
+    {
+        if (lines.empty())
+        {
+            return;
+        }
+
+        std::lock_guard lock{mMutex};
+
+        if (mOpen.empty())
+        {
+            mOpenedAt = std::chrono::steady_clock::now();
+            mOpen.reserve(mBatchBytes);
+            mAvailable.notify_one();
+        }
+        mOpen.append(lines);
+
+        if (mOpen.size() >= mBatchBytes)
+        {
+            seal();
+        }
+    }
+
+    std::optional<std::string> BatchQueue::pop()
+    {
+        std::unique_lock lock{mMutex};
+
+        while (true)
+        {
+            if (mSealed.empty() && !mOpen.empty() && (mClosed || std::chrono::steady_clock::now() >= mOpenedAt + mFlushInterval))
+            {
+                seal();
+            }
+
+            if (!mSealed.empty())
+            {
+                auto batch = std::move(mSealed.front());
+                mSealed.pop_front();
+                return batch;
+            }
+
+            if (mClosed)
+            {
+                return std::nullopt;
+            }
+
+            if (mOpen.empty())
+            {
+                mAvailable.wait(lock);
+            }
+            else
+            {
+                mAvailable.wait_until(lock, mOpenedAt + mFlushInterval);
+            }
+        }
+    }
+
+    void BatchQueue::close()
+    {
+        {
+            std::lock_guard lock{mMutex};
+            mClosed = true;
+        }
+        mAvailable.notify_all();
+    }
+
+    std::size_t BatchQueue::dropped() const
+    {
+        std::lock_guard lock{mMutex};
+        return mDropped;
+    }
+
+    void BatchQueue::seal()
+    {
+        if (mSealed.size() >= mMaxBatches)
+        {
+            mSealed.pop_front();
+            ++mDropped;
+        }
+        mSealed.push_back(std::move(mOpen));
+        mOpen.clear();
+        mAvailable.notify_one();
+    }
+}
@@ -0,0 +1,72 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace influxdb::relay
+{
+    /// \brief Collects line protocol into batches sealed by size or age
+    ///
+    /// Producers append lines from any thread, consumers take sealed batches.
+    /// If consumers fall behind, the oldest sealed batch is dropped.
+    class BatchQueue
+    {
+    public:
+        BatchQueue(std::size_t batchBytes, std::size_t maxBatches, std::chrono::milliseconds flushInterval);
+
+        /// Appends newline terminated lines, seals the batch once it reaches the batch size
+        void append(std::string_view lines);
+
+        /// Waits for the next batch, seals the open batch once the flush interval passed
+        /// \return  batch or std::nullopt if the queue is closed and empty
+        std::optional<std::string> pop();
+
+        /// Seals the open batch and lets pop() return once all batches are taken
+        void close();
+
+        /// Number of sealed batches dropped
+        std::size_t dropped() const;
+
+    private:
+        void seal();
+
+        const std::size_t mBatchBytes;
+        const std::size_t mMaxBatches;
+        const std::chrono::milliseconds mFlushInterval;
+        mutable std::mutex mMutex;
+        std::condition_variable mAvailable;
+        std::string mOpen;
+        std::chrono::steady_clock::time_point mOpenedAt;
+        std::deque<std::string> mSealed;
+        std::size_t mDropped;
+        bool mClosed;
+    };
+}
@@ -0,0 +1,558 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Listener.h"
+#include "InfluxDBException.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <list>
+#include <thread>
+#include <vector>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace influxdb::relay
+{
+    namespace
+    {
+        constexpr int pollIntervalMs{100};
+        constexpr std::size_t maxDatagramBytes{65536};
+        constexpr std::size_t datagramsPerCall{64};
+        constexpr std::size_t streamChunkBytes{65536};
+
+        std::string systemError(const std::string& what)
+        {
+            return what + ": " + std::strerror(errno);
+        }
+
+        /// \brief Owns a socket file descriptor
+        class Socket
+        {
+        public:
+            explicit Socket(int fd = -1)
+                : mFd(fd)
+            {
+            }
+
+            Socket(Socket&& other) noexcept
+                : mFd(other.release())
+            {
+            }
+
+            Socket& operator=(Socket&& other) noexcept
+            {
+                if (this != &other)
+                {
+                    reset(other.release());
+                }
+                return *this;
+            }
+
+            Socket(const Socket&) = delete;
+            Socket& operator=(const Socket&) = delete;
+
+            ~Socket()
+            {
+                reset();
+            }
+
+            int get() const
+            {
+                return mFd;
+            }
+
+            int release()
+            {
+                const int fd = mFd;
+                mFd = -1;
+                return fd;
+            }
+
+            void reset(int fd = -1)
+            {
+                if (mFd >= 0)
+                {
+                    ::close(mFd);
+                }
+                mFd = fd;
+            }
+
+        private:
+            int mFd;
+        };
+
+        struct Address
+        {
+            std::string scheme;
+            std::string host;
+            std::string port;
+            std::string path;
+        };
+
+        Address parseUrl(const std::string& url)
+        {
+            const auto schemeEnd = url.find("://");
+
+            if (schemeEnd == std::string::npos)
+            {
+                throw InfluxDBException{"Ill-formed listen URI: " + url};
+            }
+
+            Address address;
+            address.scheme = url.substr(0, schemeEnd);
+            const std::string rest = url.substr(schemeEnd + 3);
+
+            if (address.scheme == "unix")
+            {
+                address.path = rest;
+                return address;
+            }
+
+            const auto portSeparator = rest.rfind(':');
+
+            if (portSeparator == std::string::npos || portSeparator + 1 == rest.size())
+            {
+                throw InfluxDBException{"Missing port in listen URI: " + url};
+            }
+            address.host = rest.substr(0, portSeparator);
+            address.port = rest.substr(portSeparator + 1);
+
+            if (address.host.size() >= 2 && address.host.front() == '[' && address.host.back() == ']')
+            {
+                address.host = address.host.substr(1, address.host.size() - 2);
+            }
+            return address;
+        }
+
+        Socket bindInet(const std::string& host, const std::string& port, int type, bool reusePort)
+        {
+            addrinfo hints{};
+            hints.ai_family = AF_UNSPEC;
+            hints.ai_socktype = type;
+            hints.ai_flags = AI_PASSIVE;
+            addrinfo* result{nullptr};
+
+            if (const int error = ::getaddrinfo(host.empty() ? nullptr : host.c_str(), port.c_str(), &hints, &result); error != 0)
+            {
+                throw InfluxDBException{"Unable to resolve " + host + ":" + port + ": " + ::gai_strerror(error)};
+            }
+
+            const std::unique_ptr<addrinfo, decltype(&::freeaddrinfo)> addresses{result, &::freeaddrinfo};
+            Socket socket{::socket(result->ai_family, result->ai_socktype, result->ai_protocol)};
+
+            if (socket.get() < 0)
+            {
+                throw InfluxDBException{systemError("Unable to create socket")};
+            }
+
+            const int enable{1};
+            ::setsockopt(socket.get(), SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+#ifdef __linux__
+            if (reusePort)
+            {
+                ::setsockopt(socket.get(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable));
+            }
+#else
+            static_cast<void>(reusePort);
+#endif
+
+            if (::bind(socket.get(), result->ai_addr, result->ai_addrlen) != 0)
+            {
+                throw InfluxDBException{systemError("Unable to bind " + host + ":" + port)};
+            }
+            return socket;
+        }
+
+        std::string localAddress(int fd, const std::string& scheme)
+        {
+            sockaddr_storage address{};
+            socklen_t length = sizeof(address);
+
+            if (::getsockname(fd, reinterpret_cast<sockaddr*>(&address), &length) != 0)
+            {
+                throw InfluxDBException{systemError("Unable to get socket address")};
+            }
+
+            std::array<char, NI_MAXHOST> host{};
+            std::array<char, NI_MAXSERV> port{};
+            ::getnameinfo(reinterpret_cast<sockaddr*>(&address), length, host.data(), host.size(), port.data(), port.size(), NI_NUMERICHOST | NI_NUMERICSERV);
+
+            const std::string hostName{host.data()};
+            const bool ipv6 = address.ss_family == AF_INET6;
+            return scheme + "://" + (ipv6 ? "[" + hostName + "]" : hostName) + ":" + port.data();
+        }
+
+        void setReceiveBuffer(int fd, std::size_t bytes)
+        {
+            if (bytes > 0)
+            {
+                const int size = static_cast<int>(bytes);
+                ::setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+            }
+        }
+
+        /// Waits until fd is readable, false on timeout
+        bool waitReadable(int fd)
+        {
+            pollfd descriptor{fd, POLLIN, 0};
+            return ::poll(&descriptor, 1, pollIntervalMs) > 0;
+        }
+
+        void appendLines(std::string& dest, std::string_view data)
+        {
+            if (!data.empty())
+            {
+                dest.append(data);
+
+                if (data.back() != '\n')
+                {
+                    dest.push_back('\n');
+                }
+            }
+        }
+
+
+        /// \brief Receives datagrams, each containing one or more lines
+        class UdpListener : public Listener
+        {
+        public:
+            UdpListener(const Address& address, std::size_t threads, std::size_t receiveBufferBytes, Sink sink)
+                : mSink(std::move(sink)), mRunning(false)
+            {
+#ifdef __linux__
+                // Each thread gets its own socket on the same port, the kernel distributes datagrams
+                mSockets.push_back(bindInet(address.host, address.port, SOCK_DGRAM, true));
+                const std::string bound = localAddress(mSockets.front().get(), "udp");
+                const std::string boundPort = bound.substr(bound.rfind(':') + 1);
+
+                for (std::size_t i = 1; i < threads; ++i)
+                {
+                    mSockets.push_back(bindInet(address.host, boundPort, SOCK_DGRAM, true));
+                }
+#else
+                static_cast<void>(threads);
+                mSockets.push_back(bindInet(address.host, address.port, SOCK_DGRAM, false));
+#endif
+                for (const auto& socket : mSockets)
+                {
+                    setReceiveBuffer(socket.get(), receiveBufferBytes);
+                }
+            }
+
+            ~UdpListener() override
+            {
+                stop();
+            }
+
+            void start() override
+            {
+                mRunning = true;
+
+                for (const auto& socket : mSockets)
+                {
+                    mThreads.emplace_back([this, fd = socket.get()]
+                                          { receive(fd); });
+                }
+            }
+
+            void stop() override
+            {
+                mRunning = false;
+
+                for (auto& thread : mThreads)
+                {
+                    thread.join();
+                }
+                mThreads.clear();
+            }
+
+            std::string endpoint() const override
+            {
+                return localAddress(mSockets.front().get(), "udp");
+            }
+
+        private:
+            void receive(int fd)
+            {
+                std::vector<char> buffer(datagramsPerCall * maxDatagramBytes);
+                std::string lines;
+#ifdef __linux__
+                std::vector<iovec> vectors(datagramsPerCall);
+                std::vector<mmsghdr> headers(datagramsPerCall);
+
+                for (std::size_t i = 0; i < datagramsPerCall; ++i)
+                {
+                    vectors[i] = iovec{buffer.data() + i * maxDatagramBytes, maxDatagramBytes};
+                    headers[i].msg_hdr.msg_iov = &vectors[i];
+                    headers[i].msg_hdr.msg_iovlen = 1;
+                }
+#endif
+
+                while (mRunning)
+                {
+                    if (!waitReadable(fd))
+                    {
+                        continue;
+                    }
+
+                    lines.clear();
+#ifdef __linux__
+                    const int received = ::recvmmsg(fd, headers.data(), static_cast<unsigned int>(datagramsPerCall), MSG_DONTWAIT, nullptr);
+
+                    for (int i = 0; i < received; ++i)
+                    {
+                        const auto index = static_cast<std::size_t>(i);
+
+                        if ((headers[index].msg_hdr.msg_flags & MSG_TRUNC) == 0)
+                        {
+                            appendLines(lines, {buffer.data() + index * maxDatagramBytes, headers[index].msg_len});
+                        }
+                    }
+#else
+                    int received{0};
+
+                    for (; received < static_cast<int>(datagramsPerCall); ++received)
+                    {
+                        const auto length = ::recv(fd, buffer.data(), maxDatagramBytes, MSG_DONTWAIT);
+
+                        if (length < 0)
+                        {
+                            break;
+                        }
+                        appendLines(lines, {buffer.data(), static_cast<std::size_t>(length)});
+                    }
+#endif
+                    if (received > 0)
+                    {
+                        mSink(lines, static_cast<std::size_t>(received));
+                    }
+                }
+            }
+
+            Sink mSink;
+            std::vector<Socket> mSockets;
+            std::vector<std::thread> mThreads;
+            std::atomic<bool> mRunning;
+        };
+
+
+        /// \brief Accepts stream connections (TCP, unix) of newline separated lines
+        class StreamListener : public Listener
+        {
+        public:
+            StreamListener(const Address& address, std::size_t receiveBufferBytes, Sink sink)
+                : mScheme(address.scheme), mPath(address.path), mReceiveBufferBytes(receiveBufferBytes), mSink(std::move(sink)), mRunning(false)
+            {
+                if (mScheme == "unix")
+                {
+                    mSocket = bindUnix(mPath);
+                }
+                else
+                {
+                    mSocket = bindInet(address.host, address.port, SOCK_STREAM, false);
+                }
+
+                if (::listen(mSocket.get(), SOMAXCONN) != 0)
+                {
+                    throw InfluxDBException{systemError("Unable to listen")};
+                }
+            }
+
+            ~StreamListener() override
+            {
+                stop();
+
+                if (!mPath.empty())
+                {
+                    ::unlink(mPath.c_str());
+                }
+            }
+
+            void start() override
+            {
+                mRunning = true;
+                mAcceptThread = std::thread{[this]
+                                            { accept(); }};
+            }
+
+            void stop() override
+            {
+                mRunning = false;
+
+                if (mAcceptThread.joinable())
+                {
+                    mAcceptThread.join();
+                }
+
+                for (auto& connection : mConnections)
+                {
+                    connection.thread.join();
+                }
+                mConnections.clear();
+            }
+
+            std::string endpoint() const override
+            {
+                return mScheme == "unix" ? "unix://" + mPath : localAddress(mSocket.get(), mScheme);
+            }
+
+        private:
+            struct Connection
+            {
+                std::thread thread;
+                std::atomic<bool> done{false};
+            };
+
+            static Socket bindUnix(const std::string& path)
+            {
+                sockaddr_un address{};
+
+                if (path.empty() || path.size() >= sizeof(address.sun_path))
+                {
+                    throw InfluxDBException{"Invalid unix socket path: " + path};
+                }
+
+                // Replaces a stale socket of a previous run, but never other files
+                if (struct stat status{}; ::stat(path.c_str(), &status) == 0 && S_ISSOCK(status.st_mode))
+                {
+                    ::unlink(path.c_str());
+                }
+
+                Socket socket{::socket(AF_UNIX, SOCK_STREAM, 0)};
+
+                if (socket.get() < 0)
+                {
+                    throw InfluxDBException{systemError("Unable to create socket")};
+                }
+
+                address.sun_family = AF_UNIX;
+                path.copy(address.sun_path, path.size());
+
+                if (::bind(socket.get(), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0)
+                {
+                    throw InfluxDBException{systemError("Unable to bind " + path)};
+                }
+                return socket;
+            }
+
+            void accept()
+            {
+                while (mRunning)
+                {
+                    if (!waitReadable(mSocket.get()))
+                    {
+                        continue;
+                    }
+
+                    Socket client{::accept(mSocket.get(), nullptr, nullptr)};
+
+                    if (client.get() < 0)
+                    {
+                        continue;
+                    }
+                    setReceiveBuffer(client.get(), mReceiveBufferBytes);
+
+                    mConnections.remove_if([](Connection& connection)
+                                           {
+                                               if (connection.done)
+                                               {
+                                                   connection.thread.join();
+                                                   return true;
+                                               }
+                                               return false; });
+
+                    auto& connection = mConnections.emplace_back();
+                    connection.thread = std::thread{[this, &connection, fd = client.release()]
+                                                    {
+                                                        read(Socket{fd});
+                                                        connection.done = true; }};
+                }
+            }
+
+            void read(Socket client)
+            {
+                std::string pending;
+                std::vector<char> chunk(streamChunkBytes);
+
+                while (mRunning)
+                {
+                    if (!waitReadable(client.get()))
+                    {
+                        continue;
+                    }
+
+                    const auto length = ::recv(client.get(), chunk.data(), chunk.size(), 0);
+
+                    if (length <= 0)
+                    {
+                        break;
+                    }
+                    pending.append(chunk.data(), static_cast<std::size_t>(length));
+
+                    if (const auto lastLineEnd = pending.rfind('\n'); lastLineEnd != std::string::npos)
+                    {
+                        mSink(std::string_view{pending}.substr(0, lastLineEnd + 1), 1);
+                        pending.erase(0, lastLineEnd + 1);
+                    }
+                }
+
+                if (!pending.empty())
+                {
+                    pending.push_back('\n');
+                    mSink(pending, 1);
+                }
+            }
+
+            std::string mScheme;
+            std::string mPath;
+            std::size_t mReceiveBufferBytes;
+            Sink mSink;
+            Socket mSocket;
+            std::thread mAcceptThread;
+            std::list<Connection> mConnections;
+            std::atomic<bool> mRunning;
+        };
+    }
+
+
+    std::unique_ptr<Listener> createListener(const std::string& url, std::size_t threads, std::size_t receiveBufferBytes, Listener::Sink sink)
+    {
+        const Address address = parseUrl(url);
+
+        if (address.scheme == "udp")
+        {
+            return std::make_unique<UdpListener>(address, std::max<std::size_t>(threads, 1), receiveBufferBytes, std::move(sink));
+        }
+        if (address.scheme == "tcp" || address.scheme == "unix")
+        {
+            return std::make_unique<StreamListener>(address, receiveBufferBytes, std::move(sink));
+        }
+        throw InfluxDBException{"Unsupported listen URI: " + url};
+    }
+}
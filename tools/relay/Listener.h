@@ -0,0 +1,57 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace influxdb::relay
+{
+    /// \brief Receives line protocol from a socket
+    class Listener
+    {
+    public:
+        /// Receives newline terminated lines and the number of datagrams or reads they came from
+        using Sink = std::function<void(std::string_view lines, std::size_t packets)>;
+
+        virtual ~Listener() = default;
+
+        /// Starts the receive threads
+        virtual void start() = 0;
+
+        /// Stops and joins the receive threads
+        virtual void stop() = 0;
+
+        /// Bound address, with the actual port if port 0 was requested
+        virtual std::string endpoint() const = 0;
+    };
+
+    /// Binds a listener to url (udp://host:port, tcp://host:port or unix:///path)
+    /// \param threads   number of receive threads, used for UDP
+    /// \param receiveBufferBytes   socket receive buffer size, 0 keeps the system default
+    /// \throw InfluxDBException   if the url is invalid or binding fails
+    std::unique_ptr<Listener> createListener(const std::string& url, std::size_t threads, std::size_t receiveBufferBytes, Listener::Sink sink);
+}
@@ -0,0 +1,188 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Relay.h"
+#include "InfluxDBFactory.h"
+#include <algorithm>
+#include <exception>
+
+namespace influxdb::relay
+{
+    namespace
+    {
+        constexpr std::size_t maxBackoffShift{10};
+
+        std::uint64_t countLines(std::string_view lines)
+        {
+            return static_cast<std::uint64_t>(std::count(lines.begin(), lines.end(), '\n'));
+        }
+    }
+
+    Relay::Relay(Configuration configuration)
+        : mConfiguration(std::move(configuration)),
+          mQueue(mConfiguration.batchBytes, std::max<std::size_t>(mConfiguration.maxPendingBatches, 1), mConfiguration.flushInterval),
+          mRunning(false),
+          mReceivedPackets(0),
+          mReceivedLines(0),
+          mReceivedBytes(0),
+          mForwardedBatches(0),
+          mForwardedLines(0),
+          mForwardedBytes(0),
+          mRetries(0),
+          mFailedBatches(0)
+    {
+        if (mConfiguration.listen.empty())
+        {
+            throw InfluxDBException{"No listen address configured"};
+        }
+
+        for (std::size_t i = 0; i < std::max<std::size_t>(mConfiguration.connections, 1); ++i)
+        {
+            mConnections.push_back(InfluxDBFactory::GetTransport(mConfiguration.target));
+        }
+
+        for (const auto& url : mConfiguration.listen)
+        {
+            mListeners.push_back(createListener(url, mConfiguration.receiveThreads, mConfiguration.receiveBufferBytes,
+                                                [this](std::string_view lines, std::size_t packets)
+                                                { receive(lines, packets); }));
+        }
+    }
+
+    Relay::~Relay()
+    {
+        stop();
+    }
+
+    void Relay::start()
+    {
+        if (mRunning)
+        {
+            return;
+        }
+        mRunning = true;
+
+        for (auto& connection : mConnections)
+        {
+            mForwarders.emplace_back([this, &transport = *connection]
+                                     { forward(transport); });
+        }
+
+        for (auto& listener : mListeners)
+        {
+            listener->start();
+        }
+    }
+
+    void Relay::stop()
+    {
+        if (!mRunning)
+        {
+            return;
+        }
+        mRunning = false;
+
+        for (auto& listener : mListeners)
+        {
+            listener->stop();
+        }
+
+        mQueue.close();
+
+        for (auto& forwarder : mForwarders)
+        {
+            forwarder.join();
+        }
+        mForwarders.clear();
+    }
+
+    Relay::Statistics Relay::statistics() const
+    {
+        return Statistics{mReceivedPackets.load(std::memory_order_relaxed),
+                          mReceivedLines.load(std::memory_order_relaxed),
+                          mReceivedBytes.load(std::memory_order_relaxed),
+                          mForwardedBatches.load(std::memory_order_relaxed),
+                          mForwardedLines.load(std::memory_order_relaxed),
+                          mForwardedBytes.load(std::memory_order_relaxed),
+                          mRetries.load(std::memory_order_relaxed),
+                          mFailedBatches.load(std::memory_order_relaxed),
+                          mQueue.dropped()};
+    }
+
+    std::vector<std::string> Relay::endpoints() const
+    {
+        std::vector<std::string> endpoints;
+        endpoints.reserve(mListeners.size());
+
+        for (const auto& listener : mListeners)
+        {
+            endpoints.push_back(listener->endpoint());
+        }
+        return endpoints;
+    }
+
+    void Relay::receive(std::string_view lines, std::size_t packets)
+    {
+        mReceivedPackets.fetch_add(packets, std::memory_order_relaxed);
+        mReceivedLines.fetch_add(countLines(lines), std::memory_order_relaxed);
+        mReceivedBytes.fetch_add(lines.size(), std::memory_order_relaxed);
+        mQueue.append(lines);
+    }
+
+    void Relay::forward(Transport& transport)
+    {
+        while (auto batch = mQueue.pop())
+        {
+            send(transport, std::move(*batch));
+        }
+    }
+
+    void Relay::send(Transport& transport, std::string&& batch)
+    {
+        const std::uint64_t lines = countLines(batch);
+        const std::uint64_t bytes = batch.size();
+
+        for (std::size_t attempt = 0;; ++attempt)
+        {
+            const bool lastAttempt = attempt == mConfiguration.retries;
+
+            try
+            {
+                transport.send(lastAttempt ? std::move(batch) : std::string{batch});
+                mForwardedBatches.fetch_add(1, std::memory_order_relaxed);
+                mForwardedLines.fetch_add(lines, std::memory_order_relaxed);
+                mForwardedBytes.fetch_add(bytes, std::memory_order_relaxed);
+                return;
+            }
+            catch (const std::exception&)
+            {
+                if (lastAttempt)
+                {
+                    mFailedBatches.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                mRetries.fetch_add(1, std::memory_order_relaxed);
+                std::this_thread::sleep_for(mConfiguration.retryDelay * (1 << std::min(attempt, maxBackoffShift)));
+            }
+        }
+    }
+}
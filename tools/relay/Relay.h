@@ -0,0 +1,133 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "BatchQueue.h"
+#include "Listener.h"
+#include "Transport.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace influxdb::relay
+{
+    /// \brief Receives line protocol on sockets and forwards it in batches
+    ///
+    /// Lines received on any listener are batched by size and age and sent
+    /// through a pool of transports, one per forward thread.
+    class Relay
+    {
+    public:
+        struct Configuration
+        {
+            /// Listen URLs: udp://host:port, tcp://host:port or unix:///path
+            std::vector<std::string> listen;
+
+            /// Forward URL as accepted by InfluxDBFactory, e.g. http://localhost:8086?db=test
+            std::string target;
+
+            /// Receive threads per UDP listener
+            std::size_t receiveThreads{1};
+
+            /// Socket receive buffer size, 0 keeps the system default
+            std::size_t receiveBufferBytes{8 * 1024 * 1024};
+
+            /// Concurrent connections to the target
+            std::size_t connections{2};
+
+            /// Batches are sent once they reach this size ...
+            std::size_t batchBytes{1024 * 1024};
+
+            /// ... or the oldest line is this old
+            std::chrono::milliseconds flushInterval{1000};
+
+            /// Batches waiting for a connection, the oldest is dropped beyond
+            std::size_t maxPendingBatches{64};
+
+            /// Retries of a failed send, the delay doubles with each retry
+            std::size_t retries{3};
+            std::chrono::milliseconds retryDelay{100};
+        };
+
+        struct Statistics
+        {
+            std::uint64_t receivedPackets;
+            std::uint64_t receivedLines;
+            std::uint64_t receivedBytes;
+            std::uint64_t forwardedBatches;
+            std::uint64_t forwardedLines;
+            std::uint64_t forwardedBytes;
+            std::uint64_t retries;
+            std::uint64_t failedBatches;
+            std::uint64_t droppedBatches;
+        };
+
+        /// Binds all listeners and creates the connections
+        /// \throw InfluxDBException   if a listener or the target is invalid
+        explicit Relay(Configuration configuration);
+
+        /// Stops the relay
+        ~Relay();
+
+        Relay(const Relay&) = delete;
+        Relay& operator=(const Relay&) = delete;
+
+        /// Starts receiving and forwarding
+        void start();
+
+        /// Stops receiving and forwards all pending lines, a stopped relay can't be restarted
+        void stop();
+
+        /// Returns a snapshot of the counters
+        Statistics statistics() const;
+
+        /// Bound listener addresses, in the order configured
+        std::vector<std::string> endpoints() const;
+
+    private:
+        void receive(std::string_view lines, std::size_t packets);
+        void forward(Transport& transport);
+        void send(Transport& transport, std::string&& batch);
+
+        const Configuration mConfiguration;
+        BatchQueue mQueue;
+        std::vector<std::unique_ptr<Listener>> mListeners;
+        std::vector<std::unique_ptr<Transport>> mConnections;
+        std::vector<std::thread> mForwarders;
+        bool mRunning;
+
+        std::atomic<std::uint64_t> mReceivedPackets;
+        std::atomic<std::uint64_t> mReceivedLines;
+        std::atomic<std::uint64_t> mReceivedBytes;
+        std::atomic<std::uint64_t> mForwardedBatches;
+        std::atomic<std::uint64_t> mForwardedLines;
+        std::atomic<std::uint64_t> mForwardedBytes;
+        std::atomic<std::uint64_t> mRetries;
+        std::atomic<std::uint64_t> mFailedBatches;
+    };
+}
@@ -0,0 +1,196 @@
+// MIT License
+//
+// Copyright (c) 2020-2023 offa
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "Relay.h"
+#include "InfluxDBException.h"
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace
+{
+    volatile std::sig_atomic_t stopRequested{0};
+
+    void requestStop(int)
+    {
+        stopRequested = 1;
+    }
+
+    void printUsage(const char* program)
+    {
+        std::fprintf(stderr,
+                     "Usage: %s --listen URL [--listen URL ...] --target URL [options]\n"
+                     "\n"
+                     "  --listen URL             udp://host:port, tcp://host:port or unix:///path\n"
+                     "  --target URL             forward URL, e.g. http://localhost:8086?db=test\n"
+                     "  --receive-threads N      receive threads per UDP listener (default 1)\n"
+                     "  --connections N          concurrent connections to the target (default 2)\n"
+                     "  --batch-bytes N          batch size in bytes (default 1048576)\n"
+                     "  --flush-interval MS      maximum age of a batch (default 1000)\n"
+                     "  --max-pending N          batches waiting to be sent before dropping (default 64)\n"
+                     "  --retries N              retries of a failed send (default 3)\n"
+                     "  --retry-delay MS         delay before the first retry (default 100)\n"
+                     "  --report-interval S      rate report interval, 0 disables (default 10)\n",
+                     program);
+    }
+
+    void report(const influxdb::relay::Relay::Statistics& previous, const influxdb::relay::Relay::Statistics& current, double seconds)
+    {
+        const auto rate = [seconds](std::uint64_t before, std::uint64_t after)
+        {
+            return static_cast<double>(after - before) / seconds;
+        };
+
+        std::printf("received %.0f lines/s (%.2f MB/s, %.0f packets/s), forwarded %.0f lines/s (%.2f MB/s, %.1f batches/s), "
+                    "retries %llu, failed %llu, dropped %llu\n",
+                    rate(previous.receivedLines, current.receivedLines),
+                    rate(previous.receivedBytes, current.receivedBytes) / 1e6,
+                    rate(previous.receivedPackets, current.receivedPackets),
+                    rate(previous.forwardedLines, current.forwardedLines),
+                    rate(previous.forwardedBytes, current.forwardedBytes) / 1e6,
+                    rate(previous.forwardedBatches, current.forwardedBatches),
+                    static_cast<unsigned long long>(current.retries),
+                    static_cast<unsigned long long>(current.failedBatches),
+                    static_cast<unsigned long long>(current.droppedBatches));
+        std::fflush(stdout);
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    influxdb::relay::Relay::Configuration configuration;
+    std::chrono::seconds reportInterval{10};
+
+    try
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const std::string option{argv[i]};
+
+            if (option == "--help" || option == "-h")
+            {
+                printUsage(argv[0]);
+                return EXIT_SUCCESS;
+            }
+            if (i + 1 >= argc)
+            {
+                throw influxdb::InfluxDBException{"Missing value for " + option};
+            }
+
+            const std::string value{argv[++i]};
+
+            if (option == "--listen")
+            {
+                configuration.listen.push_back(value);
+            }
+            else if (option == "--target")
+            {
+                configuration.target = value;
+            }
+            else if (option == "--receive-threads")
+            {
+                configuration.receiveThreads = std::stoul(value);
+            }
+            else if (option == "--connections")
+            {
+                configuration.connections = std::stoul(value);
+            }
+            else if (option == "--batch-bytes")
+            {
+                configuration.batchBytes = std::stoul(value);
+            }
+            else if (option == "--flush-interval")
+            {
+                configuration.flushInterval = std::chrono::milliseconds{std::stol(value)};
+            }
+            else if (option == "--max-pending")
+            {
+                configuration.maxPendingBatches = std::stoul(value);
+            }
+            else if (option == "--retries")
+            {
+                configuration.retries = std::stoul(value);
+            }
+            else if (option == "--retry-delay")
+            {
+                configuration.retryDelay = std::chrono::milliseconds{std::stol(value)};
+            }
+            else if (option == "--report-interval")
+            {
+                reportInterval = std::chrono::seconds{std::stol(value)};
+            }
+            else
+            {
+                throw influxdb::InfluxDBException{"Unknown option " + option};
+            }
+        }
+
+        if (configuration.listen.empty() || configuration.target.empty())
+        {
+            printUsage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        influxdb::relay::Relay relay{configuration};
+        std::signal(SIGINT, requestStop);
+        std::signal(SIGTERM, requestStop);
+        relay.start();
+
+        for (const auto& endpoint : relay.endpoints())
+        {
+            std::printf("listening on %s\n", endpoint.c_str());
+        }
+        std::fflush(stdout);
+
+        auto previous = relay.statistics();
+        auto lastReport = std::chrono::steady_clock::now();
+
+        while (stopRequested == 0)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            const auto now = std::chrono::steady_clock::now();
+
+            if (reportInterval.count() > 0 && now - lastReport >= reportInterval)
+            {
+                const auto current = relay.statistics();
+                report(previous, current, std::chrono::duration<double>(now - lastReport).count());
+                previous = current;
+                lastReport = now;
+            }
+        }
+
+        relay.stop();
+        const auto total = relay.statistics();
+        std::printf("stopped: forwarded %llu of %llu lines\n",
+                    static_cast<unsigned long long>(total.forwardedLines),
+                    static_cast<unsigned long long>(total.receivedLines));
+    }
+    catch (const std::exception& e)
+    {
+        std::fprintf(stderr, "influxdb-cxx-relay: %s\n", e.what());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}